@@ -0,0 +1,713 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+/// @file
+/// ALSA policy for MimoProcessor's interface_policy.
+
+#ifndef APF_ALSA_POLICY_H
+#define APF_ALSA_POLICY_H
+
+#include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <unistd.h>  // for usleep()
+#include <cstdint>  // for int16_t, int32_t
+#include <vector>
+#include <memory>  // for std::unique_ptr
+#include <atomic>
+#include <initializer_list>
+#include <stdexcept>  // for std::runtime_error
+#include <algorithm>  // for std::find, std::max
+
+#include "apf/parameter_map.h"
+#include "apf/stringtools.h"
+#include "apf/iterator.h"  // for has_begin_and_end
+#include "apf/misc.h"  // for NonCopyable
+#include "apf/posix_thread_policy.h"  // for ScopedThread
+
+#ifndef APF_MIMOPROCESSOR_INTERFACE_POLICY
+#define APF_MIMOPROCESSOR_INTERFACE_POLICY apf::alsa_policy
+#endif
+
+namespace apf
+{
+
+/** @c interface_policy using ALSA directly (without a sound server).
+ * The sound card is accessed in mmap mode and all channels are copied into
+ * (or out of) one contiguous buffer per direction (see input_buffer() and
+ * output_buffer()).  Input::fetch_buffer() and Output::fetch_buffer() only
+ * compute a pointer into this buffer.
+ *
+ * Parameters:
+ *   - @c "sample_rate" and @c "block_size" (ALSA period size)
+ *   - @c "device" (default: @c "hw:0"), can be overridden separately by
+ *     @c "capture_device" and @c "playback_device"
+ *   - @c "periods" (default: 2) number of periods in the playback buffer
+ *   - @c "priority" (default: -1) realtime priority of the audio thread, a
+ *     negative value means that no realtime scheduling is used
+ *   - @c "capture_channels" and @c "playback_channels" (default: 0) number of
+ *     channels which are opened in activate(), if there are more Input%s or
+ *     Output%s at that time, more channels are used.
+ *
+ * Capture/playback is only enabled if there are channels to be opened.
+ * Each Input/Output gets the lowest ID (i.e. channel number) which is not in
+ * use, IDs of destroyed ports are re-used.  Therefore, ports can also be
+ * added and removed while the policy is active, e.g. when a source is added to
+ * a renderer.  As long as the number of channels opened in activate() is
+ * sufficient, such ports are connected to their channel immediately.  Ports
+ * with a higher ID get silence and are discarded, respectively, until the
+ * next activate().  If the device has more channels, additional capture
+ * channels are ignored and additional playback channels get silence.
+ *
+ * On machines without a sound card, the "dummy" or "loopback" drivers can be
+ * used (e.g. <tt>modprobe snd-dummy</tt>, device @c "hw:Dummy", or
+ * <tt>modprobe snd-aloop</tt>, devices @c "hw:Loopback,0" and
+ * @c "hw:Loopback,1").
+ * @see MimoProcessor
+ * @ingroup apf_policies
+ **/
+class alsa_policy
+{
+  public:
+    using sample_type = float;
+    class Input;
+    class Output;
+
+    struct alsa_error : std::runtime_error
+    {
+      alsa_error(const std::string& what, int error)
+        : std::runtime_error("ALSA: " + what + ": " + snd_strerror(error))
+      {}
+    };
+
+    inline bool activate();
+    inline bool deactivate();
+
+    int block_size() const { return _block_size; }
+    int sample_rate() const { return _sample_rate; }
+
+    /// Number of IDs used by Input%s (including gaps of removed ones)
+    int in_channels() const { return _id_count(_input_ids); }
+    /// @see in_channels()
+    int out_channels() const { return _id_count(_output_ids); }
+
+    bool is_realtime() const { return _priority >= 0; }
+    int get_real_time_priority() const { return _priority; }
+
+    /// Captured audio data of all channels.  Channel @c n starts at
+    /// <tt>n * block_size()</tt>.  Only valid while processing.
+    const sample_type* input_buffer() const { return _in_buffer.data(); }
+
+    /// Audio data of all channels to be played back, same layout as
+    /// input_buffer().
+    sample_type* output_buffer() { return _out_buffer.data(); }
+
+    /// Number of over-/underruns since activate()
+    unsigned xruns() const { return _xruns; }
+
+  protected:
+    /// Constructor
+    explicit alsa_policy(const parameter_map& p = parameter_map())
+      : _sample_rate(p.get<int>("sample_rate"))
+      , _block_size(p.get<int>("block_size"))
+      , _periods(p.get("periods", 2))
+      , _priority(p.get("priority", -1))
+      , _capture_device(p.get("capture_device", p.get("device", "hw:0")))
+      , _playback_device(p.get("playback_device", p.get("device", "hw:0")))
+      , _capture_channels(p.get("capture_channels", 0))
+      , _playback_channels(p.get("playback_channels", 0))
+      , _active_inputs(0)
+      , _active_outputs(0)
+      , _silence(static_cast<size_t>(_block_size))
+      , _scratch(static_cast<size_t>(_block_size))
+      , _linked(false)
+      , _restart(false)
+      , _xruns(0)
+    {}
+
+    /// Protected destructor
+    ~alsa_policy()
+    {
+      this->deactivate();  // ignore return value
+    }
+
+  private:
+    /// One device (capture or playback)
+    struct Device : NonCopyable
+    {
+      Device() : pcm(nullptr), format(SND_PCM_FORMAT_UNKNOWN), channels(0) {}
+
+      ~Device() { if (pcm) snd_pcm_close(pcm); }
+
+      snd_pcm_t* pcm;
+      snd_pcm_format_t format;
+      unsigned channels;  ///< number of channels of the device
+    };
+
+    struct AudioFunction
+    {
+      explicit AudioFunction(alsa_policy& parent) : _parent(parent) {}
+
+      void operator()() { _parent._audio_cycle(); }
+
+      private:
+        alsa_policy& _parent;
+    };
+
+    using AudioThread = posix_thread_policy::ScopedThread<AudioFunction>;
+
+    virtual void process() = 0;
+
+    /// Get lowest unused input ID.
+    /// @warning This function is \b not re-entrant!
+    int get_next_input_id() { return _get_id(_input_ids); }
+
+    /// @see get_next_input_id()
+    int get_next_output_id() { return _get_id(_output_ids); }
+
+    /// Mark @p id as unused, it is re-used by the next Input.
+    void release_input_id(int id)
+    {
+      _input_ids[static_cast<size_t>(id)] = false;
+    }
+
+    /// @see release_input_id()
+    void release_output_id(int id)
+    {
+      _output_ids[static_cast<size_t>(id)] = false;
+    }
+
+    static int _get_id(std::vector<bool>& ids)
+    {
+      auto free = std::find(ids.begin(), ids.end(), false);
+      if (free == ids.end()) free = ids.insert(ids.end(), false);
+      *free = true;
+      return static_cast<int>(free - ids.begin());
+    }
+
+    /// Highest used ID + 1
+    static int _id_count(const std::vector<bool>& ids)
+    {
+      auto last = std::find(ids.rbegin(), ids.rend(), true);
+      return static_cast<int>(ids.rend() - last);
+    }
+
+    inline void _open(Device& device, const std::string& name
+        , snd_pcm_stream_t stream, int channels);
+    inline bool _start();
+    inline void _audio_cycle();
+    inline bool _wait(snd_pcm_t* pcm);
+    inline bool _transfer(Device& device, bool capture);
+    inline bool _recover(int error);
+
+    template<typename S>
+    void _read(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset
+        , snd_pcm_uframes_t frames, sample_type* dest);
+    template<typename S>
+    void _write(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset
+        , snd_pcm_uframes_t frames, const sample_type* src);
+
+    const sample_type* _input(int id) const
+    {
+      return id < _active_inputs
+        ? &_in_buffer[static_cast<size_t>(id * _block_size)] : _silence.data();
+    }
+
+    sample_type* _output(int id)
+    {
+      return id < _active_outputs
+        ? &_out_buffer[static_cast<size_t>(id * _block_size)] : _scratch.data();
+    }
+
+    const int _sample_rate;
+    const int _block_size;
+    const int _periods;
+    const int _priority;
+    const std::string _capture_device, _playback_device;
+
+    const int _capture_channels, _playback_channels;
+
+    /// One entry per ID, @b true if used by an Input/Output
+    std::vector<bool> _input_ids, _output_ids;
+    /// Number of opened channels, constant while active
+    int _active_inputs, _active_outputs;
+
+    std::vector<sample_type> _in_buffer, _out_buffer;
+    const std::vector<sample_type> _silence;
+    std::vector<sample_type> _scratch;  ///< for Output%s without channel
+
+    std::unique_ptr<Device> _capture, _playback;
+    bool _linked;
+    bool _restart;  ///< set after an xrun, the devices are restarted
+
+    std::atomic<unsigned> _xruns;
+
+    std::unique_ptr<AudioThread> _thread;
+};
+
+template<typename interface_policy, typename native_handle_type>
+struct thread_traits;  // definition in mimoprocessor.h
+
+template<>
+struct thread_traits<alsa_policy, pthread_t>
+{
+  static void set_priority(const alsa_policy& obj, pthread_t thread_id)
+  {
+    if (obj.is_realtime())
+    {
+      struct sched_param param;
+      param.sched_priority = obj.get_real_time_priority();
+      if (pthread_setschedparam(thread_id, SCHED_FIFO, &param))
+      {
+        throw std::runtime_error("Can't set scheduling priority for thread!");
+      }
+    }
+  }
+};
+
+/** Open and configure the devices and start the audio thread.
+ * @throw alsa_error if something goes wrong
+ **/
+bool alsa_policy::activate()
+{
+  if (_thread) return false;  // already active
+
+  _active_inputs = std::max(_capture_channels, this->in_channels());
+  _active_outputs = std::max(_playback_channels, this->out_channels());
+
+  _in_buffer.assign(static_cast<size_t>(_active_inputs * _block_size)
+      , sample_type());
+  _out_buffer.assign(static_cast<size_t>(_active_outputs * _block_size)
+      , sample_type());
+
+  if (_active_inputs > 0)
+  {
+    _capture.reset(new Device);
+    _open(*_capture, _capture_device, SND_PCM_STREAM_CAPTURE, _active_inputs);
+  }
+  if (_active_outputs > 0)
+  {
+    _playback.reset(new Device);
+    _open(*_playback, _playback_device, SND_PCM_STREAM_PLAYBACK
+        , _active_outputs);
+  }
+  if (!_capture && !_playback) return false;
+
+  // If possible, capture and playback are started/stopped synchronously
+  _linked = _capture && _playback
+    && snd_pcm_link(_capture->pcm, _playback->pcm) == 0;
+
+  _xruns = 0;
+  _restart = false;
+  if (!_start()) throw std::runtime_error("ALSA: Couldn't start devices!");
+
+  _thread.reset(new AudioThread(AudioFunction(*this), 0));
+  thread_traits<alsa_policy, pthread_t>::set_priority(*this
+      , _thread->native_handle());
+  return true;
+}
+
+/// Stop the audio thread and close the devices.
+bool alsa_policy::deactivate()
+{
+  if (!_thread) return false;
+
+  _thread.reset();  // waits for the end of the current cycle
+
+  if (_linked) snd_pcm_unlink(_capture->pcm);
+  if (_capture) snd_pcm_drop(_capture->pcm);
+  if (_playback) snd_pcm_drop(_playback->pcm);
+  _capture.reset();
+  _playback.reset();
+  return true;
+}
+
+void alsa_policy::_open(Device& device, const std::string& name
+    , snd_pcm_stream_t stream, int channels)
+{
+  auto err = snd_pcm_open(&device.pcm, name.c_str(), stream, 0);
+  if (err < 0) throw alsa_error("Couldn't open \"" + name + "\"", err);
+
+  snd_pcm_hw_params_t* hw;
+  err = snd_pcm_hw_params_malloc(&hw);
+  if (err < 0) throw alsa_error("Couldn't allocate hardware parameters", err);
+  // make sure hw is freed, even if an exception is thrown
+  auto hw_guard = std::unique_ptr<snd_pcm_hw_params_t
+    , void(*)(snd_pcm_hw_params_t*)>(hw, snd_pcm_hw_params_free);
+
+  err = snd_pcm_hw_params_any(device.pcm, hw);
+  if (err < 0) throw alsa_error("No configuration for \"" + name + "\"", err);
+
+  // non-interleaved data can be copied channel by channel
+  auto access = SND_PCM_ACCESS_MMAP_NONINTERLEAVED;
+  if (snd_pcm_hw_params_test_access(device.pcm, hw, access) < 0)
+  {
+    access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+  }
+  err = snd_pcm_hw_params_set_access(device.pcm, hw, access);
+  if (err < 0) throw alsa_error("mmap access not possible for \"" + name + "\""
+      , err);
+
+  device.format = SND_PCM_FORMAT_UNKNOWN;
+  for (auto format: { SND_PCM_FORMAT_FLOAT, SND_PCM_FORMAT_S32
+      , SND_PCM_FORMAT_S16 })
+  {
+    if (snd_pcm_hw_params_test_format(device.pcm, hw, format) == 0)
+    {
+      device.format = format;
+      break;
+    }
+  }
+  if (device.format == SND_PCM_FORMAT_UNKNOWN)
+  {
+    throw alsa_error("No supported sample format for \"" + name + "\"", -EINVAL);
+  }
+  err = snd_pcm_hw_params_set_format(device.pcm, hw, device.format);
+  if (err < 0) throw alsa_error("Couldn't set sample format", err);
+
+  device.channels = static_cast<unsigned>(channels);
+  err = snd_pcm_hw_params_set_channels_near(device.pcm, hw, &device.channels);
+  if (err < 0 || device.channels < static_cast<unsigned>(channels))
+  {
+    throw alsa_error("\"" + name + "\" doesn't have " + str::A2S(channels)
+        + " channels", err < 0 ? err : -EINVAL);
+  }
+
+  err = snd_pcm_hw_params_set_rate_resample(device.pcm, hw, 0);
+  if (err < 0) throw alsa_error("Couldn't disable resampling", err);
+  err = snd_pcm_hw_params_set_rate(device.pcm, hw
+      , static_cast<unsigned>(_sample_rate), 0);
+  if (err < 0) throw alsa_error("Sample rate " + str::A2S(_sample_rate)
+      + " not supported by \"" + name + "\"", err);
+
+  err = snd_pcm_hw_params_set_period_size(device.pcm, hw
+      , static_cast<snd_pcm_uframes_t>(_block_size), 0);
+  if (err < 0) throw alsa_error("Period size " + str::A2S(_block_size)
+      + " not supported by \"" + name + "\"", err);
+  err = snd_pcm_hw_params_set_periods(device.pcm, hw
+      , static_cast<unsigned>(_periods), 0);
+  if (err < 0) throw alsa_error(str::A2S(_periods)
+      + " periods not supported by \"" + name + "\"", err);
+
+  err = snd_pcm_hw_params(device.pcm, hw);
+  if (err < 0) throw alsa_error("Couldn't set hardware parameters", err);
+
+  snd_pcm_sw_params_t* sw;
+  err = snd_pcm_sw_params_malloc(&sw);
+  if (err < 0) throw alsa_error("Couldn't allocate software parameters", err);
+  auto sw_guard = std::unique_ptr<snd_pcm_sw_params_t
+    , void(*)(snd_pcm_sw_params_t*)>(sw, snd_pcm_sw_params_free);
+
+  err = snd_pcm_sw_params_current(device.pcm, sw);
+  if (err < 0) throw alsa_error("Couldn't get software parameters", err);
+  err = snd_pcm_sw_params_set_avail_min(device.pcm, sw
+      , static_cast<snd_pcm_uframes_t>(_block_size));
+  if (err < 0) throw alsa_error("Couldn't set minimum available frames", err);
+  // the devices are started explicitly in _start()
+  err = snd_pcm_sw_params_set_start_threshold(device.pcm, sw
+      , static_cast<snd_pcm_uframes_t>(2 * _periods * _block_size));
+  if (err < 0) throw alsa_error("Couldn't set start threshold", err);
+  err = snd_pcm_sw_params(device.pcm, sw);
+  if (err < 0) throw alsa_error("Couldn't set software parameters", err);
+}
+
+/// Prepare the devices, fill the playback buffer with silence and start.
+bool alsa_policy::_start()
+{
+  if (_capture && snd_pcm_prepare(_capture->pcm) < 0) return false;
+  if (_playback)
+  {
+    if (!_linked && snd_pcm_prepare(_playback->pcm) < 0) return false;
+
+    std::fill(_out_buffer.begin(), _out_buffer.end(), sample_type());
+    for (int i = 0; i < _periods; ++i)
+    {
+      if (!_transfer(*_playback, false)) return false;
+    }
+  }
+
+  if (_capture && snd_pcm_start(_capture->pcm) < 0) return false;
+  if (_playback && !_linked && snd_pcm_start(_playback->pcm) < 0) return false;
+  return true;
+}
+
+/// One block: capture, process, playback.  This is called repeatedly by the
+/// audio thread.
+void alsa_policy::_audio_cycle()
+{
+  if (_restart)
+  {
+    if (_capture) snd_pcm_drop(_capture->pcm);
+    if (_playback && !_linked) snd_pcm_drop(_playback->pcm);
+    _restart = false;
+    if (!_start())
+    {
+      _restart = true;
+      // don't hog the CPU if the device is gone
+      usleep(static_cast<useconds_t>(1000000.0 * _block_size / _sample_rate));
+      return;
+    }
+  }
+
+  // The capture device (if any) determines the timing, the playback device
+  // then has enough space because its buffer was filled before.
+  auto& master = _capture ? *_capture : *_playback;
+
+  if (!_wait(master.pcm)) return;
+
+  if (_capture && !_transfer(*_capture, true)) return;
+
+  this->process();
+
+  if (_playback) _transfer(*_playback, false);
+}
+
+/// Wait until a whole block is available.
+/// @return @b false on timeout or error
+bool alsa_policy::_wait(snd_pcm_t* pcm)
+{
+  for (;;)
+  {
+    auto avail = snd_pcm_avail_update(pcm);
+    if (avail < 0) return _recover(static_cast<int>(avail));
+    if (avail >= _block_size) return true;
+
+    // Timeout, to be able to stop the audio thread
+    auto err = snd_pcm_wait(pcm, 100);
+    if (err < 0) return _recover(err);
+    if (err == 0) return false;
+  }
+}
+
+/// Copy one block between the device's mmap area and the internal buffer.
+bool alsa_policy::_transfer(Device& device, bool capture)
+{
+  auto remaining = static_cast<snd_pcm_uframes_t>(_block_size);
+  size_t position = 0;  // within the block
+
+  while (remaining > 0)
+  {
+    if (!capture && !_wait(device.pcm)) return false;
+
+    const snd_pcm_channel_area_t* areas;
+    snd_pcm_uframes_t offset, frames = remaining;
+    auto err = snd_pcm_mmap_begin(device.pcm, &areas, &offset, &frames);
+    if (err < 0) return _recover(err);
+
+    for (unsigned ch = 0; ch < device.channels; ++ch)
+    {
+      auto& area = areas[ch];
+      if (capture)
+      {
+        if (ch >= static_cast<unsigned>(_active_inputs)) break;
+        auto dest = &_in_buffer[ch * static_cast<size_t>(_block_size)
+          + position];
+        switch (device.format)
+        {
+          case SND_PCM_FORMAT_FLOAT:
+            _read<float>(area, offset, frames, dest);
+            break;
+          case SND_PCM_FORMAT_S32:
+            _read<int32_t>(area, offset, frames, dest);
+            break;
+          default:
+            _read<int16_t>(area, offset, frames, dest);
+        }
+      }
+      else
+      {
+        // additional channels of the device get silence
+        auto src = ch < static_cast<unsigned>(_active_outputs)
+          ? &_out_buffer[ch * static_cast<size_t>(_block_size) + position]
+          : _silence.data();
+        switch (device.format)
+        {
+          case SND_PCM_FORMAT_FLOAT:
+            _write<float>(area, offset, frames, src);
+            break;
+          case SND_PCM_FORMAT_S32:
+            _write<int32_t>(area, offset, frames, src);
+            break;
+          default:
+            _write<int16_t>(area, offset, frames, src);
+        }
+      }
+    }
+
+    auto committed = snd_pcm_mmap_commit(device.pcm, offset, frames);
+    if (committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames)
+    {
+      return _recover(committed < 0 ? static_cast<int>(committed) : -EPIPE);
+    }
+    remaining -= frames;
+    position += frames;
+  }
+  return true;
+}
+
+/// Schedule a restart after an over-/underrun (or suspend).
+/// @return @b false (the current block is lost)
+bool alsa_policy::_recover(int error)
+{
+  (void)error;  // the devices are restarted in any case
+  ++_xruns;
+  _restart = true;
+  return false;
+}
+
+namespace internal
+{
+
+template<typename S> struct alsa_sample;
+
+template<>
+struct alsa_sample<float>
+{
+  static float to_float(float x) { return x; }
+  static float from_float(float x) { return x; }
+};
+
+template<>
+struct alsa_sample<int32_t>
+{
+  static float to_float(int32_t x)
+  {
+    return static_cast<float>(x) * (1.0f / 2147483648.0f);
+  }
+
+  static int32_t from_float(float x)
+  {
+    if (x >= 1.0f) return 2147483647;
+    if (x <= -1.0f) return -2147483647;
+    return static_cast<int32_t>(static_cast<double>(x) * 2147483647.0);
+  }
+};
+
+template<>
+struct alsa_sample<int16_t>
+{
+  static float to_float(int16_t x)
+  {
+    return static_cast<float>(x) * (1.0f / 32768.0f);
+  }
+
+  static int16_t from_float(float x)
+  {
+    if (x >= 1.0f) return 32767;
+    if (x <= -1.0f) return -32767;
+    return static_cast<int16_t>(x * 32767.0f);
+  }
+};
+
+}  // namespace internal
+
+template<typename S>
+void alsa_policy::_read(const snd_pcm_channel_area_t& area
+    , snd_pcm_uframes_t offset, snd_pcm_uframes_t frames, sample_type* dest)
+{
+  // first and step are given in bits
+  auto step = area.step / (8 * sizeof(S));
+  auto src = static_cast<const S*>(area.addr)
+    + area.first / (8 * sizeof(S)) + offset * step;
+  for (snd_pcm_uframes_t i = 0; i < frames; ++i)
+  {
+    dest[i] = internal::alsa_sample<S>::to_float(src[i * step]);
+  }
+}
+
+template<typename S>
+void alsa_policy::_write(const snd_pcm_channel_area_t& area
+    , snd_pcm_uframes_t offset, snd_pcm_uframes_t frames
+    , const sample_type* src)
+{
+  auto step = area.step / (8 * sizeof(S));
+  auto dest = static_cast<S*>(area.addr)
+    + area.first / (8 * sizeof(S)) + offset * step;
+  for (snd_pcm_uframes_t i = 0; i < frames; ++i)
+  {
+    dest[i * step] = internal::alsa_sample<S>::from_float(src[i]);
+  }
+}
+
+class alsa_policy::Input
+{
+  public:
+    using iterator = sample_type const*;
+
+    struct buffer_type : has_begin_and_end<iterator> { friend class Input; };
+
+    void fetch_buffer()
+    {
+      this->buffer._begin = _parent._input(_id);
+      this->buffer._end   = this->buffer._begin + _parent.block_size();
+    }
+
+    buffer_type buffer;
+
+  protected:
+    Input(alsa_policy& parent, const parameter_map&)
+      : _parent(parent)
+      , _id(_parent.get_next_input_id())
+    {}
+
+    ~Input() { _parent.release_input_id(_id); }
+
+  private:
+    alsa_policy& _parent;
+    const int _id;
+};
+
+class alsa_policy::Output
+{
+  public:
+    using iterator = sample_type*;
+
+    struct buffer_type : has_begin_and_end<iterator> { friend class Output; };
+
+    void fetch_buffer()
+    {
+      this->buffer._begin = _parent._output(_id);
+      this->buffer._end   = this->buffer._begin + _parent.block_size();
+    }
+
+    buffer_type buffer;
+
+  protected:
+    Output(alsa_policy& parent, const parameter_map&)
+      : _parent(parent)
+      , _id(_parent.get_next_output_id())
+    {}
+
+    ~Output() { _parent.release_output_id(_id); }
+
+  private:
+    alsa_policy& _parent;
+    const int _id;
+};
+
+}  // namespace apf
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -31,6 +31,7 @@
 #include <cmath>  // for std::pow(), std::tan(), std::sqrt(), ...
 #include <complex>
 #include <vector>
+#include <iterator>  // for std::distance(), std::iterator_traits
 #include <cassert>  // for assert()
 
 #include "apf/denormalprevention.h"
@@ -237,6 +238,141 @@ class Cascade
     Container _sections;
 };
 
+/** Bank of recursive filters for many channels.
+ * Each channel has a cascade of second order sections (Direct Form II, like
+ * BiQuad), but each section can have different coefficients per channel.
+ * Coefficients and states are stored "structure of arrays"-style, i.e.
+ * contiguously for all channels, which allows the compiler to vectorize the
+ * innermost loop over the channels.
+ * @tparam T internal type of states and coefficients
+ * @tparam DenormalPrevention method of denormal prevention (see apf::dp),
+ *   a stateless method should be used to allow vectorization.
+ * @see BiQuad, Cascade
+ **/
+template<typename T, template<typename> class DenormalPrevention = apf::dp::dc>
+class BiQuadBank : private DenormalPrevention<T>
+{
+  public:
+    using size_type = typename std::vector<T>::size_type;
+
+    /// Constructor. All coefficients and states are initialized with zero.
+    BiQuadBank(size_type channels, size_type sections)
+      : _channels(channels)
+      , _sections(sections)
+      , _b0(channels * sections)
+      , _b1(channels * sections)
+      , _b2(channels * sections)
+      , _a1(channels * sections)
+      , _a2(channels * sections)
+      , _z1(channels * sections)
+      , _z2(channels * sections)
+      , _samples(channels)
+    {}
+
+    /// Set the coefficients of all sections of one channel.
+    /// @param channel channel number
+    /// @param first Begin iterator of SosCoefficients
+    /// @param last End iterator
+    template<typename I>
+    void set(size_type channel, I first, I last)
+    {
+      assert(channel < _channels);
+      assert(_sections == size_type(std::distance(first, last)));
+
+      for (auto i = channel; first != last; ++first, i += _channels)
+      {
+        _b0[i] = first->b0; _b1[i] = first->b1; _b2[i] = first->b2;
+                            _a1[i] = first->a1; _a2[i] = first->a2;
+      }
+    }
+
+    /// Process an audio block of all channels in-place.
+    /// @tparam I Iterator type; @c *first must be a random access iterator
+    ///   to the samples of the first channel (e.g. a pointer), ...
+    /// @param first Iterator to first channel
+    /// @param last Iterator to (one past) last channel
+    /// @param block_size Number of samples per channel
+    template<typename I>
+    void execute(I first, I last, size_type block_size)
+    {
+      assert(_channels == size_type(std::distance(first, last)));
+
+      using sample_type
+        = typename std::iterator_traits<decltype(&**first)>::value_type;
+
+      for (size_type n = 0; n < block_size; ++n)
+      {
+        auto x = _samples.begin();
+        for (auto channel = first; channel != last; ++channel)
+        {
+          *x++ = static_cast<T>((*channel)[n]);
+        }
+
+        for (size_type s = 0; s < _sections; ++s)
+        {
+          auto offset = s * _channels;
+          for (size_type c = 0; c < _channels; ++c)
+          {
+            auto i = offset + c;
+            T w = _samples[c] - _a1[i] * _z1[i] - _a2[i] * _z2[i];
+            this->prevent_denormals(w);
+            _samples[c] = _b0[i] * w + _b1[i] * _z1[i] + _b2[i] * _z2[i];
+            _z2[i] = _z1[i];
+            _z1[i] = w;
+          }
+        }
+
+        x = _samples.begin();
+        for (auto channel = first; channel != last; ++channel)
+        {
+          (*channel)[n] = static_cast<sample_type>(*x++);
+        }
+      }
+    }
+
+    size_type number_of_channels() const { return _channels; }
+    size_type number_of_sections() const { return _sections; }
+
+  private:
+    const size_type _channels, _sections;
+    std::vector<T> _b0, _b1, _b2, _a1, _a2;
+    std::vector<T> _z1, _z2;  ///< states
+    std::vector<T> _samples;  ///< current sample of each channel
+};
+
+/** Second order Butterworth lowpass (bilinear transform).
+ * Two of those in series form a fourth order Linkwitz-Riley lowpass.
+ * @param cutoff cutoff frequency (-3 dB) in Hertz
+ * @param sample_rate sampling rate in Hertz
+ * @see butterworth_highpass()
+ **/
+template<typename T>
+SosCoefficients<T> butterworth_lowpass(T cutoff, T sample_rate)
+{
+  T k = std::tan(apf::math::pi<T>() * cutoff / sample_rate);
+  T sqrt2 = std::sqrt(T(2));
+  T norm = T(1) / (T(1) + sqrt2 * k + k * k);
+  T b0 = k * k * norm;
+  return {b0, T(2) * b0, b0
+            , T(2) * (k * k - T(1)) * norm, (T(1) - sqrt2 * k + k * k) * norm};
+}
+
+/** Second order Butterworth highpass (bilinear transform).
+ * Two of those in series form a fourth order Linkwitz-Riley highpass.
+ * @param cutoff cutoff frequency (-3 dB) in Hertz
+ * @param sample_rate sampling rate in Hertz
+ * @see butterworth_lowpass()
+ **/
+template<typename T>
+SosCoefficients<T> butterworth_highpass(T cutoff, T sample_rate)
+{
+  T k = std::tan(apf::math::pi<T>() * cutoff / sample_rate);
+  T sqrt2 = std::sqrt(T(2));
+  T norm = T(1) / (T(1) + sqrt2 * k + k * k);
+  return {norm, T(-2) * norm, norm
+              , T(2) * (k * k - T(1)) * norm, (T(1) - sqrt2 * k + k * k) * norm};
+}
+
 namespace internal
 {
 
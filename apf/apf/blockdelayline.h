@@ -27,7 +27,7 @@
 #ifndef APF_BLOCKDELAYLINE_H
 #define APF_BLOCKDELAYLINE_H
 
-#include <algorithm>  // for std::max()
+#include <algorithm>  // for std::max(), std::fill()
 #include <vector>  // default container
 
 #include "apf/iterator.h"  // for circular_iterator, stride_iterator
@@ -76,6 +76,9 @@ class BlockDelayLine
 
     circulator get_read_circulator(size_type delay = 0) const;
 
+    /// Set all stored samples to zero.
+    void clear() { std::fill(_data.begin(), _data.end(), T()); }
+
   protected:
     /// Get a circular iterator to the sample with time 0
     circulator _get_data_circulator() const { return _data_circulator; }
@@ -231,11 +234,14 @@ class NonCausalBlockDelayLine : private BlockDelayLine<T, Container>
     template<typename Iterator> void write_block(Iterator source);
     /// @see BlockDelayLine::get_write_pointer()
     pointer get_write_pointer() const;
+    /// @see BlockDelayLine::clear()
+    void clear();
 #else
     // This is the real thing:
     using _base::advance;
     using _base::write_block;
     using _base::get_write_pointer;
+    using _base::clear;
 #endif
 
     /// @see BlockDelayLine::delay_is_valid()
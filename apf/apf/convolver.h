@@ -28,6 +28,8 @@
 #define APF_CONVOLVER_H
 
 #include <algorithm>  // for std::transform()
+#include <functional>  // for std::bind()
+#include <limits>  // for std::numeric_limits
 #include <cassert>
 
 #ifdef __SSE__
@@ -312,6 +314,12 @@ struct Input : TransformBase
 
   size_t partitions() const { return spectra.size() - 1; }
 
+  /// Forget the previous input signal (as if only zeros had been added).
+  void clear()
+  {
+    for (auto& partition: spectra) partition.zero = true;
+  }
+
   /// Spectra of the partitions (double-blocks) of the input signal to be
   /// convolved. The first element is the most recent signal chunk.
   fixed_list<fft_node> spectra;
@@ -558,15 +566,16 @@ OutputBase::_multiply_spectra()
   {
     assert(filter != nullptr);
 
-    if (input->zero || filter->zero) continue;
-
+    if (!input->zero && !filter->zero)
+    {
 #ifdef __SSE__
-    _multiply_partition_simd(input->data(), filter->data());
+      _multiply_partition_simd(input->data(), filter->data());
 #else
-    _multiply_partition_cpp(input->data(), filter->data());
+      _multiply_partition_cpp(input->data(), filter->data());
 #endif
 
-    _output_buffer.zero = false;
+      _output_buffer.zero = false;
+    }
     ++input;
   }
 }
@@ -624,7 +633,9 @@ class Output : public OutputBase
               , apf::make_index_iterator(input.partitions()))
     {}
 
-    void set_filter(const Filter& filter);
+    void set_filter(const Filter& filter
+        , size_t max_partitions = std::numeric_limits<size_t>::max());
+    void clear_filter();
 
     bool queues_empty() const;
     void rotate_queues();
@@ -638,25 +649,46 @@ class Output : public OutputBase
  * updated with rotate_queues().
  * @param filter Container with filter partitions. If too few partitions are
  *   given, the rest is set to zero, if too many are given, the rest is ignored.
+ * @param max_partitions Only the first @p max_partitions partitions of
+ *   @p filter are used, the rest is set to zero.  Empty partitions are skipped
+ *   in convolve(), this can be used to trade accuracy for speed.
  **/
 void
-Output::set_filter(const Filter& filter)
+Output::set_filter(const Filter& filter, size_t max_partitions)
 {
   auto partition = filter.begin();
+  auto last = filter.end();
+
+  if (max_partitions < filter.partitions())
+  {
+    last = partition + max_partitions;
+  }
 
   // First partition has no queue and is updated immediately
-  if (partition != filter.end())
+  if (partition != last)
   {
     _filter_ptrs.front() = &*partition++;
   }
+  else
+  {
+    _filter_ptrs.front() = &_empty_partition;
+  }
 
   for (size_t i = 0; i < _queues.size(); ++i)
   {
-    _queues[i][i]
-      = (partition == filter.end()) ? &_empty_partition : &*partition++;
+    _queues[i][i] = (partition == last) ? &_empty_partition : &*partition++;
   }
 }
 
+/// Set all filter partitions to zero immediately (like after construction).
+/// Pending partitions in the queues are dropped.
+void
+Output::clear_filter()
+{
+  std::fill(_filter_ptrs.begin(), _filter_ptrs.end(), &_empty_partition);
+  for (auto& queue: _queues) std::fill(queue.begin(), queue.end(), nullptr);
+}
+
 /** Check if there are still valid partitions in the queues.
  * If this function returns @b false, rotate_queues() should be called.
  * @note This is important for crossfades: even if set_filter() wasn't used,
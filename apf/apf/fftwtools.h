@@ -31,10 +31,21 @@
 
 #include <utility>  // for std::forward
 #include <limits>  // for std::numeric_limits
+#include <mutex>  // for std::mutex, std::lock_guard
 
 namespace apf
 {
 
+/// Mutex for serializing calls to the FFTW planner.
+/// Creating and destroying plans is not thread-safe in FFTW (only executing
+/// them is), this is relevant if filters are prepared in background threads.
+/// @see fftw::scoped_plan
+inline std::mutex& fftw_planner_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
 /// Traits class to select float/double/long double versions of FFTW functions
 /// @see fftw<float>, fftw<double>, fftw<long double>, APF_FFTW_TRAITS
 /// @note This is by far not complete, but it's trivial to extend.
@@ -61,13 +72,19 @@ struct fftw<longtype> { \
     public: \
       template<typename Func, typename... Args> \
       scoped_plan(Func func, Args... args) \
-        : _plan(func(std::forward<Args>(args)...)), _owning(true) {} \
+        : _plan(_create(func, std::forward<Args>(args)...)), _owning(true) {} \
       scoped_plan(scoped_plan&& other) \
         : _plan(std::move(other._plan)), _owning(true) { \
         other._owning = false; } \
-      ~scoped_plan() { if (_owning) destroy_plan(_plan); } \
+      ~scoped_plan() { if (_owning) { \
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex()); \
+        destroy_plan(_plan); } } \
       operator const plan&() { return _plan; } \
     private: \
+      template<typename Func, typename... Args> \
+      static plan _create(Func func, Args... args) { \
+        std::lock_guard<std::mutex> lock(fftw_planner_mutex()); \
+        return func(std::forward<Args>(args)...); } \
       plan _plan; bool _owning; }; \
 };
 
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+/// @file
+/// Conversion between interleaved and planar (one channel after the other)
+/// audio data.
+
+#ifndef APF_INTERLEAVE_H
+#define APF_INTERLEAVE_H
+
+#include <cstddef>  // for size_t
+
+#ifdef __SSE__
+#include <xmmintrin.h>  // for SSE instrinsics
+#endif
+
+namespace apf
+{
+
+/** Convert interleaved audio data to planar audio data.
+ * @param source interleaved data (@p frames x @p channels)
+ * @param channels number of channels
+ * @param frames number of frames
+ * @param target first sample of the first channel
+ * @param stride distance between the first samples of two channels in
+ *   @p target (e.g. the block size or the leading dimension of a column-major
+ *   matrix)
+ **/
+template<typename T>
+void deinterleave(const T* source, size_t channels, size_t frames
+    , T* target, size_t stride)
+{
+  for (size_t ch = 0; ch < channels; ++ch)
+  {
+    const T* in = source + ch;
+    T* out = target + ch * stride;
+    for (size_t n = 0; n < frames; ++n)
+    {
+      out[n] = in[n * channels];
+    }
+  }
+}
+
+/** Convert planar audio data to interleaved audio data.
+ * @param source first sample of the first channel
+ * @param stride distance between the first samples of two channels in
+ *   @p source
+ * @param channels number of channels
+ * @param frames number of frames
+ * @param target interleaved data (@p frames x @p channels)
+ **/
+template<typename T>
+void interleave(const T* source, size_t stride, size_t channels
+    , size_t frames, T* target)
+{
+  for (size_t ch = 0; ch < channels; ++ch)
+  {
+    const T* in = source + ch * stride;
+    T* out = target + ch;
+    for (size_t n = 0; n < frames; ++n)
+    {
+      out[n * channels] = in[n];
+    }
+  }
+}
+
+#ifdef __SSE__
+/// Specialization for @c float using SSE, 4x4 samples are transposed at once.
+template<>
+inline void deinterleave(const float* source, size_t channels, size_t frames
+    , float* target, size_t stride)
+{
+  size_t ch = 0;
+  for ( ; ch + 4 <= channels; ch += 4)
+  {
+    const float* in = source + ch;
+    float* out0 = target + ch * stride;
+    float* out1 = out0 + stride;
+    float* out2 = out1 + stride;
+    float* out3 = out2 + stride;
+
+    size_t n = 0;
+    for ( ; n + 4 <= frames; n += 4)
+    {
+      __m128 row0 = _mm_loadu_ps(in + (n    ) * channels);
+      __m128 row1 = _mm_loadu_ps(in + (n + 1) * channels);
+      __m128 row2 = _mm_loadu_ps(in + (n + 2) * channels);
+      __m128 row3 = _mm_loadu_ps(in + (n + 3) * channels);
+      _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+      _mm_storeu_ps(out0 + n, row0);
+      _mm_storeu_ps(out1 + n, row1);
+      _mm_storeu_ps(out2 + n, row2);
+      _mm_storeu_ps(out3 + n, row3);
+    }
+    for ( ; n < frames; ++n)
+    {
+      out0[n] = in[n * channels];
+      out1[n] = in[n * channels + 1];
+      out2[n] = in[n * channels + 2];
+      out3[n] = in[n * channels + 3];
+    }
+  }
+
+  // remaining channels
+  for ( ; ch < channels; ++ch)
+  {
+    const float* in = source + ch;
+    float* out = target + ch * stride;
+    for (size_t n = 0; n < frames; ++n)
+    {
+      out[n] = in[n * channels];
+    }
+  }
+}
+
+/// Specialization for @c float using SSE, 4x4 samples are transposed at once.
+template<>
+inline void interleave(const float* source, size_t stride, size_t channels
+    , size_t frames, float* target)
+{
+  size_t ch = 0;
+  for ( ; ch + 4 <= channels; ch += 4)
+  {
+    const float* in0 = source + ch * stride;
+    const float* in1 = in0 + stride;
+    const float* in2 = in1 + stride;
+    const float* in3 = in2 + stride;
+    float* out = target + ch;
+
+    size_t n = 0;
+    for ( ; n + 4 <= frames; n += 4)
+    {
+      __m128 row0 = _mm_loadu_ps(in0 + n);
+      __m128 row1 = _mm_loadu_ps(in1 + n);
+      __m128 row2 = _mm_loadu_ps(in2 + n);
+      __m128 row3 = _mm_loadu_ps(in3 + n);
+      _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+      _mm_storeu_ps(out + (n    ) * channels, row0);
+      _mm_storeu_ps(out + (n + 1) * channels, row1);
+      _mm_storeu_ps(out + (n + 2) * channels, row2);
+      _mm_storeu_ps(out + (n + 3) * channels, row3);
+    }
+    for ( ; n < frames; ++n)
+    {
+      out[n * channels    ] = in0[n];
+      out[n * channels + 1] = in1[n];
+      out[n * channels + 2] = in2[n];
+      out[n * channels + 3] = in3[n];
+    }
+  }
+
+  // remaining channels
+  for ( ; ch < channels; ++ch)
+  {
+    const float* in = source + ch * stride;
+    float* out = target + ch;
+    for (size_t n = 0; n < frames; ++n)
+    {
+      out[n * channels] = in[n];
+    }
+  }
+}
+#endif
+
+}  // namespace apf
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -32,11 +32,20 @@
 #endif
 
 #include <cassert>  // for assert()
+#include <vector>
+#include <memory>  // for std::unique_ptr
+#include <mutex>  // for std::lock_guard
+#include <algorithm>  // for std::copy()
+#include <atomic>
+#include <utility>  // for std::pair
 
 #include "apf/jackclient.h"
 #include "apf/parameter_map.h"
 #include "apf/stringtools.h"
 #include "apf/iterator.h"  // for has_begin_and_end
+#include "apf/commandqueue.h"
+#include "apf/rtlist.h"
+#include "apf/posix_thread_policy.h"  // for Semaphore, ScopedThread, Lock
 
 #ifndef APF_MIMOPROCESSOR_INTERFACE_POLICY
 #define APF_MIMOPROCESSOR_INTERFACE_POLICY apf::jack_policy
@@ -45,10 +54,31 @@
 namespace apf
 {
 
-/// @c interface_policy using JACK.
-/// Some of the functions are directly taken from JackClient.
-/// @see MimoProcessor
-/// @ingroup apf_policies
+/** @c interface_policy using JACK.
+ * Some of the functions are directly taken from JackClient.
+ *
+ * Optionally, several JACK periods can be processed at once (parameter
+ * @c "periods_per_block").  The audio data is then collected in internal
+ * buffers and a whole block is processed in a separate thread while the next
+ * block is collected.  This adds a latency of two blocks, but the overhead per
+ * block (e.g. FFTs, thread synchronization) is shared by more samples.
+ * If the processing of a block isn't finished in time, the next block is
+ * dropped (like an xrun).  The JACK transport state is stored with each
+ * block, see get_transport_state().
+ *
+ * The block size is fixed at construction time.  If the JACK buffer size is
+ * changed later, processing goes on with the old block size.  If the new JACK
+ * period is a multiple of the block size, several blocks are processed in
+ * the JACK thread without additional latency.  Otherwise, the audio data is
+ * re-blocked in the internal buffers, which adds a latency of one block (or
+ * two blocks if a processing thread is used, see above).
+ *
+ * get_transport_state() returns the JACK transport state which belongs to the
+ * block which is currently processed (not the state of the current JACK
+ * period).
+ * @see MimoProcessor
+ * @ingroup apf_policies
+ **/
 class jack_policy : public JackClient
 {
   public:
@@ -56,25 +86,117 @@ class jack_policy : public JackClient
     class Input;
     class Output;
 
-    using JackClient::activate;
-    using JackClient::deactivate;
     using JackClient::sample_rate;
 
-    nframes_t block_size() const { return this->buffer_size(); }
+    bool activate()
+    {
+      _fifo.reactivate();  // no return value
+      return JackClient::activate();
+    }
+
+    bool deactivate()
+    {
+      if (!JackClient::deactivate()) return false;
+
+      if (_thread)
+      {
+        // wait until the processing thread has finished its current block
+        _block_done.wait();
+        _block_done.post();
+      }
+
+      do
+      {
+        // Exceptionally, this is called from the non-realtime thread:
+        _fifo.process_commands();
+        _fifo.cleanup_commands();
+      }
+      while (_fifo.commands_available());
+      if (!_fifo.deactivate()) throw std::logic_error("Bug: FIFO not empty!");
+      return true;
+    }
+
+    nframes_t block_size() const { return _block_size; }
+
+    /// JACK transport state at the first frame of the block which is
+    /// currently processed.  If the JACK period consists of several blocks,
+    /// the position is advanced accordingly.
+    /// This can also be called from other threads (it then returns the state
+    /// of a recent block).
+    std::pair<bool, nframes_t> get_transport_state() const
+    {
+      return {_transport_rolling.load(std::memory_order_relaxed)
+        , _transport_frame.load(std::memory_order_relaxed)};
+    }
 
   protected:
     /// Constructor
-    /// @param p Parameters, only the parameter @c "name" (for the name of the
-    ///   JACK client) is supported.
-    explicit jack_policy(const parameter_map& p = parameter_map())
-      : JackClient(p.get("name", "MimoProcessor"), use_jack_process_callback)
-    {}
+    /// @param p Parameters: @c "name" (for the name of the JACK client) and
+    ///   @c "periods_per_block" (default: 1).
+    /// @throw std::logic_error if @c "periods_per_block" is less than 1
+    explicit jack_policy(const parameter_map& p = parameter_map());
 
-    virtual ~jack_policy() = default;
+    /// Destructor.  The derived class has to call deactivate() before.
+    virtual ~jack_policy()
+    {
+      if (_thread)
+      {
+        _stop_thread = true;
+        _block_ready.post();
+        _thread.reset();  // waits for the processing thread
+      }
+    }
 
   private:
     template<typename X> class Xput;
 
+    /// Internal buffer of a port, holding two blocks (see _slot)
+    struct Buffer
+    {
+      Buffer(JackClient::port_t* port_, bool is_input_, size_t block_size)
+        : port(port_)
+        , is_input(is_input_)
+        , data(2 * block_size)
+      {}
+
+      JackClient::port_t* const port;
+      const bool is_input;
+      std::vector<sample_type> data;
+    };
+
+    struct ProcessingFunction
+    {
+      explicit ProcessingFunction(jack_policy& parent) : _parent(parent) {}
+
+      void operator()()
+      {
+        _parent._block_ready.wait();
+        if (_parent._stop_thread)
+        {
+          // let the next call return as well, until the thread is stopped
+          _parent._block_ready.post();
+          return;
+        }
+        // the JACK thread has already switched to the other slot
+        _parent._set_transport_state(
+            _parent._block_transport[1 - _parent._slot]);
+        _parent.process();
+        _parent._block_done.post();
+      }
+
+      private:
+        jack_policy& _parent;
+    };
+
+    using ProcessingThread
+      = posix_thread_policy::ScopedThread<ProcessingFunction>;
+
+    /// Beginning of the block which is processed by the processing thread
+    sample_type* _processing_block(Buffer& buffer)
+    {
+      return buffer.data.data() + (1 - _slot) * _block_size;
+    }
+
     struct i_am_in
     {
       using iterator = const sample_type*;
@@ -91,19 +213,145 @@ class jack_policy : public JackClient
       static std::string default_prefix() { return "out_"; }
     };
 
+    /// Transport state @p frames frames after @p state
+    static std::pair<bool, nframes_t>
+    _advance(std::pair<bool, nframes_t> state, nframes_t frames)
+    {
+      if (state.first) state.second += frames;
+      return state;
+    }
+
+    void _set_transport_state(const std::pair<bool, nframes_t>& state)
+    {
+      _transport_rolling.store(state.first, std::memory_order_relaxed);
+      _transport_frame.store(state.second, std::memory_order_relaxed);
+    }
+
     virtual int jack_process_callback(nframes_t nframes)
     {
-      (void)nframes;
-      assert(nframes == this->block_size());
+      _fifo.process_commands();
+
+      // at the first frame of this JACK period
+      auto transport = JackClient::get_transport_state();
 
-      // call virtual member function which is implemented in derived class
-      // (template method design pattern)
-      this->process();
+      // If the JACK period is a multiple of the block size, JACK's buffers are
+      // used directly (a processing thread wouldn't help in this case)
+      if (nframes % _block_size == 0 && (!_thread || _block_done.try_wait()))
+      {
+        _direct = true;
+        _fill = 0;
+        _nframes = nframes;
+        for (_offset = 0; _offset < nframes; _offset += _block_size)
+        {
+          _set_transport_state(_advance(transport, _offset));
+          // call virtual member function which is implemented in derived
+          // class (template method design pattern)
+          this->process();
+        }
+        if (_thread) _block_done.post();
+        return 0;
+      }
+
+      if (_direct)
+      {
+        // don't play back old data after the JACK period was changed
+        for (auto buffer: _buffers)
+        {
+          if (!buffer->is_input)
+          {
+            std::fill(buffer->data.begin(), buffer->data.end(), sample_type());
+          }
+        }
+        _direct = false;
+      }
 
+      for (nframes_t done = 0; done < nframes; )
+      {
+        auto chunk = std::min(nframes - done, _block_size - _fill);
+
+        if (_fill == 0)
+        {
+          _block_transport[_slot] = _advance(transport, done);
+        }
+
+        auto in_offset = _slot * _block_size + _fill;
+        // Without processing thread, the block is processed right away and
+        // can be played back immediately
+        auto out_offset = (_thread ? _slot : 1 - _slot) * _block_size + _fill;
+
+        for (auto buffer: _buffers)
+        {
+          auto port_buffer = static_cast<sample_type*>(
+              jack_port_get_buffer(buffer->port, nframes)) + done;
+          if (buffer->is_input)
+          {
+            std::copy(port_buffer, port_buffer + chunk
+                , buffer->data.data() + in_offset);
+          }
+          else
+          {
+            auto internal = buffer->data.data() + out_offset;
+            std::copy(internal, internal + chunk, port_buffer);
+          }
+        }
+
+        done += chunk;
+        _fill += chunk;
+
+        if (_fill == _block_size)
+        {
+          _fill = 0;
+          if (!_thread)
+          {
+            _slot = 1 - _slot;
+            _set_transport_state(_block_transport[1 - _slot]);
+            this->process();
+          }
+          // If the previous block isn't finished yet, the current one is
+          // overwritten (the outputs are repeated)
+          else if (_block_done.try_wait())
+          {
+            _slot = 1 - _slot;
+            _block_ready.post();
+          }
+        }
+      }
+      return 0;
+    }
+
+    /// The block size stays the same, see jack_process_callback().
+    virtual int jack_buffer_size_callback(nframes_t bs)
+    {
+      (void)bs;
       return 0;
     }
 
     virtual void process() = 0;
+
+    const nframes_t _block_size;
+    nframes_t _fill;  ///< number of frames collected in the current block
+    /// The JACK thread uses the first or second block of each Buffer (0 or 1),
+    /// the processing thread uses the other one.
+    nframes_t _slot;
+    /// If @b true, process() uses JACK's buffers (starting at _offset)
+    bool _direct;
+    nframes_t _nframes, _offset;
+
+    /// Transport state at the beginning of each block in the internal buffers
+    std::pair<bool, nframes_t> _block_transport[2];
+    /// see get_transport_state()
+    std::atomic<bool> _transport_rolling;
+    std::atomic<nframes_t> _transport_frame;
+
+    CommandQueue _fifo;
+    RtList<Buffer*> _buffers;
+    /// Inputs and Outputs may be created and destroyed in different
+    /// non-realtime threads, but _fifo allows only one of them at a time.
+    posix_thread_policy::Lock _buffers_lock;
+
+    posix_thread_policy::Semaphore _block_ready, _block_done;
+    std::atomic<bool> _stop_thread;
+    std::unique_ptr<ProcessingThread> _thread;
 };
 
 template<typename interface_policy, typename native_handle_type>
@@ -141,6 +389,39 @@ struct thread_traits<jack_policy, pthread_t>
   }
 };
 
+inline jack_policy::jack_policy(const parameter_map& p)
+  : JackClient(p.get("name", "MimoProcessor"), use_jack_process_callback)
+  , _block_size(this->buffer_size() * p.get("periods_per_block", 1))
+  , _fill(0)
+  , _slot(0)
+  , _direct(false)
+  , _nframes(0)
+  , _offset(0)
+  , _block_transport()
+  , _transport_rolling(false)
+  , _transport_frame(0)
+  , _fifo(p.get("fifo_size", 1024))
+  , _buffers(_fifo)
+  , _block_ready(0)
+  , _block_done(1)
+  , _stop_thread(false)
+{
+  if (p.get("periods_per_block", 1) < 1)
+  {
+    throw std::logic_error("jack_policy: periods_per_block must be >= 1!");
+  }
+
+  // deactivate FIFO for non-realtime initializations
+  if (!_fifo.deactivate()) throw std::logic_error("Bug: FIFO not empty!");
+
+  if (p.get("periods_per_block", 1) > 1)
+  {
+    _thread.reset(new ProcessingThread(ProcessingFunction(*this), 0));
+    thread_traits<jack_policy, pthread_t>::set_priority(*this
+        , _thread->native_handle());
+  }
+}
+
 // Helper class to avoid code duplication in Input and Output
 template<typename X>
 class jack_policy::Xput
@@ -152,19 +433,46 @@ class jack_policy::Xput
 
     void fetch_buffer()
     {
-      this->buffer._begin = static_cast<sample_type*>(
-          jack_port_get_buffer(_port, _parent.block_size()));
+      if (_parent._direct)
+      {
+        this->buffer._begin = static_cast<sample_type*>(
+            jack_port_get_buffer(_port, _parent._nframes)) + _parent._offset;
+      }
+      else
+      {
+        this->buffer._begin = _parent._processing_block(*_buffer);
+      }
       this->buffer._end   = this->buffer._begin + _parent.block_size();
     }
 
     std::string port_name() const { return _port_name; }
 
+    /// Remove all connections of the port and optionally make a new one.
+    /// This way, an existing port can be re-used instead of registering a
+    /// new one.
+    /// @param connect_to name of the port to connect to (may be empty)
+    void reconnect(const std::string& connect_to)
+    {
+      if (_port) _parent.disconnect_port(_port);
+      _connect(connect_to);
+    }
+
     buffer_type buffer;
 
   protected:
      Xput(jack_policy& parent, const parameter_map& p);
 
-    ~Xput() { _parent.unregister_port(_port); }
+    ~Xput()
+    {
+      if (_buffer)
+      {
+        std::lock_guard<posix_thread_policy::Lock> guard(_parent._buffers_lock);
+        _parent._buffers.rem(_buffer);
+        // make sure the JACK thread doesn't use the port anymore
+        _parent._fifo.wait();
+      }
+      _parent.unregister_port(_port);
+    }
 
   private:
     Xput(const Xput&); Xput& operator=(const Xput&);  // deactivated
@@ -174,7 +482,11 @@ class jack_policy::Xput
 
     JackClient::port_t* _init_port(const parameter_map& p, jack_policy& parent);
 
+    void _connect(const std::string& connect_to);
+
     const std::string _port_name;  // actual JACK port name
+
+    Buffer* _buffer;  // used if JACK's buffers can't be used directly
 };
 
 template<typename X>
@@ -219,9 +531,23 @@ jack_policy::Xput<X>::Xput(jack_policy& parent, const parameter_map& p)
   , _port(_init_port(p, _parent))
   // get actual port name and save it to member variable
   , _port_name(_port ? jack_port_name(_port) : "")
+  , _buffer(nullptr)
 {
+  if (_port)
+  {
+    std::lock_guard<posix_thread_policy::Lock> guard(_parent._buffers_lock);
+    _buffer = _parent._buffers.add(
+        new Buffer(_port, X::is_input, _parent.block_size()));
+  }
+
   // optionally connect to jack_port
-  std::string connect_to = p.get("connect_to", "");
+  _connect(p.get("connect_to", ""));
+}
+
+template<typename X>
+void
+jack_policy::Xput<X>::_connect(const std::string& connect_to)
+{
   if (connect_to != "")
   {
     if (X::is_input)
@@ -211,6 +211,15 @@ class JackClient
       return !jack_disconnect(_client, source.c_str(), destination.c_str());
     }
 
+    /// Remove all connections of a JACK port.
+    /// @param port JACK port
+    /// @return @b true on success
+    /// @see jack_port_disconnect()
+    bool disconnect_port(port_t* port) const
+    {
+      return !jack_port_disconnect(_client, port);
+    }
+
     /// Make connections which are still pending from a previous
     /// call to connect_ports(). This is needed if connect_ports() has been
     /// called while the JackClient wasn't activated yet.
@@ -362,6 +371,9 @@ class JackClient
     }
 
     /// JACK buffer size callback.
+    /// This is only called if the buffer size actually changes, buffer_size()
+    /// already returns the new value.
+    /// @param bs new buffer size delivered by JACK
     /// @throw jack_error if not implemented
     /// @return 0 on success.
     virtual int jack_buffer_size_callback(nframes_t bs)
@@ -403,7 +415,11 @@ class JackClient
 
     static int _jack_buffer_size_callback(nframes_t bs, void* arg)
     {
-      return static_cast<JackClient*>(arg)->jack_buffer_size_callback(bs);
+      auto client = static_cast<JackClient*>(arg);
+      // this is also called on activation (with the same buffer size)
+      if (bs == client->_buffer_size) return 0;
+      client->_buffer_size = bs;
+      return client->jack_buffer_size_callback(bs);
     }
 
     static int _jack_xrun_callback(void* arg)
@@ -515,6 +531,12 @@ JackClient::JackClient(const std::string& name
         + _client_name + "'!");
   }
 
+  if (jack_set_buffer_size_callback(_client, _jack_buffer_size_callback, this))
+  {
+    throw jack_error("Could not set buffer size callback function for '"
+        + _client_name + "'!");
+  }
+
   // TODO: is the following still valid?
   // sometimes, jack_activate() returns successful although an error occured and
   // the thing "zombified". if the shutdown handler is called, _client is reset
@@ -0,0 +1,262 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+/// @file
+/// Level meter (peak, RMS and true-peak) for realtime use.
+
+#ifndef APF_LEVELMETER_H
+#define APF_LEVELMETER_H
+
+#include <cmath>  // for std::abs(), std::sqrt(), std::sin(), std::cos()
+#include <vector>
+#include <atomic>
+#include <iterator>  // for std::distance()
+#include <algorithm>  // for std::max(), std::fill()
+
+#include "apf/math.h"  // for math::pi()
+
+namespace apf
+{
+
+/// Signal levels of one audio channel (linear values).
+template<typename T>
+struct Levels
+{
+  Levels() : peak(), rms(), true_peak() {}
+
+  T peak;  ///< maximum absolute sample value
+  T rms;  ///< root mean square value
+  T true_peak;  ///< maximum absolute value of 4x oversampled signal (or 0)
+};
+
+/** Level meter for one audio channel.
+ * Peak and RMS value (and optionally the true-peak value) of an audio block
+ * are computed in one pass.  The sample loop is split into several
+ * independent accumulators, which allows the compiler to vectorize it.
+ *
+ * For the true-peak value, the signal is oversampled by a factor of 4 with a
+ * windowed-sinc interpolator (like in ITU-R BS.1770).
+ *
+ * The results of the most recent block are stored in two alternating slots.
+ * process() is meant to be called from the audio thread, get() can be called
+ * from any other thread at the same time, none of them blocks.
+ **/
+template<typename T>
+class LevelMeter
+{
+  public:
+    /// Constructor.
+    /// @param true_peak if @b true, the true-peak value is computed as well
+    explicit LevelMeter(bool true_peak = false)
+      : _true_peak(true_peak)
+      , _ring(true_peak ? 2 * _taps : 0)
+      , _position(0)
+      , _sequence(0)
+    {
+      for (auto& slot: _slots)
+      {
+        slot.peak.store(T(), std::memory_order_relaxed);
+        slot.rms.store(T(), std::memory_order_relaxed);
+        slot.true_peak.store(T(), std::memory_order_relaxed);
+      }
+
+      // initialize (static) coefficients outside of the audio thread
+      if (_true_peak) _coefficients();
+    }
+
+    /** Measure an audio block.
+     * @param first begin of audio block (random access iterator)
+     * @param last end of audio block
+     * @param gain all results are multiplied by this factor (e.g. to get the
+     *   level after a volume control without processing the signal twice)
+     **/
+    template<typename I>
+    void process(I first, I last, T gain = T(1))
+    {
+      auto size = static_cast<size_t>(std::distance(first, last));
+
+      T peak[_lanes] = {}, square_sum[_lanes] = {};
+
+      size_t n = 0;
+      for ( ; n + _lanes <= size; n += _lanes)
+      {
+        for (size_t lane = 0; lane < _lanes; ++lane)
+        {
+          T x = first[n + lane];
+          peak[lane] = std::max(peak[lane], std::abs(x));
+          square_sum[lane] += x * x;
+        }
+      }
+      for ( ; n < size; ++n)
+      {
+        T x = first[n];
+        peak[0] = std::max(peak[0], std::abs(x));
+        square_sum[0] += x * x;
+      }
+
+      for (size_t lane = 1; lane < _lanes; ++lane)
+      {
+        peak[0] = std::max(peak[0], peak[lane]);
+        square_sum[0] += square_sum[lane];
+      }
+
+      T rms = size ? std::sqrt(square_sum[0] / static_cast<T>(size)) : T();
+
+      T true_peak = T();
+      if (_true_peak)
+      {
+        true_peak = std::max(peak[0], _interpolated_peak(first, last));
+      }
+
+      gain = std::abs(gain);
+      _publish(peak[0] * gain, rms * gain, true_peak * gain);
+    }
+
+    /// Get levels of the most recent audio block.
+    Levels<T> get() const
+    {
+      auto result = Levels<T>();
+      unsigned before, after;
+      do
+      {
+        before = _sequence.load(std::memory_order_acquire);
+        const auto& slot = _slots[before % 2];
+        result.peak = slot.peak.load(std::memory_order_relaxed);
+        result.rms = slot.rms.load(std::memory_order_relaxed);
+        result.true_peak = slot.true_peak.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+      }
+      while (before != after);
+      return result;
+    }
+
+    /// Forget all previous audio blocks, like a newly constructed LevelMeter.
+    /// This must not be called concurrently with process().
+    void reset()
+    {
+      std::fill(_ring.begin(), _ring.end(), T());
+      _position = 0;
+      _publish(T(), T(), T());
+    }
+
+    /// @return @b true if the true-peak value is computed
+    bool true_peak() const { return _true_peak; }
+
+  private:
+    enum { _lanes = 8, _phases = 4, _taps = 12 };
+
+    struct Slot
+    {
+      std::atomic<T> peak, rms, true_peak;
+    };
+
+    void _publish(T peak, T rms, T true_peak)
+    {
+      unsigned next = _sequence.load(std::memory_order_relaxed) + 1;
+      auto& slot = _slots[next % 2];
+
+      // A reader which sees any of the following stores must also see that
+      // the previous block was published.
+      std::atomic_thread_fence(std::memory_order_release);
+
+      slot.peak.store(peak, std::memory_order_relaxed);
+      slot.rms.store(rms, std::memory_order_relaxed);
+      slot.true_peak.store(true_peak, std::memory_order_relaxed);
+
+      _sequence.store(next, std::memory_order_release);
+    }
+
+    /// Maximum absolute value of interpolated samples (without the original
+    /// samples).  The last few samples of the previous block are taken into
+    /// account, the result is delayed by half the filter length.
+    template<typename I>
+    T _interpolated_peak(I first, I last)
+    {
+      const auto& coefficients = _coefficients();
+
+      T result = T();
+      for ( ; first != last; ++first)
+      {
+        // every sample is stored twice, to have a contiguous window
+        _ring[_position] = _ring[_position + _taps] = *first;
+        if (++_position == _taps) _position = 0;
+
+        // oldest to newest sample
+        const T* window = &_ring[_position];
+
+        for (size_t phase = 0; phase < _phases - 1; ++phase)
+        {
+          const T* c = &coefficients[phase * _taps];
+          T sum = T();
+          for (size_t tap = 0; tap < _taps; ++tap)
+          {
+            sum += c[tap] * window[tap];
+          }
+          result = std::max(result, std::abs(sum));
+        }
+      }
+      return result;
+    }
+
+    /// Interpolation filters for the intermediate phases 1/4, 2/4 and 3/4
+    /// between the samples in the middle of the window (Hann-windowed sinc).
+    static const std::vector<T>& _coefficients()
+    {
+      static const std::vector<T> coefficients = []
+      {
+        auto result = std::vector<T>((_phases - 1) * _taps);
+        const double half = _taps / 2;
+        for (size_t phase = 1; phase < _phases; ++phase)
+        {
+          for (size_t tap = 0; tap < _taps; ++tap)
+          {
+            // distance between interpolation point and input sample
+            double d = half - 1.0 + static_cast<double>(phase) / _phases
+              - static_cast<double>(tap);
+            double x = math::pi<double>() * d;
+            double sinc = (d == 0.0) ? 1.0 : std::sin(x) / x;
+            double window = 0.5 * (1.0 + std::cos(x / half));
+            result[(phase - 1) * _taps + tap] = static_cast<T>(sinc * window);
+          }
+        }
+        return result;
+      }();
+      return coefficients;
+    }
+
+    const bool _true_peak;
+    std::vector<T> _ring;  ///< history for true-peak interpolation
+    size_t _position;
+
+    Slot _slots[2];
+    std::atomic<unsigned> _sequence;  ///< number of published blocks
+};
+
+}  // namespace apf
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -28,6 +28,7 @@
 #define APF_MIMOPROCESSOR_H
 
 #include <cassert>  // for assert()
+#include <memory>  // for std::unique_ptr
 #include <stdexcept>  // for std::logic_error
 
 #include "apf/rtlist.h"
@@ -266,11 +267,36 @@ class MimoProcessor : public interface_policy
     // TODO: find a way to get the outer type automatically
     template<typename P>
     typename P::outer* add(const P& p)
+    {
+      using X = typename P::outer;
+      return static_cast<X*>(_add_helper(this->create(p).release()));
+    }
+
+    /// Create an Input or Output without adding it to its list.
+    /// This doesn't use the CommandQueue, the (possibly time-consuming)
+    /// construction doesn't have to be locked against other non-realtime
+    /// threads.  Use make_add_command() to add the object afterwards.
+    template<typename P>
+    std::unique_ptr<typename P::outer> create(const P& p)
     {
       using X = typename P::outer;
       auto temp = p;
       temp.parent = &this->derived();
-      return static_cast<X*>(_add_helper(new X(temp)));
+      return std::unique_ptr<X>(new X(temp));
+    }
+
+    /// Command for adding an Input which was created with create().
+    /// @see RtList::make_add_command()
+    CommandQueue::Command* make_add_command(Input* in)
+    {
+      return _input_list.make_add_command(in);
+    }
+
+    /// Command for removing an Input without deleting it.
+    /// @see RtList::make_release_command()
+    CommandQueue::Command* make_release_command(Input* in)
+    {
+      return _input_list.make_release_command(in);
     }
 
     void rem(Input* in) { _input_list.rem(in); }
@@ -296,6 +322,11 @@ class MimoProcessor : public interface_policy
 
     struct Process { Process(Derived&) {} };
 
+    /// Called after all outputs have been processed (in the main thread).
+    /// To be overwritten in the derived class, e.g. for processing which
+    /// needs the signals of several outputs.
+    struct PostProcess { PostProcess(Derived&) {} };
+
     explicit MimoProcessor(const parameter_map& params = parameter_map());
 
     /// Protected non-virtual destructor
@@ -375,6 +406,7 @@ class MimoProcessor : public interface_policy
       _process_list(_input_list);
       typename Derived::Process(this->derived());
       _process_list(_output_list);
+      typename Derived::PostProcess(this->derived());
       _query_fifo.process_commands();
     }
 
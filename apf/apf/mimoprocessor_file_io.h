@@ -26,9 +26,11 @@
 
 #include <sndfile.hh>  // C++ interface to libsndfile
 #include <iostream>
+#include <vector>
+#include <algorithm>  // for std::fill()
 
 #include "stopwatch.h"
-#include "apf/container.h"  // for fixed_matrix
+#include "apf/interleave.h"
 
 namespace apf
 {
@@ -54,13 +56,13 @@ int mimoprocessor_file_io(Processor& processor
 
   if (in.samplerate() != static_cast<int>(processor.sample_rate()))
   {
-    std::cout << "Samplerate mismatch!" << std::cout;
+    std::cout << "Samplerate mismatch!" << std::endl;
     return 42;
   }
 
   if (in.channels() != processor.in_channels())
   {
-    std::cout << "Input channel mismatch!" << std::cout;
+    std::cout << "Input channel mismatch!" << std::endl;
     return 666;
   }
 
@@ -85,29 +87,37 @@ int mimoprocessor_file_io(Processor& processor
   std::cout << "samplerate: " << in.samplerate() << std::endl;
 
   int blocksize = processor.block_size();
+  auto block = static_cast<size_t>(blocksize);
+  auto in_channels = static_cast<size_t>(in.channels());
+  auto out_channels = static_cast<size_t>(processor.out_channels());
 
-  // these matrices are used for de-interleaving and interleaving
-  fixed_matrix<float> m_in(blocksize, in.channels());
-  fixed_matrix<float> m_in_transpose(in.channels(), blocksize);
-  fixed_matrix<float> m_out(blocksize, processor.out_channels());
-  fixed_matrix<float> m_out_transpose(processor.out_channels(), blocksize);
+  // interleaved data (as in the files) and planar data (for the processor)
+  std::vector<float> interleaved_in(block * in_channels);
+  std::vector<float> planar_in(block * in_channels);
+  std::vector<float> planar_out(block * out_channels);
+  std::vector<float> interleaved_out(block * out_channels);
 
   processor.activate();
 
   StopWatch watch("processing");
 
   size_t actual_frames = 0;
-  while ((actual_frames = in.readf(m_in.data(), blocksize)) != 0)
+  while ((actual_frames = in.readf(interleaved_in.data(), blocksize)) != 0)
   {
-    m_in_transpose.set_channels(m_in.slices);
+    // the last block is zero-padded
+    std::fill(interleaved_in.begin() + actual_frames * in_channels
+        , interleaved_in.end(), 0.0f);
+
+    deinterleave(interleaved_in.data(), in_channels, block
+        , planar_in.data(), block);
 
     processor.audio_callback(blocksize
-        , m_in_transpose.get_channel_ptrs()
-        , m_out_transpose.get_channel_ptrs());
+        , planar_in.data(), block, planar_out.data(), block);
 
-    m_out.set_channels(m_out_transpose.slices);
+    interleave(planar_out.data(), block, out_channels, actual_frames
+        , interleaved_out.data());
 
-    out.writef(m_out.data(), actual_frames);
+    out.writef(interleaved_out.data(), actual_frames);
   }
 
   //out.writeSync();  // write cache buffers to disk
@@ -28,6 +28,7 @@
 #define APF_POINTER_POLICY_H
 
 #include <cassert>  // for assert()
+#include <cstddef>  // for size_t
 #include "apf/parameter_map.h"
 #include "apf/iterator.h"  // for has_begin_and_end
 
@@ -56,6 +57,8 @@ class pointer_policy<T*>
     class Output;
 
     void audio_callback(int n, T* const* in, T* const* out);
+    void audio_callback(int n, const T* in, size_t in_stride
+        , T* out, size_t out_stride);
 
     // for now, do nothing:
     bool activate() const { return true; }
@@ -75,6 +78,10 @@ class pointer_policy<T*>
       , _next_output_id(0)
       , _in(0)
       , _out(0)
+      , _in_planar(0)
+      , _out_planar(0)
+      , _in_stride(0)
+      , _out_stride(0)
     {}
 
     virtual ~pointer_policy() = default;
@@ -96,6 +103,11 @@ class pointer_policy<T*>
     int _next_output_id;
     T* const* _in;
     T* const* _out;
+
+    // alternatively, planar data (if _in/_out are null)
+    const T* _in_planar;
+    T* _out_planar;
+    size_t _in_stride, _out_stride;
 };
 
 /** This has to be called for each audio block.
@@ -121,6 +133,39 @@ pointer_policy<T*>::audio_callback(int n, T* const* in, T* const* out)
   this->process();
 }
 
+/** Planar version of audio_callback().
+ * The channels are stored one after the other, e.g. in a column-major matrix
+ * (like in Matlab/Octave) or in a buffer owned by the caller.
+ * No pointer arrays are needed and nothing is copied.
+ * @param n block size
+ * @param in first sample of the first input channel
+ * @param in_stride distance between the first samples of two input channels
+ *   (at least @p n)
+ * @param out first sample of the first output channel
+ * @param out_stride distance between the first samples of two output channels
+ *   (at least @p n)
+ * @attention Like with the other version, there must be enough memory for all
+ *   inputs and outputs.
+ **/
+template<typename T>
+void
+pointer_policy<T*>::audio_callback(int n, const T* in, size_t in_stride
+    , T* out, size_t out_stride)
+{
+  assert(n == this->block_size());
+  assert(in_stride >= static_cast<size_t>(n));
+  assert(out_stride >= static_cast<size_t>(n));
+  (void)n;  // avoid "unused parameter" warning
+
+  _in = nullptr;
+  _out = nullptr;
+  _in_planar = in;
+  _out_planar = out;
+  _in_stride = in_stride;
+  _out_stride = out_stride;
+  this->process();
+}
+
 template<typename T>
 class pointer_policy<T*>::Input
 {
@@ -131,7 +176,8 @@ class pointer_policy<T*>::Input
 
     void fetch_buffer()
     {
-      this->buffer._begin = _parent._in[_id];
+      this->buffer._begin = _parent._in ? _parent._in[_id]
+        : _parent._in_planar + static_cast<size_t>(_id) * _parent._in_stride;
       this->buffer._end   = this->buffer._begin + _parent.block_size();
     }
 
@@ -162,7 +208,8 @@ class pointer_policy<T*>::Output
 
     void fetch_buffer()
     {
-      this->buffer._begin = _parent._out[_id];
+      this->buffer._begin = _parent._out ? _parent._out[_id]
+        : _parent._out_planar + static_cast<size_t>(_id) * _parent._out_stride;
       this->buffer._end   = this->buffer._begin + _parent.block_size();
     }
 
@@ -237,6 +237,8 @@ class posix_thread_policy::Semaphore : NonCopyable
 
     bool post() { return sem_post(_sem_ptr) == 0; }
     bool wait() { return sem_wait(_sem_ptr) == 0; }
+    /// Decrement the semaphore only if that's possible without blocking.
+    bool try_wait() { return sem_trywait(_sem_ptr) == 0; }
 
   private:
 #ifdef APF_PSEUDO_UNNAMED_SEMAPHORES
@@ -0,0 +1,221 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+/// @file
+/// Sample rate conversion with a polyphase windowed-sinc filter.
+
+#ifndef APF_RESAMPLER_H
+#define APF_RESAMPLER_H
+
+#include <cmath>  // for std::sin(), std::sqrt(), std::ceil()
+#include <vector>
+#include <iterator>  // for std::distance(), std::iterator_traits
+#include <algorithm>  // for std::min(), std::copy()
+#include <stdexcept>  // for std::invalid_argument
+
+#include "apf/math.h"  // for math::pi()
+
+namespace apf
+{
+
+/** Offline sample rate converter for arbitrary rational ratios.
+ * The ratio of target and source sample rate is reduced to @c L/M, the signal
+ * is (conceptually) upsampled by @c L, lowpass filtered and downsampled by
+ * @c M.  Only the output samples are actually computed, each one with one of
+ * the @c L phases of a Kaiser-windowed sinc filter.
+ *
+ * The cutoff frequency is @p bandwidth times the lower of both Nyquist
+ * frequencies.  The filter has @p zero_crossings zero crossings on each side
+ * (relative to the cutoff frequency).
+ *
+ * This is meant for non-realtime use, e.g. for adapting impulse responses to
+ * the current sample rate.  The whole input signal has to be available,
+ * samples before the beginning and after the end are taken to be zero.
+ * The amplitude of the signal is preserved, for impulse responses this means
+ * that the result has to be scaled by <tt>source_rate/target_rate</tt> to
+ * keep the frequency response the same.
+ **/
+class Resampler
+{
+  public:
+    /// Constructor.
+    /// @throw std::invalid_argument if one of the sample rates is zero
+    Resampler(size_t source_rate, size_t target_rate
+        , size_t zero_crossings = 32, double bandwidth = 0.95
+        , double beta = 8.6)
+      : _up(1)
+      , _down(1)
+      , _cutoff(1.0)
+      , _half_length(0)
+      , _beta(beta)
+      , _i0_beta(_bessel_i0(beta))
+    {
+      if (source_rate == 0 || target_rate == 0)
+      {
+        throw std::invalid_argument("Resampler: Sample rate must not be zero!");
+      }
+
+      size_t divisor = _gcd(source_rate, target_rate);
+      _up = target_rate / divisor;
+      _down = source_rate / divisor;
+
+      if (this->identity()) return;
+
+      _cutoff = bandwidth * std::min(1.0
+          , static_cast<double>(_up) / static_cast<double>(_down));
+      _half_length = static_cast<size_t>(std::ceil(
+            static_cast<double>(zero_crossings) / _cutoff));
+
+      // For weird ratios (e.g. 44101/48000) the table would get too large,
+      // in this case, the coefficients are computed on the fly.
+      if (_up * 2 * _half_length <= _max_table_size)
+      {
+        _table.resize(_up * 2 * _half_length);
+        for (size_t phase = 0; phase < _up; ++phase)
+        {
+          for (size_t tap = 0; tap < 2 * _half_length; ++tap)
+          {
+            _table[phase * 2 * _half_length + tap]
+              = _coefficient(phase, tap);
+          }
+        }
+      }
+    }
+
+    /// Upsampling factor (numerator of the reduced sample rate ratio).
+    size_t up() const { return _up; }
+    /// Downsampling factor (denominator of the reduced sample rate ratio).
+    size_t down() const { return _down; }
+
+    /// @return @b true if source and target sample rate are the same
+    bool identity() const { return _up == _down; }
+
+    /// Number of output samples for a given number of input samples.
+    size_t output_size(size_t input_size) const
+    {
+      return (input_size * _up + _down - 1) / _down;
+    }
+
+    /** Resample a signal.
+     * @param first begin of input signal (random access iterator)
+     * @param last end of input signal
+     * @param result begin of output, output_size() samples are written
+     * @return end of output
+     **/
+    template<typename In, typename Out>
+    Out process(In first, In last, Out result) const
+    {
+      using value_type = typename std::iterator_traits<In>::value_type;
+      using difference_type = typename std::iterator_traits<In>::difference_type;
+
+      size_t input_size = static_cast<size_t>(std::distance(first, last));
+
+      if (this->identity()) return std::copy(first, last, result);
+
+      size_t taps = 2 * _half_length;
+      size_t out_size = this->output_size(input_size);
+
+      for (size_t n = 0; n < out_size; ++n)
+      {
+        size_t base = n * _down / _up;
+        size_t phase = n * _down % _up;
+
+        // Input index of tap k is base + 1 + k - half_length
+        size_t first_tap = 0;
+        if (base + 1 < _half_length) first_tap = _half_length - base - 1;
+        size_t end_tap = std::min(taps, input_size + _half_length - base - 1);
+
+        double sum = 0.0;
+        for (size_t k = first_tap; k < end_tap; ++k)
+        {
+          double sample = static_cast<double>(first[static_cast<difference_type>(
+                base + 1 + k - _half_length)]);
+          sum += sample * (_table.empty() ? _coefficient(phase, k)
+              : _table[phase * taps + k]);
+        }
+        *result++ = static_cast<value_type>(sum);
+      }
+      return result;
+    }
+
+  private:
+    /// Filter coefficient @p tap of polyphase component @p phase
+    double _coefficient(size_t phase, size_t tap) const
+    {
+      // distance between output position and input sample (in input samples)
+      double d = static_cast<double>(phase) / static_cast<double>(_up)
+        + static_cast<double>(_half_length) - 1.0 - static_cast<double>(tap);
+      double x = d / static_cast<double>(_half_length);
+      if (x <= -1.0 || x >= 1.0) return 0.0;
+      double window = _bessel_i0(_beta * std::sqrt(1.0 - x * x)) / _i0_beta;
+      return _cutoff * _sinc(_cutoff * d) * window;
+    }
+
+    static double _sinc(double x)
+    {
+      if (x == 0.0) return 1.0;
+      double arg = math::pi<double>() * x;
+      return std::sin(arg) / arg;
+    }
+
+    /// Modified Bessel function of the first kind, order zero (power series)
+    static double _bessel_i0(double x)
+    {
+      double sum = 1.0, term = 1.0;
+      for (int k = 1; k < 100; ++k)
+      {
+        term *= math::square(x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-16) break;
+      }
+      return sum;
+    }
+
+    static size_t _gcd(size_t a, size_t b)
+    {
+      while (b != 0)
+      {
+        size_t temp = a % b;
+        a = b;
+        b = temp;
+      }
+      return a;
+    }
+
+    static const size_t _max_table_size = 1 << 18;
+
+    size_t _up, _down;
+    double _cutoff;
+    size_t _half_length;  ///< number of taps on each side
+    double _beta;  ///< shape parameter of the Kaiser window
+    double _i0_beta;
+    std::vector<double> _table;
+};
+
+}  // namespace apf
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
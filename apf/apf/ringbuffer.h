@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+/// @file
+/// Lock-free ring buffer for audio samples.
+
+#ifndef APF_RINGBUFFER_H
+#define APF_RINGBUFFER_H
+
+#include <atomic>
+#include <vector>
+#include <algorithm>  // for std::min(), std::copy(), std::fill()
+
+#include "apf/math.h"  // for next_power_of_2()
+#include "apf/misc.h"  // for NonCopyable
+
+namespace apf
+{
+
+/** Lock-free single-reader/single-writer ring buffer.
+ * One thread may call write() (and write_space()), another thread may call
+ * read() and skip() (and read_space()), neither of them blocks.
+ *
+ * The read and write positions are counted from the beginning (and wrap
+ * around at the maximum value of @c size_t).  They can be used to identify
+ * samples, see read_index(), write_index() and skip_to().
+ * @note This is similar to LockFreeFifo, but it's meant for samples instead of
+ *   pointers and it reads and writes whole blocks at once.
+ **/
+template<typename T>
+class RingBuffer : NonCopyable
+{
+  public:
+    /// Constructor.
+    /// @param size desired size, gets rounded up to the next power of 2.
+    explicit RingBuffer(size_t size)
+      : _write_index(0)
+      , _read_index(0)
+      , _data(math::next_power_of_2(size))
+      , _mask(_data.size() - 1)
+    {}
+
+    /// Number of samples which can be stored.
+    size_t size() const { return _data.size(); }
+
+    /// Number of samples which can be written (writer thread).
+    size_t write_space() const
+    {
+      return this->size() - (_write_index.load(std::memory_order_relaxed)
+          - _read_index.load(std::memory_order_acquire));
+    }
+
+    /// Number of samples which can be read (reader thread).
+    size_t read_space() const
+    {
+      return _write_index.load(std::memory_order_acquire)
+        - _read_index.load(std::memory_order_relaxed);
+    }
+
+    /// Total number of samples written so far.
+    size_t write_index() const
+    {
+      return _write_index.load(std::memory_order_acquire);
+    }
+
+    /// Total number of samples read (or skipped) so far.
+    size_t read_index() const
+    {
+      return _read_index.load(std::memory_order_acquire);
+    }
+
+    /** Write samples (writer thread).
+     * @param first begin of input samples (random access iterator)
+     * @param last end of input samples
+     * @return number of samples written, may be less than requested if the
+     *   buffer is (almost) full.
+     **/
+    template<typename I>
+    size_t write(I first, I last)
+    {
+      size_t count = std::min(static_cast<size_t>(last - first)
+          , this->write_space());
+      size_t index = _write_index.load(std::memory_order_relaxed);
+      for (size_t n = 0; n < count; )
+      {
+        size_t offset = (index + n) & _mask;
+        size_t chunk = std::min(count - n, this->size() - offset);
+        std::copy(first + n, first + n + chunk, _data.begin() + offset);
+        n += chunk;
+      }
+      _write_index.store(index + count, std::memory_order_release);
+      return count;
+    }
+
+    /// Write @p count zeros (writer thread).
+    /// @return number of samples written
+    size_t write_zeros(size_t count)
+    {
+      count = std::min(count, this->write_space());
+      size_t index = _write_index.load(std::memory_order_relaxed);
+      for (size_t n = 0; n < count; )
+      {
+        size_t offset = (index + n) & _mask;
+        size_t chunk = std::min(count - n, this->size() - offset);
+        std::fill(_data.begin() + offset, _data.begin() + offset + chunk, T());
+        n += chunk;
+      }
+      _write_index.store(index + count, std::memory_order_release);
+      return count;
+    }
+
+    /** Read samples (reader thread).
+     * @param result output iterator (random access)
+     * @param count number of requested samples
+     * @return number of samples read, may be less than @p count if the buffer
+     *   is (almost) empty.
+     **/
+    template<typename O>
+    size_t read(O result, size_t count)
+    {
+      count = std::min(count, this->read_space());
+      size_t index = _read_index.load(std::memory_order_relaxed);
+      for (size_t n = 0; n < count; )
+      {
+        size_t offset = (index + n) & _mask;
+        size_t chunk = std::min(count - n, this->size() - offset);
+        std::copy(_data.begin() + offset, _data.begin() + offset + chunk
+            , result + n);
+        n += chunk;
+      }
+      _read_index.store(index + count, std::memory_order_release);
+      return count;
+    }
+
+    /// Discard up to @p count samples (reader thread).
+    /// @return number of discarded samples
+    size_t skip(size_t count)
+    {
+      count = std::min(count, this->read_space());
+      _read_index.store(_read_index.load(std::memory_order_relaxed) + count
+          , std::memory_order_release);
+      return count;
+    }
+
+    /// Discard all samples before @p index (reader thread).
+    /// @pre @p index must not be before read_index() or after write_index().
+    void skip_to(size_t index)
+    {
+      _read_index.store(index, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<size_t> _write_index;  ///< only changed by writer
+    std::atomic<size_t> _read_index;  ///< only changed by reader
+    std::vector<T> _data;
+    const size_t _mask;  ///< bit mask used instead of modulo operation
+};
+
+}  // namespace apf
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -29,6 +29,7 @@
 
 #include <list>
 #include <algorithm>  // for std::find()
+#include <stdexcept>  // for std::logic_error
 
 #include "apf/commandqueue.h"
 
@@ -63,6 +64,7 @@ class RtList<T*> : NonCopyable
     class AddCommand;  // no implementation, use <T*>!
     class RemCommand;  // no implementation, use <T*>!
     class ClearCommand;  // no implementation, use <T*>!
+    class ReleaseCommand;  // no implementation, use <T*>!
 
     // Default constructor is not allowed!
 
@@ -102,6 +104,26 @@ class RtList<T*> : NonCopyable
       _fifo.push(new AddCommand(_the_actual_list, first, last));
     }
 
+    /// Create a command for adding an element, without pushing it.
+    /// This way, several lists can be modified with one command, i.e. in the
+    /// same audio cycle.
+    /// @param item Pointer to the list item
+    /// @note Ownership is passed to the list when the command is executed!
+    CommandQueue::Command* make_add_command(T* item)
+    {
+      return new AddCommand(_the_actual_list, item);
+    }
+
+    /// Create a command for removing an element without deleting it.
+    /// After the command was cleaned up (see CommandQueue::cleanup_commands())
+    /// the element isn't used by the realtime thread anymore and the caller
+    /// is responsible for it.
+    /// @param item Pointer to the list item
+    CommandQueue::Command* make_release_command(T* item)
+    {
+      return new ReleaseCommand(_the_actual_list, item);
+    }
+
     /// Remove an element from the list.
     void rem(T* to_rem)
     {
@@ -273,6 +295,42 @@ class RtList<T*>::ClearCommand : public CommandQueue::Command
     list_t& _dst_list;  ///< Destination list
 };
 
+/// Command to remove an element from a list without deleting it.
+template<typename T>
+class RtList<T*>::ReleaseCommand : public CommandQueue::Command
+{
+  public:
+    /// Constructor.
+    /// @param dst_list List from which the item will be removed
+    /// @param item Pointer to the item which will be removed
+    ReleaseCommand(list_t& dst_list, T* item)
+      : _dst_list(dst_list)
+      , _item(item)
+    {}
+
+    /// @throw std::logic_error if the item is not found
+    virtual void execute()
+    {
+      auto iter = std::find(_dst_list.begin(), _dst_list.end(), _item);
+      if (iter == _dst_list.end())
+      {
+        throw std::logic_error("ReleaseCommand: Item not found!");
+      }
+      // The list node is de-allocated in the non-realtime thread
+      _splice_list.splice(_splice_list.begin(), _dst_list, iter);
+    }
+
+    virtual void cleanup()
+    {
+      _splice_list.clear();  // the item itself is not deleted
+    }
+
+  private:
+    list_t _splice_list;  ///< Removed element
+    list_t& _dst_list;  ///< Destination list
+    T* const _item;  ///< Element to be removed
+};
+
 }  // namespace apf
 
 #endif
@@ -66,7 +66,9 @@ template<typename out_T>
 inline bool convert(std::istream& input, out_T& output)
 {
   auto result = out_T();
-  input >> result >> std::ws;
+  input >> result;
+  // std::ws may set failbit if the end of the input was already reached
+  if (!input.eof()) input >> std::ws;
   if (!input.fail() && input.eof())
   {
     output = result;
@@ -86,13 +88,15 @@ inline bool convert(std::istream& input, bool& output)
 {
   bool result;
   // first try: if input == "1" or "0":
-  input >> result >> std::ws;
+  input >> result;
+  if (!input.fail() && !input.eof()) input >> std::ws;
   if (input.fail())
   {
     input.clear();  // clear error flags
     input.seekg(0); // go back to the beginning of the stream
     // second try: if input == "true" or "false":
-    input >> std::boolalpha >> result >> std::ws;
+    input >> std::boolalpha >> result;
+    if (!input.fail() && !input.eof()) input >> std::ws;
   }
   if (!input.fail() && input.eof())
   {
@@ -74,6 +74,7 @@ New policies can be provided in user code!
 @example audiofile_simpleprocessor.cpp
 @example flext_simpleprocessor.cpp
 @example jack_simpleprocessor.cpp
+@example alsa_simpleprocessor.cpp
 @example mex_simpleprocessor.cpp
 @example jack_dynamic_inputs.cpp
 @example jack_dynamic_outputs.cpp
@@ -34,7 +34,6 @@
 
 #include <mex.h>
 #include <string>
-#include <vector>
 #include <memory>  // for std::unique_ptr
 
 #ifdef MEX_USE_DOUBLE
@@ -55,7 +54,6 @@ using sample_type = SimpleProcessor::sample_type;
 // global variables holding the state
 std::unique_ptr<SimpleProcessor> engine;
 mwSize in_channels, out_channels, threads=1, block_size=64, sample_rate=44100;
-std::vector<sample_type*> inputs, outputs;
 
 void engine_init(int nrhs, const mxArray* prhs[])
 {
@@ -114,8 +112,6 @@ void engine_init(int nrhs, const mxArray* prhs[])
   temp.set("sample_rate", sample_rate);
   engine.reset(new SimpleProcessor(temp));
 
-  inputs.resize(in_channels);
-  outputs.resize(out_channels);
 }
 
 void engine_process(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
@@ -164,19 +160,8 @@ void engine_process(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
   sample_type*  input = static_cast<sample_type*>(mxGetData(prhs[0]));
 #endif
 
-  for (int i = 0; i <= in_channels; ++i)
-  {
-    inputs[i] = input;
-    input += block_size;
-  }
-
-  for (int i = 0; i <= out_channels; ++i)
-  {
-    outputs[i] = output;
-    output += block_size;
-  }
-
-  engine->audio_callback(block_size, inputs.data(), outputs.data());
+  // Matlab matrices are column-major, the channels can be used directly
+  engine->audio_callback(block_size, input, block_size, output, block_size);
 }
 
 void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
@@ -0,0 +1,333 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for alsa_policy.
+// No sound card is needed, the used ALSA functions are replaced by fakes.
+// The fake devices never have data available, process() isn't called.
+
+#include <vector>
+#include <memory>  // for std::unique_ptr
+#include <unistd.h>  // for usleep()
+
+#include "apf/alsa_policy.h"
+
+#include "catch/catch.hpp"
+
+struct _snd_pcm
+{
+  bool started = false;
+  unsigned channels = 0;
+  std::vector<float> data;
+  std::vector<snd_pcm_channel_area_t> areas;
+};
+
+struct _snd_pcm_hw_params {};
+struct _snd_pcm_sw_params {};
+
+namespace fake_alsa
+{
+
+const snd_pcm_uframes_t period = 64;
+
+}  // namespace fake_alsa
+
+extern "C"
+{
+
+const char* snd_strerror(int) { return "fake error"; }
+
+int snd_pcm_open(snd_pcm_t** pcm, const char*, snd_pcm_stream_t, int)
+{
+  *pcm = new _snd_pcm;
+  return 0;
+}
+
+int snd_pcm_close(snd_pcm_t* pcm)
+{
+  delete pcm;
+  return 0;
+}
+
+int snd_pcm_hw_params_malloc(snd_pcm_hw_params_t** ptr)
+{
+  *ptr = new _snd_pcm_hw_params;
+  return 0;
+}
+
+void snd_pcm_hw_params_free(snd_pcm_hw_params_t* obj) { delete obj; }
+int snd_pcm_hw_params_any(snd_pcm_t*, snd_pcm_hw_params_t*) { return 0; }
+
+int snd_pcm_hw_params_test_access(snd_pcm_t*, snd_pcm_hw_params_t*
+    , snd_pcm_access_t access)
+{
+  return access == SND_PCM_ACCESS_MMAP_NONINTERLEAVED ? 0 : -1;
+}
+
+int snd_pcm_hw_params_set_access(snd_pcm_t*, snd_pcm_hw_params_t*
+    , snd_pcm_access_t)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params_test_format(snd_pcm_t*, snd_pcm_hw_params_t*
+    , snd_pcm_format_t format)
+{
+  return format == SND_PCM_FORMAT_FLOAT ? 0 : -1;
+}
+
+int snd_pcm_hw_params_set_format(snd_pcm_t*, snd_pcm_hw_params_t*
+    , snd_pcm_format_t)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params_set_channels_near(snd_pcm_t* pcm, snd_pcm_hw_params_t*
+    , unsigned* val)
+{
+  pcm->channels = *val;
+  return 0;
+}
+
+int snd_pcm_hw_params_set_rate_resample(snd_pcm_t*, snd_pcm_hw_params_t*
+    , unsigned)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params_set_rate(snd_pcm_t*, snd_pcm_hw_params_t*, unsigned, int)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params_set_period_size(snd_pcm_t*, snd_pcm_hw_params_t*
+    , snd_pcm_uframes_t, int)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params_set_periods(snd_pcm_t*, snd_pcm_hw_params_t*, unsigned
+    , int)
+{
+  return 0;
+}
+
+int snd_pcm_hw_params(snd_pcm_t* pcm, snd_pcm_hw_params_t*)
+{
+  // one period, non-interleaved
+  pcm->data.assign(pcm->channels * fake_alsa::period, 0.0f);
+  for (unsigned ch = 0; ch < pcm->channels; ++ch)
+  {
+    pcm->areas.push_back({&pcm->data[ch * fake_alsa::period], 0, 32});
+  }
+  return 0;
+}
+
+int snd_pcm_sw_params_malloc(snd_pcm_sw_params_t** ptr)
+{
+  *ptr = new _snd_pcm_sw_params;
+  return 0;
+}
+
+void snd_pcm_sw_params_free(snd_pcm_sw_params_t* obj) { delete obj; }
+int snd_pcm_sw_params_current(snd_pcm_t*, snd_pcm_sw_params_t*) { return 0; }
+
+int snd_pcm_sw_params_set_avail_min(snd_pcm_t*, snd_pcm_sw_params_t*
+    , snd_pcm_uframes_t)
+{
+  return 0;
+}
+
+int snd_pcm_sw_params_set_start_threshold(snd_pcm_t*, snd_pcm_sw_params_t*
+    , snd_pcm_uframes_t)
+{
+  return 0;
+}
+
+int snd_pcm_sw_params(snd_pcm_t*, snd_pcm_sw_params_t*) { return 0; }
+
+int snd_pcm_prepare(snd_pcm_t* pcm)
+{
+  pcm->started = false;
+  return 0;
+}
+
+int snd_pcm_start(snd_pcm_t* pcm)
+{
+  pcm->started = true;
+  return 0;
+}
+
+int snd_pcm_drop(snd_pcm_t* pcm)
+{
+  pcm->started = false;
+  return 0;
+}
+
+// capture and playback are started separately
+int snd_pcm_link(snd_pcm_t*, snd_pcm_t*) { return -1; }
+int snd_pcm_unlink(snd_pcm_t*) { return 0; }
+
+// The playback buffer can be filled before starting, afterwards, the devices
+// are stuck.
+snd_pcm_sframes_t snd_pcm_avail_update(snd_pcm_t* pcm)
+{
+  return pcm->started ? 0 : static_cast<snd_pcm_sframes_t>(fake_alsa::period);
+}
+
+int snd_pcm_wait(snd_pcm_t*, int)
+{
+  usleep(1000);
+  return 0;  // timeout
+}
+
+int snd_pcm_mmap_begin(snd_pcm_t* pcm, const snd_pcm_channel_area_t** areas
+    , snd_pcm_uframes_t* offset, snd_pcm_uframes_t* frames)
+{
+  *areas = pcm->areas.data();
+  *offset = 0;
+  if (*frames > fake_alsa::period) *frames = fake_alsa::period;
+  return 0;
+}
+
+snd_pcm_sframes_t snd_pcm_mmap_commit(snd_pcm_t*, snd_pcm_uframes_t
+    , snd_pcm_uframes_t frames)
+{
+  return static_cast<snd_pcm_sframes_t>(frames);
+}
+
+}  // extern "C"
+
+struct Ports : apf::alsa_policy
+{
+  explicit Ports(const apf::parameter_map& p) : apf::alsa_policy(p) {}
+
+  ~Ports() { this->deactivate(); }
+
+  struct In : Input
+  {
+    explicit In(Ports& parent) : Input(parent, apf::parameter_map()) {}
+  };
+
+  struct Out : Output
+  {
+    explicit Out(Ports& parent) : Output(parent, apf::parameter_map()) {}
+  };
+
+  void process() {}
+};
+
+/// @param first beginning of input_buffer() or output_buffer()
+/// @param channels number of channels opened in activate()
+/// @return channel number of @p port, -1 if it doesn't have a channel
+template<typename Port>
+int channel(Port& port, const float* first, int channels)
+{
+  port.fetch_buffer();
+  auto offset = port.buffer.begin() - first;
+  if (offset < 0 || offset >= channels * static_cast<int>(fake_alsa::period))
+  {
+    return -1;
+  }
+  return static_cast<int>(offset) / static_cast<int>(fake_alsa::period);
+}
+
+TEST_CASE("alsa_policy", "Test alsa_policy")
+{
+
+apf::parameter_map p;
+p.set("sample_rate", 44100);
+p.set("block_size", static_cast<int>(fake_alsa::period));
+
+using in_ptr = std::unique_ptr<Ports::In>;
+using out_ptr = std::unique_ptr<Ports::Out>;
+
+SECTION("re-use IDs", "")
+{
+  Ports ports(p);
+  auto in0 = in_ptr(new Ports::In(ports));
+  auto in1 = in_ptr(new Ports::In(ports));
+  auto in2 = in_ptr(new Ports::In(ports));
+  CHECK(ports.in_channels() == 3);
+
+  in1.reset();
+  // the gap is still counted
+  CHECK(ports.in_channels() == 3);
+  in2.reset();
+  CHECK(ports.in_channels() == 1);
+
+  auto out0 = out_ptr(new Ports::Out(ports));
+  CHECK(ports.out_channels() == 1);
+  CHECK(ports.in_channels() == 1);
+
+  REQUIRE(ports.activate());
+  auto in_new = in_ptr(new Ports::In(ports));
+  CHECK(channel(*in0, ports.input_buffer(), 1) == 0);
+  // ports without channels get silence
+  CHECK(channel(*in_new, ports.input_buffer(), 1) == -1);
+  CHECK(*in_new->buffer.begin() == 0.0f);
+  CHECK(channel(*out0, ports.output_buffer(), 1) == 0);
+}
+
+SECTION("add ports while active", "")
+{
+  p.set("capture_channels", 3);
+  p.set("playback_channels", 2);
+  Ports ports(p);
+  auto in0 = in_ptr(new Ports::In(ports));
+  auto in1 = in_ptr(new Ports::In(ports));
+  REQUIRE(ports.activate());
+
+  CHECK(channel(*in0, ports.input_buffer(), 3) == 0);
+  CHECK(channel(*in1, ports.input_buffer(), 3) == 1);
+
+  auto in2 = in_ptr(new Ports::In(ports));
+  CHECK(channel(*in2, ports.input_buffer(), 3) == 2);
+
+  in1.reset();
+  in1.reset(new Ports::In(ports));
+  CHECK(channel(*in1, ports.input_buffer(), 3) == 1);
+
+  // more than the pre-allocated channels
+  auto in3 = in_ptr(new Ports::In(ports));
+  CHECK(ports.in_channels() == 4);
+  CHECK(channel(*in3, ports.input_buffer(), 3) == -1);
+
+  // there were no Outputs in activate()
+  auto out0 = out_ptr(new Ports::Out(ports));
+  auto out1 = out_ptr(new Ports::Out(ports));
+  auto out2 = out_ptr(new Ports::Out(ports));
+  CHECK(channel(*out0, ports.output_buffer(), 2) == 0);
+  CHECK(channel(*out1, ports.output_buffer(), 2) == 1);
+  CHECK(channel(*out2, ports.output_buffer(), 2) == -1);
+
+  // all ports get a channel after re-activation
+  ports.deactivate();
+  REQUIRE(ports.activate());
+  CHECK(channel(*in3, ports.input_buffer(), 4) == 3);
+  CHECK(channel(*out2, ports.output_buffer(), 3) == 2);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
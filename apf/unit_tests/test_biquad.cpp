@@ -21,7 +21,7 @@
  *                                 http://AudioProcessingFramework.github.com *
  ******************************************************************************/
 
-// Tests for BiQuad and Cascade.
+// Tests for BiQuad, Cascade and BiQuadBank.
 
 // see also ../performance_tests/biquad_*.cpp
 
@@ -49,6 +49,86 @@ SECTION("basic", "only instantiations and very basic stuff")
   auto e = apf::Cascade<apf::BiQuad<float>>(25);
 }
 
+SECTION("Linkwitz-Riley", "crossover with two Butterworth filters each")
+{
+  auto lp = apf::butterworth_lowpass(100.0, 44100.0);
+  auto hp = apf::butterworth_highpass(100.0, 44100.0);
+
+  // DC gain
+  double lp_dc = (lp.b0 + lp.b1 + lp.b2) / (1.0 + lp.a1 + lp.a2);
+  double hp_dc = (hp.b0 + hp.b1 + hp.b2) / (1.0 + hp.a1 + hp.a2);
+  CHECK(lp_dc == Approx(1.0));
+  CHECK(hp_dc == Approx(0.0));
+
+  auto lowpass = apf::Cascade<apf::BiQuad<double, apf::dp::none>>(2);
+  auto highpass = apf::Cascade<apf::BiQuad<double, apf::dp::none>>(2);
+  apf::SosCoefficients<double> lp_coeffs[] = { lp, lp };
+  apf::SosCoefficients<double> hp_coeffs[] = { hp, hp };
+  lowpass.set(lp_coeffs, lp_coeffs + 2);
+  highpass.set(hp_coeffs, hp_coeffs + 2);
+
+  // the sum of both outputs is an allpass, i.e. the energy of the impulse
+  // response is one
+  double energy = 0.0;
+  for (int i = 0; i < 100000; ++i)
+  {
+    double in = (i == 0) ? 1.0 : 0.0;
+    double out = lowpass(in) + highpass(in);
+    energy += out * out;
+  }
+  CHECK(energy == Approx(1.0));
+}
+
+SECTION("BiQuadBank", "same results as Cascade")
+{
+  auto lp = apf::butterworth_lowpass(1000.0f, 44100.0f);
+  auto hp = apf::butterworth_highpass(1000.0f, 44100.0f);
+  apf::SosCoefficients<float> lp_coeffs[] = { lp, lp };
+  apf::SosCoefficients<float> hp_coeffs[] = { hp, lp };
+
+  auto bank = apf::BiQuadBank<float, apf::dp::none>(3, 2);
+  CHECK(bank.number_of_channels() == 3);
+  CHECK(bank.number_of_sections() == 2);
+  bank.set(0, lp_coeffs, lp_coeffs + 2);
+  bank.set(1, hp_coeffs, hp_coeffs + 2);
+  bank.set(2, lp_coeffs, lp_coeffs + 2);
+
+  using cascade_t = apf::Cascade<apf::BiQuad<float, apf::dp::none>>;
+  cascade_t cascades[] = { cascade_t(2), cascade_t(2), cascade_t(2) };
+  cascades[0].set(lp_coeffs, lp_coeffs + 2);
+  cascades[1].set(hp_coeffs, hp_coeffs + 2);
+  cascades[2].set(lp_coeffs, lp_coeffs + 2);
+
+  float data[3][20];
+  for (int c = 0; c < 3; ++c)
+  {
+    for (int n = 0; n < 20; ++n)
+    {
+      data[c][n] = static_cast<float>((n * (c + 3)) % 7) - 3.0f;
+    }
+  }
+  float expected[3][20];
+  for (int c = 0; c < 3; ++c)
+  {
+    cascades[c].execute(data[c], data[c] + 20, expected[c]);
+  }
+
+  float* channels[] = { data[0], data[1], data[2] };
+  // two blocks of 10 samples
+  bank.execute(channels, channels + 3, 10);
+  for (auto& channel: channels) channel += 10;
+  bank.execute(channels, channels + 3, 10);
+
+  for (int c = 0; c < 3; ++c)
+  {
+    for (int n = 0; n < 20; ++n)
+    {
+      INFO("c = " << c << ", n = " << n);
+      CHECK(data[c][n] == Approx(expected[c][n]));
+    }
+  }
+}
+
 } // TEST_CASE
 
 // Settings for Vim (http://www.vim.org/), please do not remove:
@@ -110,6 +110,25 @@ SECTION("non-causal delay line", "")
   CHECK_RANGE(target, src, 3);
 }
 
+SECTION("clear", "")
+{
+  apf::NonCausalBlockDelayLine<int> d(3, 5, 1);
+  d.write_block(src);
+  d.write_block(src+3);
+  d.clear();
+
+  int expected[3] = { 0 };
+  CHECK(d.read_block(target, 0));
+  CHECK_RANGE(target, expected, 3);
+  CHECK(d.read_block(target, 3));
+  CHECK_RANGE(target, expected, 3);
+
+  // writing works as before
+  d.write_block(src);
+  CHECK(d.read_block(target, -1));
+  CHECK_RANGE(target, src, 3);
+}
+
 } // TEST_CASE
 
 // Settings for Vim (http://www.vim.org/), please do not remove:
@@ -237,6 +237,74 @@ SECTION("combinations", "")
   CHECK_RANGE(result, zeros, 8);
 }
 
+SECTION("silent input partitions", "")
+{
+  float delay_data[24] = { 0.0f };
+  delay_data[17] = 1.0f;  // third partition
+  auto delay = c::Filter(8, delay_data, delay_data + 24);
+
+  auto long_input = c::Input(8, 3);
+  auto long_output = c::Output(long_input);
+  long_output.set_filter(delay);
+
+  float input[8] = { 0.0f };
+  input[1] = 1.0f;
+
+  long_input.add_block(input);
+  long_output.rotate_queues();
+  result = long_output.convolve();
+  CHECK_RANGE(result, zeros, 8);
+
+  input[1] = 0.0f;
+  long_input.add_block(input);
+  long_output.rotate_queues();
+  result = long_output.convolve();
+  CHECK_RANGE(result, zeros, 8);
+
+  // The newest input partition is silent, the older ones must still be used
+  long_input.add_block(input);
+  result = long_output.convolve();
+
+  float expected[8] = { 0.0f };
+  expected[2] = 1.0f;
+
+  CHECK_RANGE(result, expected, 8);
+}
+
+SECTION("limited number of partitions", "")
+{
+  float delay_data[24] = { 0.0f };
+  delay_data[9] = 1.0f;  // second partition
+  delay_data[17] = 1.0f;  // third partition, will be ignored
+  auto delay = c::Filter(8, delay_data, delay_data + 24);
+
+  auto long_input = c::Input(8, 3);
+  auto long_output = c::Output(long_input);
+  long_output.set_filter(delay, 2);
+
+  float input[8] = { 0.0f };
+  input[1] = 1.0f;
+
+  long_input.add_block(input);
+  long_output.rotate_queues();
+  result = long_output.convolve();
+  CHECK_RANGE(result, zeros, 8);
+
+  float expected[8] = { 0.0f };
+  expected[2] = 1.0f;
+
+  input[1] = 0.0f;
+  long_input.add_block(input);
+  long_output.rotate_queues();
+  result = long_output.convolve();
+  CHECK_RANGE(result, expected, 8);
+
+  long_input.add_block(input);
+  CHECK(long_output.queues_empty());
+  result = long_output.convolve();
+  CHECK_RANGE(result, zeros, 8);
+}
+
 // TODO: test copy_nested() and transform_nested()!
 
 } // TEST_CASE
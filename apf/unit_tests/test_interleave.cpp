@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for deinterleave() and interleave().
+
+#include <vector>
+
+#include "apf/interleave.h"
+
+#include "catch/catch.hpp"
+
+// all combinations of SIMD and scalar parts are tested with float and int
+template<typename T>
+void check_roundtrip(size_t channels, size_t frames, size_t stride)
+{
+  auto interleaved = std::vector<T>(channels * frames);
+  for (size_t i = 0; i < interleaved.size(); ++i)
+  {
+    interleaved[i] = static_cast<T>(i);
+  }
+
+  // additional samples between the channels are not touched
+  auto planar = std::vector<T>(channels * stride, T(-1));
+  apf::deinterleave(interleaved.data(), channels, frames
+      , planar.data(), stride);
+
+  bool ok = true;
+  for (size_t ch = 0; ch < channels; ++ch)
+  {
+    for (size_t n = 0; n < stride; ++n)
+    {
+      auto expected = n < frames ? static_cast<T>(n * channels + ch) : T(-1);
+      if (planar[ch * stride + n] != expected) ok = false;
+    }
+  }
+  CHECK(ok);
+
+  auto result = std::vector<T>(channels * frames);
+  apf::interleave(planar.data(), stride, channels, frames, result.data());
+  CHECK(result == interleaved);
+}
+
+TEST_CASE("interleave", "Test deinterleave() and interleave()")
+{
+
+SECTION("float", "")
+{
+  for (size_t channels = 1; channels <= 9; ++channels)
+  {
+    for (size_t frames = 0; frames <= 9; ++frames)
+    {
+      check_roundtrip<float>(channels, frames, frames);
+      check_roundtrip<float>(channels, frames, frames + 3);
+    }
+  }
+}
+
+SECTION("int", "")
+{
+  check_roundtrip<int>(3, 5, 5);
+  check_roundtrip<int>(5, 7, 8);
+}
+
+} // TEST_CASE interleave
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for jack_policy.
+// No JACK server is needed, the used JACK functions are replaced by fakes.
+
+#include <vector>
+#include <utility>  // for std::pair
+
+#include "apf/jack_policy.h"
+
+#include "catch/catch.hpp"
+
+namespace fake_jack
+{
+
+jack_nframes_t buffer_size = 64;
+jack_transport_state_t transport_state = JackTransportStopped;
+jack_nframes_t transport_frame = 0;
+
+JackProcessCallback process_callback = nullptr;
+void* process_arg = nullptr;
+
+/// Run one JACK period
+void cycle(jack_nframes_t nframes)
+{
+  process_callback(nframes, process_arg);
+  if (transport_state == JackTransportRolling) transport_frame += nframes;
+}
+
+}  // namespace fake_jack
+
+struct _jack_client {};
+
+extern "C"
+{
+
+jack_client_t* jack_client_open(const char*, jack_options_t
+    , jack_status_t*, ...)
+{
+  static _jack_client client;
+  return &client;
+}
+
+int jack_client_close(jack_client_t*) { return 0; }
+int jack_client_name_size(void) { return 64; }
+char* jack_get_client_name(jack_client_t*)
+{
+  static char name[] = "MimoProcessor";
+  return name;
+}
+int jack_activate(jack_client_t*) { return 0; }
+int jack_connect(jack_client_t*, const char*, const char*) { return 0; }
+int jack_deactivate(jack_client_t*) { return 0; }
+
+int jack_set_process_callback(jack_client_t*, JackProcessCallback callback
+    , void* arg)
+{
+  fake_jack::process_callback = callback;
+  fake_jack::process_arg = arg;
+  return 0;
+}
+
+int jack_set_xrun_callback(jack_client_t*, JackXRunCallback, void*)
+{
+  return 0;
+}
+int jack_set_buffer_size_callback(jack_client_t*, JackBufferSizeCallback
+    , void*)
+{
+  return 0;
+}
+void jack_on_info_shutdown(jack_client_t*, JackInfoShutdownCallback, void*) {}
+
+jack_nframes_t jack_get_sample_rate(jack_client_t*) { return 44100; }
+jack_nframes_t jack_get_buffer_size(jack_client_t*)
+{
+  return fake_jack::buffer_size;
+}
+int jack_is_realtime(jack_client_t*) { return 0; }
+int jack_client_real_time_priority(jack_client_t*) { return -1; }
+
+// there are no ports in these tests
+void* jack_port_get_buffer(jack_port_t*, jack_nframes_t) { return nullptr; }
+
+jack_transport_state_t jack_transport_query(const jack_client_t*
+    , jack_position_t* pos)
+{
+  pos->frame = fake_jack::transport_frame;
+  return fake_jack::transport_state;
+}
+
+}  // extern "C"
+
+struct TransportLogger : apf::jack_policy
+{
+  explicit TransportLogger(const apf::parameter_map& p) : apf::jack_policy(p)
+  {}
+
+  ~TransportLogger() { this->deactivate(); }
+
+  void process()
+  {
+    states.push_back(this->get_transport_state());
+  }
+
+  std::vector<std::pair<bool, jack_nframes_t>> states;
+};
+
+TEST_CASE("jack_policy", "Test jack_policy")
+{
+
+fake_jack::buffer_size = 64;
+fake_jack::transport_state = JackTransportRolling;
+fake_jack::transport_frame = 1000;
+
+SECTION("several blocks per JACK period", "")
+{
+  apf::parameter_map p;
+  TransportLogger processor(p);
+  processor.activate();
+  fake_jack::cycle(64);
+  // after a JACK buffer size change, each period has two blocks
+  fake_jack::cycle(128);
+  fake_jack::cycle(128);
+
+  REQUIRE(processor.states.size() == 5);
+  for (jack_nframes_t i = 0; i < 5; ++i)
+  {
+    CHECK(processor.states[i].first);
+    CHECK(processor.states[i].second == 1000 + 64 * i);
+  }
+}
+
+SECTION("stopped transport", "")
+{
+  fake_jack::transport_state = JackTransportStopped;
+  apf::parameter_map p;
+  TransportLogger processor(p);
+  processor.activate();
+  fake_jack::cycle(128);
+
+  REQUIRE(processor.states.size() == 2);
+  CHECK_FALSE(processor.states[1].first);
+  CHECK(processor.states[1].second == 1000);
+}
+
+SECTION("re-blocking", "")
+{
+  apf::parameter_map p;
+  TransportLogger processor(p);
+  processor.activate();
+  // the JACK period isn't a multiple of the block size anymore
+  for (int i = 0; i < 4; ++i) fake_jack::cycle(96);
+
+  // a block is processed when it's complete, its state is from its beginning
+  REQUIRE(processor.states.size() == 6);
+  for (jack_nframes_t i = 0; i < 6; ++i)
+  {
+    CHECK(processor.states[i].second == 1000 + 64 * i);
+  }
+}
+
+SECTION("processing thread", "")
+{
+  apf::parameter_map p;
+  p.set("periods_per_block", 2);
+  TransportLogger processor(p);
+  processor.activate();
+  for (int i = 0; i < 3; ++i)
+  {
+    fake_jack::cycle(64);
+    fake_jack::cycle(64);
+    // the block is processed later, the transport has already moved on.
+    // deactivate() waits until the processing thread has finished it.
+    processor.deactivate();
+    processor.activate();
+  }
+
+  REQUIRE(processor.states.size() == 3);
+  for (jack_nframes_t i = 0; i < 3; ++i)
+  {
+    CHECK(processor.states[i].first);
+    CHECK(processor.states[i].second == 1000 + 128 * i);
+  }
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
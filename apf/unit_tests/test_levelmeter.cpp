@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for LevelMeter.
+
+#include <vector>
+#include <cmath>
+
+#include "apf/levelmeter.h"
+#include "apf/math.h"
+
+#include "catch/catch.hpp"
+
+TEST_CASE("LevelMeter", "Test LevelMeter")
+{
+
+SECTION("initial", "")
+{
+  apf::LevelMeter<float> meter;
+  CHECK_FALSE(meter.true_peak());
+  auto levels = meter.get();
+  CHECK(levels.peak == 0.0f);
+  CHECK(levels.rms == 0.0f);
+  CHECK(levels.true_peak == 0.0f);
+}
+
+SECTION("peak and RMS", "")
+{
+  apf::LevelMeter<float> meter;
+
+  // size is not a multiple of the internal number of accumulators
+  float data[] = { 1.0f, -3.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f };
+  meter.process(data, data + 9);
+  auto levels = meter.get();
+  CHECK(levels.peak == 3.0f);
+  CHECK(levels.rms == Approx(std::sqrt(17.0f / 9.0f)));
+  CHECK(levels.true_peak == 0.0f);
+
+  meter.process(data, data + 9, -0.5f);
+  levels = meter.get();
+  CHECK(levels.peak == 1.5f);
+  CHECK(levels.rms == Approx(0.5f * std::sqrt(17.0f / 9.0f)));
+
+  meter.process(data, data);
+  levels = meter.get();
+  CHECK(levels.peak == 0.0f);
+  CHECK(levels.rms == 0.0f);
+}
+
+SECTION("true peak", "")
+{
+  apf::LevelMeter<double> meter(true);
+  CHECK(meter.true_peak());
+
+  // sine with a quarter of the sampling rate, all samples at +-sqrt(0.5)
+  auto signal = std::vector<double>(64);
+  for (size_t i = 0; i < signal.size(); ++i)
+  {
+    signal[i] = std::sin(apf::math::pi<double>()
+        * (0.5 * static_cast<double>(i) + 0.25));
+  }
+
+  // first block: settle the interpolator
+  meter.process(signal.begin(), signal.end());
+  meter.process(signal.begin(), signal.end());
+  auto levels = meter.get();
+  CHECK(levels.peak == Approx(std::sqrt(0.5)));
+  CHECK(levels.rms == Approx(std::sqrt(0.5)));
+  CHECK(levels.true_peak == Approx(1.0).epsilon(0.02));
+}
+
+SECTION("reset", "")
+{
+  auto signal = std::vector<float>(64);
+  for (size_t i = 0; i < signal.size(); ++i)
+  {
+    signal[i] = std::sin(0.3f * static_cast<float>(i));
+  }
+
+  apf::LevelMeter<float> recycled(true);
+  recycled.process(signal.begin(), signal.end(), 2.0f);
+  recycled.reset();
+  auto levels = recycled.get();
+  CHECK(levels.peak == 0.0f);
+  CHECK(levels.rms == 0.0f);
+  CHECK(levels.true_peak == 0.0f);
+
+  // the history of the true-peak interpolator is cleared as well
+  apf::LevelMeter<float> fresh(true);
+  recycled.process(signal.begin() + 10, signal.begin() + 20);
+  fresh.process(signal.begin() + 10, signal.begin() + 20);
+  CHECK(recycled.get().peak == fresh.get().peak);
+  CHECK(recycled.get().rms == fresh.get().rms);
+  CHECK(recycled.get().true_peak == fresh.get().true_peak);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
@@ -110,6 +110,17 @@ SECTION("int", "")
   assert(bp.exactly_one_assignment());
 }
 
+SECTION("reset by assignment", "")
+{
+  // This is used to re-use objects which contain BlockParameters
+  auto bp = apf::BlockParameter<int>(111);
+  bp = 222;
+  bp = apf::BlockParameter<int>(111);
+  CHECK(111 == bp.get());
+  CHECK(111 == bp.old());
+  CHECK_FALSE(bp.changed());
+}
+
 SECTION("conversion operator", "")
 {
   auto bp = apf::BlockParameter<int>(42);
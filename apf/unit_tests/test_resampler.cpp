@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for Resampler.
+
+#include <vector>
+#include <cmath>
+
+#include "apf/resampler.h"
+
+#include "catch/catch.hpp"
+
+TEST_CASE("resampler", "Test Resampler")
+{
+
+SECTION("ratio", "")
+{
+  apf::Resampler r(44100, 48000);
+  CHECK(r.up() == 160);
+  CHECK(r.down() == 147);
+  CHECK_FALSE(r.identity());
+  CHECK(r.output_size(0) == 0);
+  CHECK(r.output_size(147) == 160);
+  CHECK(r.output_size(148) == 162);
+
+  apf::Resampler r2(96000, 48000);
+  CHECK(r2.up() == 1);
+  CHECK(r2.down() == 2);
+  CHECK(r2.output_size(5) == 3);
+}
+
+SECTION("zero sample rate", "")
+{
+  CHECK_THROWS_AS(apf::Resampler(0, 44100), std::invalid_argument);
+}
+
+SECTION("identity", "")
+{
+  apf::Resampler r(48000, 48000);
+  CHECK(r.identity());
+
+  float in[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+  float out[4] = { 0.0f };
+  CHECK(r.process(in, in + 4, out) == out + 4);
+  for (int i = 0; i < 4; ++i)
+  {
+    INFO("i = " << i);
+    CHECK(out[i] == in[i]);
+  }
+}
+
+SECTION("upsampling by 2", "")
+{
+  // even output samples are at the positions of the input samples
+  apf::Resampler r(24000, 48000);
+  auto in = std::vector<float>(200);
+  for (size_t i = 0; i < in.size(); ++i)
+  {
+    in[i] = std::sin(0.1f * static_cast<float>(i));
+  }
+  auto out = std::vector<float>(r.output_size(in.size()));
+  CHECK(out.size() == 400);
+  CHECK(r.process(in.begin(), in.end(), out.begin()) == out.end());
+
+  // ignore the edges
+  for (size_t i = 100; i < 300; ++i)
+  {
+    INFO("i = " << i);
+    CHECK(out[i] == Approx(std::sin(0.05 * static_cast<double>(i)))
+        .epsilon(0.001));
+  }
+}
+
+SECTION("DC", "")
+{
+  apf::Resampler r(48000, 44100);
+  auto in = std::vector<double>(500, 1.0);
+  auto out = std::vector<double>(r.output_size(in.size()));
+  CHECK(out.size() == 460);
+  r.process(in.begin(), in.end(), out.begin());
+
+  for (size_t i = 100; i < 360; ++i)
+  {
+    INFO("i = " << i);
+    CHECK(out[i] == Approx(1.0).epsilon(0.001));
+  }
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
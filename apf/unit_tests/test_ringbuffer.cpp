@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the Audio Processing Framework (APF).                 *
+ *                                                                            *
+ * The APF is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The APF is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ *                                 http://AudioProcessingFramework.github.com *
+ ******************************************************************************/
+
+// Tests for RingBuffer.
+
+#include <vector>
+
+#include "apf/ringbuffer.h"
+
+#include "catch/catch.hpp"
+
+TEST_CASE("RingBuffer", "Test RingBuffer")
+{
+
+SECTION("size", "is rounded up to power of 2")
+{
+  apf::RingBuffer<float> rb(5);
+  CHECK(rb.size() == 8);
+  CHECK(rb.write_space() == 8);
+  CHECK(rb.read_space() == 0);
+}
+
+SECTION("write and read", "with wrap-around")
+{
+  apf::RingBuffer<int> rb(8);
+  int in[] = { 1, 2, 3, 4, 5, 6 };
+  int out[8] = {};
+
+  CHECK(rb.write(in, in + 6) == 6);
+  CHECK(rb.read_space() == 6);
+  CHECK(rb.write_space() == 2);
+  CHECK(rb.read(out, 4) == 4);
+  CHECK(out[0] == 1);
+  CHECK(out[3] == 4);
+
+  // only 6 samples fit
+  CHECK(rb.write(in, in + 6) == 6);
+  CHECK(rb.write(in, in + 6) == 0);
+  CHECK(rb.read_space() == 8);
+
+  CHECK(rb.read(out, 10) == 8);
+  int expected[] = { 5, 6, 1, 2, 3, 4, 5, 6 };
+  CHECK(std::vector<int>(out, out + 8)
+      == std::vector<int>(expected, expected + 8));
+  CHECK(rb.read_space() == 0);
+  CHECK(rb.read_index() == 12);
+  CHECK(rb.write_index() == 12);
+}
+
+SECTION("zeros and skip", "")
+{
+  apf::RingBuffer<int> rb(4);
+  int in[] = { 1, 2, 3 };
+  int out[4] = { 9, 9, 9, 9 };
+
+  CHECK(rb.write(in, in + 3) == 3);
+  CHECK(rb.write_zeros(5) == 1);
+  CHECK(rb.skip(2) == 2);
+  CHECK(rb.read(out, 4) == 2);
+  CHECK(out[0] == 3);
+  CHECK(out[1] == 0);
+  CHECK(out[2] == 9);
+
+  CHECK(rb.write(in, in + 3) == 3);
+  rb.skip_to(rb.write_index() - 1);
+  CHECK(rb.read_space() == 1);
+  CHECK(rb.read(out, 4) == 1);
+  CHECK(out[0] == 3);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
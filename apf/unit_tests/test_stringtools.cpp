@@ -57,6 +57,16 @@ SECTION("S2A", "String to Anything")
   CHECK(S2A(" 42    ", res_str));
   CHECK(res_str == "42");
 
+  // without trailing whitespace
+  CHECK(S2A("23", res_int));
+  CHECK(res_int == 23);
+  CHECK(S2A(std::string("23"), res_dbl));
+  CHECK(res_dbl == 23.0);
+  CHECK(S2A("true", res_bool));
+  CHECK(res_bool == true);
+  CHECK(S2A("0", res_bool));
+  CHECK(res_bool == false);
+
   CHECK_FALSE(S2A(" - 42    ", res_int));
   CHECK(S2A(" -42    ", res_int));
   CHECK(res_int == -42);
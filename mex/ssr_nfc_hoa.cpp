@@ -49,7 +49,6 @@ using apf::str::S2A;
 std::auto_ptr<ssr::NfcHoaRenderer> engine;
 mwSize in_channels, out_channels, block_size, sample_rate, threads;
 typedef ssr::NfcHoaRenderer::sample_type sample_type;
-std::vector<sample_type*> inputs, outputs;
 
 // TODO: separate file with generic helper functions (maybe apf::mex namespace?)
 
@@ -223,8 +222,6 @@ void init(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
     engine->add_source();
   }
 
-  inputs.resize(in_channels);
-  outputs.resize(out_channels);
 
   engine->activate();  // start parallel processing (if threads > 1)
 
@@ -275,19 +272,8 @@ void process(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
   sample_type*  input = static_cast<sample_type*>(mxGetData(prhs[0]));
 #endif
 
-  for (int i = 0; i <= in_channels; ++i)
-  {
-    inputs[i] = input;
-    input += block_size;
-  }
-
-  for (int i = 0; i <= out_channels; ++i)
-  {
-    outputs[i] = output;
-    output += block_size;
-  }
-
-  engine->audio_callback(block_size, inputs.data(), outputs.data());
+  // Matlab matrices are column-major, the channels can be used directly
+  engine->audio_callback(block_size, input, block_size, output, block_size);
 }
 
 void source(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
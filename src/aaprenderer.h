@@ -61,6 +61,7 @@ class AapRenderer : public SourceToOutput<AapRenderer, LoudspeakerRenderer>
     APF_PROCESS(AapRenderer, _base)
     {
       _process_list(_source_list);
+      this->_distribute_active_channels();
     }
 
     void load_reproduction_setup();
@@ -72,22 +73,48 @@ class AapRenderer : public SourceToOutput<AapRenderer, LoudspeakerRenderer>
 
 class AapRenderer::Source : public _base::Source
 {
+  private:
+    void _process();
+
   public:
     Source(const Params& p)
-      : _base::Source(p, p.parent->get_output_list().size(), this)
-    {}
+      : _base::Source(p)
+    {
+      const auto& outputs = p.parent->get_output_list();
+      this->sourcechannels.reserve(outputs.size());
+      for (const auto& out: rtlist_proxy<Output>(outputs))
+      {
+        this->sourcechannels.emplace_back(this, out);
+      }
+    }
+
+    APF_PROCESS(Source, _base::Source)
+    {
+      _process();
+    }
+
+    // see RendererBase::_distribute_active_channels()
+    void connect() {}
+    void disconnect() {}
 
     bool get_output_levels(sample_type* first, sample_type* last) const;
+
+    void reset();
+
+    /// Channels which are handed over to the outputs in this block
+    ActiveList<SourceChannel> active_channels;
 };
 
-class AapRenderer::SourceChannel
+class AapRenderer::SourceChannel : public ActiveList<SourceChannel>::Hook
 {
   public:
-    explicit SourceChannel(const Source* s)
+    SourceChannel(const Source* s, const Output& o)
       : source(*s)
+      , output(&o)
     {}
 
     const Source& source;
+    const Output* const output;
 
     using iterator = decltype(source.begin());
 
@@ -97,6 +124,16 @@ class AapRenderer::SourceChannel
     apf::BlockParameter<sample_type> stored_weight;
 };
 
+void
+AapRenderer::Source::reset()
+{
+  _base::Source::reset();
+  for (auto& channel: this->sourcechannels)
+  {
+    channel.stored_weight = apf::BlockParameter<sample_type>();
+  }
+}
+
 
 bool
 AapRenderer::Source::get_output_levels(sample_type* first
@@ -147,10 +184,8 @@ class AapRenderer::Output : public _base::Output
   public:
     Output(const Params& p)
       : _base::Output(p)
-      , _combiner(this->sourcechannels, this->buffer)
+      , _combiner(this->active_channels, this->buffer)
     {
-      // TODO: add delay line (in some base class?)
-
       // TODO: amplitude correction for misplaced loudspeakers?
       //_weight = loudspeaker_distance / farthest_loudspeaker_distance;
     }
@@ -160,9 +195,12 @@ class AapRenderer::Output : public _base::Output
       _combiner.process(RenderFunction(*this));
     }
 
+    /// Source channels with non-zero (old or new) weight
+    ActiveList<SourceChannel> active_channels;
+
   private:
-    apf::CombineChannelsInterpolation<apf::cast_proxy<SourceChannel
-      , sourcechannels_t>, buffer_type> _combiner;
+    apf::CombineChannelsInterpolation<ActiveList<SourceChannel>&
+      , buffer_type> _combiner;
 };
 
 void
@@ -177,9 +215,6 @@ AapRenderer::load_reproduction_setup()
 
   // TODO: check somehow if loudspeaker setup is reasonable?
 
-  // TODO: get loudspeaker delays from setup?
-  // delay_samples = size_t(delay * sample_rate + 0.5f)
-
   int normal_loudspeakers = 0;
 
   for (const auto& out: rtlist_proxy<Output>(this->get_output_list()))
@@ -211,80 +246,100 @@ AapRenderer::load_reproduction_setup()
   // TODO: more things?
 }
 
-apf::CombineChannelsResult::type
-AapRenderer::RenderFunction::select(SourceChannel& in)
+void
+AapRenderer::Source::_process()
 {
   // TODO: take loudspeaker weight into account (for misplaced loudspeakers)?
 
   using apf::math::deg2rad;
 
-  float two_times_order = 2 * _out.parent._ambisonics_order;
+  float two_times_order = 2 * this->parent._ambisonics_order;
 
-  auto weighting_factor = sample_type();
+  // WARNING: The reference offset is currently broken!
 
-  if (_out.model == Loudspeaker::normal)
-  {
-    // WARNING: The reference offset is currently broken!
-
-    float alpha_0  = deg2rad((_out.position).orientation().azimuth);
-    float theta_pw = deg2rad(((in.source.position -
-            _out.parent.state.reference_position).orientation()
-          - _out.parent.state.reference_orientation).azimuth);
-
-    // TODO: wrap angles?
-
-    if (_out.parent._in_phase_rendering)
-    {
-      weighting_factor = std::pow(std::cos((alpha_0 - theta_pw) / 2)
-          , two_times_order);
-    }
-    else
-    {
-      // check numerical stability
-      if (std::abs(std::sin((alpha_0 - theta_pw) / 2)) < 0.0001f)
-      {
-        weighting_factor = 1;
-      }
-      else
-      {
-        weighting_factor
-          = std::sin((two_times_order + 1) * (alpha_0 - theta_pw) / 2) /
-           ((two_times_order + 1) * std::sin((alpha_0 - theta_pw) / 2));
-      }
-    }
-  }
-  else
-  {
-    // TODO: subwoofer gets weighting factor 1.0?
-    weighting_factor = 1;
-  }
+  float theta_pw = deg2rad(((this->position
+          - this->parent.state.reference_position).orientation()
+        - this->parent.state.reference_orientation).azimuth);
 
   // TODO: centralize distance attenuation
 
+  auto distance_attenuation = sample_type();
+
   // no distance attenuation for plane waves 
-  if (in.source.model == ::Source::plane)
+  if (this->model == ::Source::plane)
   {
-    auto ampl_ref = _out.parent.state.amplitude_reference_distance;
-    weighting_factor *= 0.5f / ampl_ref;  // 1/r
-    //weighting_factor *= 0.25f / sqrt(ampl_ref);  // 1/sqrt(r)
+    auto ampl_ref = this->parent.state.amplitude_reference_distance;
+    distance_attenuation = 0.5f / ampl_ref;  // 1/r
+    //distance_attenuation = 0.25f / sqrt(ampl_ref);  // 1/sqrt(r)
   }
   else
   {
     auto source_distance
-      = (in.source.position - _out.parent.state.reference_position).length();
+      = (this->position - this->parent.state.reference_position).length();
 
     // no volume increase for sources closer than 0.5m to reference position
     source_distance = std::max(source_distance, 0.5f);
 
-    weighting_factor *= 0.5f / source_distance;  // 1/r
-    //weighting_factor *= 0.25f / sqrt(source_distance);  // 1/sqrt(r)
+    distance_attenuation = 0.5f / source_distance;  // 1/r
+    //distance_attenuation = 0.25f / sqrt(source_distance);  // 1/sqrt(r)
   }
 
-  // Apply source volume, mute, ...
-  weighting_factor *= in.source.weighting_factor;
+  for (auto& channel: this->sourcechannels)
+  {
+    auto weighting_factor = sample_type();
+
+    if (channel.output->model == Loudspeaker::normal)
+    {
+      float alpha_0
+        = deg2rad((channel.output->position).orientation().azimuth);
+
+      // TODO: wrap angles?
+
+      if (this->parent._in_phase_rendering)
+      {
+        weighting_factor = std::pow(std::cos((alpha_0 - theta_pw) / 2)
+            , two_times_order);
+      }
+      else
+      {
+        // check numerical stability
+        if (std::abs(std::sin((alpha_0 - theta_pw) / 2)) < 0.0001f)
+        {
+          weighting_factor = 1;
+        }
+        else
+        {
+          weighting_factor
+            = std::sin((two_times_order + 1) * (alpha_0 - theta_pw) / 2) /
+             ((two_times_order + 1) * std::sin((alpha_0 - theta_pw) / 2));
+        }
+      }
+    }
+    else
+    {
+      // TODO: subwoofer gets weighting factor 1.0?
+      weighting_factor = 1;
+    }
+
+    weighting_factor *= distance_attenuation;
+
+    // Apply source volume, mute, ...
+    weighting_factor *= this->weighting_factor;
 
-  in.stored_weight = weighting_factor;
+    channel.stored_weight = weighting_factor;
 
+    // Channels which are fading out have to be processed as well
+    if (channel.stored_weight != 0 || channel.stored_weight.old() != 0)
+    {
+      this->active_channels.push_front(channel);
+    }
+  }
+}
+
+apf::CombineChannelsResult::type
+AapRenderer::RenderFunction::select(SourceChannel& in)
+{
+  auto weighting_factor = in.stored_weight.get();
   auto old_weight = in.stored_weight.old();
 
   using namespace apf::CombineChannelsResult;
@@ -0,0 +1,502 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Subscriber which forwards all calls asynchronously (definition).
+
+#ifndef SSR_ASYNCSUBSCRIBER_H
+#define SSR_ASYNCSUBSCRIBER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>  // for std::function
+#include <map>
+#include <mutex>  // for std::mutex
+#include <thread>
+#include <utility>  // for std::pair
+#include <vector>
+
+#include "subscriber.h"
+#include "ssr_global.h"  // for WARNING(), ERROR()
+
+namespace ssr
+{
+
+/** Forwards all calls to another Subscriber in a separate thread.
+ * Calls are stored in a bounded queue and executed by a dedicated thread,
+ * therefore a slow subscriber (e.g. a network client) doesn't delay the
+ * publisher and the other subscribers.
+ *
+ * Calls which only set a new value (positions, orientations, levels, ...)
+ * are coalesced: if a call for the same property (and the same source) is
+ * still waiting in the queue, its value is replaced (latest value wins).
+ * Calls which change the set of sources or loudspeakers are never coalesced,
+ * and no later call is merged into an entry before them.
+ *
+ * No call is ever lost: if the queue is full anyway, all waiting calls are
+ * discarded and replaced by the complete current state (see the @p resync
+ * argument of the constructor), and a warning is shown.
+ **/
+class AsyncSubscriber : public Subscriber
+{
+  public:
+    /// Function which sends the complete state to the given subscriber,
+    /// e.g. Scene::replay()
+    using resync_t = std::function<void(Subscriber&)>;
+
+    /// Constructor.
+    /// @param target subscriber which receives the calls
+    /// @param resync used if the queue is full, it is called in the thread of
+    ///   the publisher and must reflect the call which caused the overflow
+    /// @param max_size maximum number of waiting calls (except for the calls
+    ///   of a resync)
+    AsyncSubscriber(Subscriber& target, resync_t resync
+        , size_t max_size = 4096)
+      : _target(target)
+      , _resync(std::move(resync))
+      , _max_size(max_size)
+      , _first(0)
+      , _resyncs(0)
+      , _resyncing(false)
+      , _stop(false)
+      , _thread(&AsyncSubscriber::_dispatch_thread, this)
+    {}
+
+    /// Destructor. Waiting calls are discarded.
+    ~AsyncSubscriber()
+    {
+      {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _stop = true;
+      }
+      _condition.notify_all();
+      _thread.join();
+    }
+
+    Subscriber& target() const { return _target; }
+
+    virtual void set_loudspeakers(const Loudspeaker::container_t& loudspeakers)
+    {
+      _push({no_property, 0}, [this, loudspeakers] ()
+          {
+            _target.set_loudspeakers(loudspeakers);
+          });
+    }
+
+    virtual void new_source(id_t id)
+    {
+      _push({no_property, 0}, [this, id] () { _target.new_source(id); });
+    }
+
+    virtual void delete_source(id_t id)
+    {
+      _push({no_property, 0}, [this, id] () { _target.delete_source(id); });
+    }
+
+    virtual void delete_all_sources()
+    {
+      _push({no_property, 0}, [this] () { _target.delete_all_sources(); });
+    }
+
+    virtual bool set_source_position(id_t id, const Position& position)
+    {
+      return _push({source_position, id}, [this, id, position] ()
+          {
+            _target.set_source_position(id, position);
+          });
+    }
+
+    virtual bool set_source_orientation(id_t id
+        , const Orientation& orientation)
+    {
+      return _push({source_orientation, id}, [this, id, orientation] ()
+          {
+            _target.set_source_orientation(id, orientation);
+          });
+    }
+
+    virtual bool set_source_gain(id_t id, const float& gain)
+    {
+      return _push({source_gain, id}, [this, id, gain] ()
+          {
+            _target.set_source_gain(id, gain);
+          });
+    }
+
+    virtual bool set_source_signal_level(const id_t id, const float& level)
+    {
+      return _push({source_signal_level, id}, [this, id, level] ()
+          {
+            _target.set_source_signal_level(id, level);
+          });
+    }
+
+    virtual bool set_source_mute(id_t id, const bool& mute)
+    {
+      return _push({source_mute, id}, [this, id, mute] ()
+          {
+            _target.set_source_mute(id, mute);
+          });
+    }
+
+    virtual bool set_source_name(id_t id, const std::string& name)
+    {
+      return _push({source_name, id}, [this, id, name] ()
+          {
+            _target.set_source_name(id, name);
+          });
+    }
+
+    virtual bool set_source_properties_file(id_t id, const std::string& name)
+    {
+      return _push({source_properties_file, id}, [this, id, name] ()
+          {
+            _target.set_source_properties_file(id, name);
+          });
+    }
+
+    virtual bool set_source_model(id_t id, const Source::model_t& model)
+    {
+      return _push({source_model, id}, [this, id, model] ()
+          {
+            _target.set_source_model(id, model);
+          });
+    }
+
+    virtual bool set_source_port_name(id_t id, const std::string& port_name)
+    {
+      return _push({source_port_name, id}, [this, id, port_name] ()
+          {
+            _target.set_source_port_name(id, port_name);
+          });
+    }
+
+    virtual bool set_source_file_name(id_t id, const std::string& file_name)
+    {
+      return _push({source_file_name, id}, [this, id, file_name] ()
+          {
+            _target.set_source_file_name(id, file_name);
+          });
+    }
+
+    virtual bool set_source_file_channel(id_t id, const int& file_channel)
+    {
+      return _push({source_file_channel, id}, [this, id, file_channel] ()
+          {
+            _target.set_source_file_channel(id, file_channel);
+          });
+    }
+
+    virtual bool set_source_position_fixed(id_t id, const bool& fixed)
+    {
+      return _push({source_position_fixed, id}, [this, id, fixed] ()
+          {
+            _target.set_source_position_fixed(id, fixed);
+          });
+    }
+
+    virtual bool set_source_file_length(id_t id, const long int& length)
+    {
+      return _push({source_file_length, id}, [this, id, length] ()
+          {
+            _target.set_source_file_length(id, length);
+          });
+    }
+
+    virtual bool set_source_error(id_t id, const std::string& message)
+    {
+      return _push({source_error, id}, [this, id, message] ()
+          {
+            _target.set_source_error(id, message);
+          });
+    }
+
+    virtual void set_reference_position(const Position& position)
+    {
+      _push({reference_position, 0}, [this, position] ()
+          {
+            _target.set_reference_position(position);
+          });
+    }
+
+    virtual void set_reference_orientation(const Orientation& orientation)
+    {
+      _push({reference_orientation, 0}, [this, orientation] ()
+          {
+            _target.set_reference_orientation(orientation);
+          });
+    }
+
+    virtual void set_reference_offset_position(const Position& position)
+    {
+      _push({reference_offset_position, 0}, [this, position] ()
+          {
+            _target.set_reference_offset_position(position);
+          });
+    }
+
+    virtual void set_reference_offset_orientation(
+        const Orientation& orientation)
+    {
+      _push({reference_offset_orientation, 0}, [this, orientation] ()
+          {
+            _target.set_reference_offset_orientation(orientation);
+          });
+    }
+
+    virtual void set_master_volume(float volume)
+    {
+      _push({master_volume, 0}, [this, volume] ()
+          {
+            _target.set_master_volume(volume);
+          });
+    }
+
+    virtual void set_amplitude_reference_distance(float distance)
+    {
+      _push({amplitude_reference_distance, 0}, [this, distance] ()
+          {
+            _target.set_amplitude_reference_distance(distance);
+          });
+    }
+
+    virtual void set_master_signal_level(float level)
+    {
+      _push({master_signal_level, 0}, [this, level] ()
+          {
+            _target.set_master_signal_level(level);
+          });
+    }
+
+    virtual void set_cpu_load(float load)
+    {
+      _push({cpu_load, 0}, [this, load] () { _target.set_cpu_load(load); });
+    }
+
+    virtual void set_sample_rate(int sample_rate)
+    {
+      _push({sample_rate_key, 0}, [this, sample_rate] ()
+          {
+            _target.set_sample_rate(sample_rate);
+          });
+    }
+
+    virtual void set_source_output_levels(id_t id, float* first, float* last)
+    {
+      auto levels = std::vector<float>(first, last);
+      _push({source_output_levels, id}, [this, id, levels] () mutable
+          {
+            _target.set_source_output_levels(id
+                , levels.data(), levels.data() + levels.size());
+          });
+    }
+
+    virtual void set_levels(const LevelSnapshot::ptr& levels)
+    {
+      _push({all_levels, 0}, [this, levels] () { _target.set_levels(levels); });
+    }
+
+    virtual void set_processing_state(bool state)
+    {
+      _push({processing_state, 0}, [this, state] ()
+          {
+            _target.set_processing_state(state);
+          });
+    }
+
+    virtual void set_transport_state(
+        const std::pair<bool, jack_nframes_t>& state)
+    {
+      _push({transport_state, 0}, [this, state] ()
+          {
+            _target.set_transport_state(state);
+          });
+    }
+
+  private:
+    /// Properties which can be coalesced
+    enum property_t
+    {
+      no_property = 0
+      , source_position
+      , source_orientation
+      , source_gain
+      , source_signal_level
+      , source_mute
+      , source_name
+      , source_properties_file
+      , source_model
+      , source_port_name
+      , source_file_name
+      , source_file_channel
+      , source_position_fixed
+      , source_file_length
+      , source_error
+      , source_output_levels
+      , reference_position
+      , reference_orientation
+      , reference_offset_position
+      , reference_offset_orientation
+      , master_volume
+      , amplitude_reference_distance
+      , master_signal_level
+      , all_levels
+      , cpu_load
+      , sample_rate_key
+      , processing_state
+      , transport_state
+    };
+
+    /// Property and source ID (0 if the property doesn't belong to a source)
+    using key_t = std::pair<property_t, id_t>;
+
+    /// Queue a call or replace a waiting call with the same key.
+    /// If the queue is full, the complete state is queued instead.
+    /// @return always @b true
+    bool _push(const key_t& key, std::function<void()> call)
+    {
+      {
+        std::lock_guard<std::mutex> guard(_mutex);
+
+        if (key.first == no_property)
+        {
+          // later calls must not be moved before this one
+          _index.clear();
+        }
+        else
+        {
+          auto found = _index.find(key);
+          if (found != _index.end())
+          {
+            // the position in the queue stays the same
+            _queue[found->second - _first] = std::move(call);
+            return true;
+          }
+        }
+
+        if (_queue.size() < _max_size || _resyncing)
+        {
+          if (key.first != no_property)
+          {
+            _index[key] = _first + _queue.size();
+          }
+          _queue.push_back(std::move(call));
+          call = nullptr;
+        }
+        else
+        {
+          // The waiting calls (and this one) are superseded by the resync
+          _first += _queue.size();
+          _queue.clear();
+          _index.clear();
+          _resyncing = true;
+          ++_resyncs;
+        }
+      }
+
+      if (call)
+      {
+        // _resync() calls _push() again (for each part of the state)
+        _resync(*this);
+
+        std::lock_guard<std::mutex> guard(_mutex);
+        _resyncing = false;
+      }
+
+      _condition.notify_one();
+      return true;
+    }
+
+    void _dispatch_thread()
+    {
+      std::deque<std::function<void()>> calls;
+      size_t resyncs = 0;
+
+      std::unique_lock<std::mutex> lock(_mutex);
+
+      for (;;)
+      {
+        _condition.wait(lock, [this] () { return _stop || !_queue.empty(); });
+
+        if (_stop) break;
+
+        // Take all waiting calls at once, the publisher can go on while they
+        // are executed.
+        calls.swap(_queue);
+        _first += calls.size();
+        _index.clear();
+        std::swap(resyncs, _resyncs);
+
+        lock.unlock();
+
+        if (resyncs)
+        {
+          WARNING("Subscriber queue was full, the whole state was sent again ("
+              << resyncs << " time(s))!");
+          resyncs = 0;
+        }
+
+        for (auto& call: calls)
+        {
+          try
+          {
+            call();
+          }
+          catch (const std::exception& e)
+          {
+            ERROR("Exception in asynchronous subscriber: " << e.what());
+          }
+        }
+        calls.clear();
+
+        lock.lock();
+      }
+    }
+
+    Subscriber& _target;
+    const resync_t _resync;
+    const size_t _max_size;
+
+    std::deque<std::function<void()>> _queue;
+    /// position of waiting calls which can be coalesced
+    std::map<key_t, size_t> _index;
+    size_t _first;  ///< number of calls which have left the queue
+    size_t _resyncs;  ///< number of overflows since the last warning
+    bool _resyncing;  ///< while @b true, the queue size is not limited
+    bool _stop;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _thread;  // initialized last!
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
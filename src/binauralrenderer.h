@@ -33,10 +33,10 @@
 #include "rendererbase.h"
 #include "apf/iterator.h"  // for apf::cast_proxy, apf::make_cast_proxy()
 #include "apf/convolver.h"  // for apf::conv::*
-#include "apf/container.h"  // for apf::fixed_matrix
-#include "apf/sndfiletools.h"  // for apf::load_sndfile
 #include "apf/combine_channels.h"  // for apf::raised_cosine_fade, ...
 
+#include "ircache.h"
+
 namespace ssr
 {
 
@@ -57,7 +57,10 @@ class BinauralRenderer : public SourceToOutput<BinauralRenderer, RendererBase>
     BinauralRenderer(const apf::parameter_map& params)
       : _base(params)
       , _fade(this->block_size())
+      , _ir_cache(this->params.get("ir_cache_dir", ""))
       , _partitions(0)
+      , _lod_distance(this->params.get("lod_distance", 0.0f))
+      , _lod_partitions(0)
     {}
 
     void load_reproduction_setup();
@@ -68,19 +71,17 @@ class BinauralRenderer : public SourceToOutput<BinauralRenderer, RendererBase>
     }
 
   private:
-    using hrtf_set_t = apf::fixed_vector<apf::conv::Filter>;
-
     void _load_hrtfs(const std::string& filename, size_t size);
 
-    static bool _cmp_abs(sample_type left, sample_type right)
-    {
-      return std::abs(left) < std::abs(right);
-    }
-
     apf::raised_cosine_fade<sample_type> _fade;
+    IrCache _ir_cache;
     size_t _partitions;
+    /// Sources farther away use only the first @c _lod_partitions partitions
+    /// of the HRTFs (0 means no truncation)
+    const float _lod_distance;
+    size_t _lod_partitions;
     size_t _angles;  // Number of angles in HRIR file
-    std::unique_ptr<hrtf_set_t> _hrtfs;
+    IrCache::filter_set_ptr _hrtfs;
     std::unique_ptr<apf::conv::Filter> _neutral_filter;
 };
 
@@ -117,9 +118,12 @@ class BinauralRenderer::SourceChannel : public apf::conv::Output
 void
 BinauralRenderer::_load_hrtfs(const std::string& filename, size_t size)
 {
-  auto hrir_file = apf::load_sndfile(filename, this->sample_rate(), 0);
+  // Deinterleave channels and transform to FFT domain (or get them from the
+  // cache, if this was done before)
+  _hrtfs = _ir_cache.get_filters(filename, this->sample_rate()
+      , this->block_size(), 0, size);
 
-  const size_t no_of_channels = hrir_file.channels();
+  const size_t no_of_channels = _hrtfs->size();
 
   if (no_of_channels % 2 != 0)
   {
@@ -129,36 +133,18 @@ BinauralRenderer::_load_hrtfs(const std::string& filename, size_t size)
 
   _angles = no_of_channels / 2;
 
-  // TODO: handle size > hrir_file.frames()
-
-  if (size == 0) size = hrir_file.frames();
-
-  // Deinterleave channels and transform to FFT domain
+  _partitions = _hrtfs->front().partitions();
 
-  auto transpose = apf::fixed_matrix<float>(size, no_of_channels);
-
-  size = hrir_file.readf(transpose.data(), size);
-
-  _partitions = apf::conv::min_partitions(this->block_size(), size);
-
-  auto temp = apf::conv::Transform(this->block_size());
-
-  _hrtfs.reset(new hrtf_set_t(no_of_channels, this->block_size(), _partitions));
-
-  auto target = _hrtfs->begin();
-  for (const auto& slice: transpose.slices)
-  {
-    temp.prepare_filter(slice.begin(), slice.end(), *target++);
-  }
+  // Truncated HRIRs of distant sources still contain the direct sound and
+  // the first reflections of the head and torso
+  const size_t lod_hrir_size = 256;
+  _lod_partitions = std::min(_partitions
+      , (lod_hrir_size + this->block_size() - 1) / this->block_size());
 
   // prepare neutral filter (dirac impulse) for interpolation around the head
 
   // get index of absolute maximum in first channel (frontal direcion, left)
-  apf::fixed_matrix<sample_type>::slice_iterator maximum
-    = std::max_element(transpose.slices.begin()->begin()
-      , transpose.slices.begin()->end(), _cmp_abs);
-
-  int index = std::distance(transpose.slices.begin()->begin(), maximum);
+  size_t index = _hrtfs->peaks.front();
 
   auto impulse = apf::fixed_vector<sample_type>(index + 1);
   impulse.back() = 1;
@@ -245,8 +231,23 @@ class BinauralRenderer::Source : public apf::conv::Input, public _base::Source
       , _hrtf_index(size_t(-1))
       , _interp_factor(-1.0f)
       , _weight(0.0f)
+      , _max_partitions(size_t(0))
+      , _far(false)
     {}
 
+    void reset()
+    {
+      _base::Source::reset();
+      this->clear();
+      for (auto& channel: this->sourcechannels) channel.clear_filter();
+      // Same values as in the constructor
+      _hrtf_index = apf::BlockParameter<size_t>(size_t(-1));
+      _interp_factor = apf::BlockParameter<float>(-1.0f);
+      _weight = apf::BlockParameter<float>(0.0f);
+      _max_partitions = apf::BlockParameter<size_t>(size_t(0));
+      _far = false;
+    }
+
     APF_PROCESS(Source, _base::Source)
     {
       _process();
@@ -256,6 +257,8 @@ class BinauralRenderer::Source : public apf::conv::Input, public _base::Source
     apf::BlockParameter<size_t> _hrtf_index;
     apf::BlockParameter<float> _interp_factor;
     apf::BlockParameter<float> _weight;
+    apf::BlockParameter<size_t> _max_partitions;
+    bool _far;  ///< Level of detail, see BinauralRenderer::_lod_distance
 };
 
 void BinauralRenderer::Source::_process()
@@ -263,7 +266,16 @@ void BinauralRenderer::Source::_process()
   float interp_factor = 0.0f;
   float weight = 0.0f;
 
-  this->add_block(_input.begin());
+  if (this->weighting_factor.both() == 0)
+  {
+    // Muted or culled, there is no need to transform the input signal.
+    // When the source is faded in, it starts without history.
+    this->clear();
+  }
+  else
+  {
+    this->add_block(_input.begin());
+  }
 
   auto ref_pos = _input.parent.state.reference_position
     + _input.parent.state.reference_offset_position;
@@ -288,6 +300,14 @@ void BinauralRenderer::Source::_process()
     {
       float source_distance = (this->position - ref_pos).length();
 
+      const auto lod_distance = _input.parent._lod_distance;
+      if (lod_distance > 0)
+      {
+        // hysteresis, to avoid switching back and forth
+        if (source_distance > lod_distance) _far = true;
+        else if (source_distance < 0.9f * lod_distance) _far = false;
+      }
+
       if (source_distance < 0.5f)
       {
         interp_factor = 1.0f - 2 * source_distance;
@@ -305,6 +325,8 @@ void BinauralRenderer::Source::_process()
 
   _interp_factor = interp_factor;  // Assign (once!) to BlockParameter
   _weight = weight;  // ... same here
+  _max_partitions = _far ? _input.parent._lod_partitions
+                         : _input.parent._partitions;
 
   float angles = _input.parent._angles;
 
@@ -319,7 +341,9 @@ void BinauralRenderer::Source::_process()
   // Check on one channel only, filters are always changed in parallel
   bool queues_empty = this->sourcechannels[0].queues_empty();
 
-  bool hrtf_changed = _hrtf_index.changed() || _interp_factor.changed();
+  // Changing the number of partitions is crossfaded like any other change
+  bool hrtf_changed = _hrtf_index.changed() || _interp_factor.changed()
+    || _max_partitions.changed();
 
   if (_weight.both() == 0)
   {
@@ -364,7 +388,7 @@ void BinauralRenderer::Source::_process()
 
       if (_interp_factor == 0)
       {
-        channel.set_filter(hrtf);
+        channel.set_filter(hrtf, _max_partitions);
       }
       else
       {
@@ -375,7 +399,8 @@ void BinauralRenderer::Source::_process()
               {
                 return (1.0f - _interp_factor) * one + _interp_factor * two;
               });
-        this->sourcechannels[i].set_filter(channel.temporary_hrtf);
+        this->sourcechannels[i].set_filter(channel.temporary_hrtf
+            , _max_partitions);
       }
     }
 
@@ -386,6 +411,7 @@ void BinauralRenderer::Source::_process()
   assert(_hrtf_index.exactly_one_assignment());
   assert(_interp_factor.exactly_one_assignment());
   assert(_weight.exactly_one_assignment());
+  assert(_max_partitions.exactly_one_assignment());
 }
 
 }  // namespace ssr
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// BinaryCommandParser class (implementation).
+
+#include "binarycommandparser.h"
+#include "binaryprotocol.h"
+#include "publisher.h"
+#include "ssr_global.h"  // for ERROR()
+
+ssr::BinaryCommandParser::BinaryCommandParser(Publisher& controller)
+  : _controller(controller)
+{}
+
+/** Parse all complete records in a buffer.
+ * @param first begin of received data
+ * @param last end of received data
+ * @return number of bytes which were used, an incomplete record at the end
+ *   is left for the next call.
+ **/
+size_t
+ssr::BinaryCommandParser::parse(const char* first, const char* last)
+{
+  const char* const begin = first;
+
+  for (;;)
+  {
+    binary::Reader header(first, last);
+    uint16_t type, size;
+    if (!header.u16(type) || !header.u16(size)) break;
+    if (last - first < static_cast<std::ptrdiff_t>(binary::header_size + size))
+    {
+      break;
+    }
+    first += binary::header_size;
+    _dispatch(type, first, first + size);
+    first += size;
+  }
+  return static_cast<size_t>(first - begin);
+}
+
+void
+ssr::BinaryCommandParser::_dispatch(unsigned type, const char* first
+    , const char* last)
+{
+  binary::Reader in(first, last);
+  uint32_t id;
+  uint8_t flag;
+  float x, y;
+
+  switch (type)
+  {
+    case binary::source_position:
+      if (in.u32(id) && in.f32(x) && in.f32(y))
+      {
+        _controller.set_source_position(id, Position(x, y));
+        return;
+      }
+      break;
+
+    case binary::source_orientation:
+      if (in.u32(id) && in.f32(x))
+      {
+        _controller.set_source_orientation(id, Orientation(x));
+        return;
+      }
+      break;
+
+    case binary::source_gain:
+      if (in.u32(id) && in.f32(x))
+      {
+        _controller.set_source_gain(id, x);
+        return;
+      }
+      break;
+
+    case binary::source_mute:
+      if (in.u32(id) && in.u8(flag))
+      {
+        _controller.set_source_mute(id, flag != 0);
+        return;
+      }
+      break;
+
+    case binary::reference_position:
+      if (in.f32(x) && in.f32(y))
+      {
+        _controller.set_reference_position(Position(x, y));
+        return;
+      }
+      break;
+
+    case binary::reference_orientation:
+      if (in.f32(x))
+      {
+        _controller.set_reference_orientation(Orientation(x));
+        return;
+      }
+      break;
+
+    case binary::master_volume:
+      if (in.f32(x))
+      {
+        _controller.set_master_volume(x);
+        return;
+      }
+      break;
+
+    case binary::transport:
+      if (in.u8(flag))
+      {
+        if (flag) _controller.transport_start();
+        else _controller.transport_stop();
+        return;
+      }
+      break;
+
+    case binary::processing:
+      if (in.u8(flag))
+      {
+        if (flag) _controller.start_processing();
+        else _controller.stop_processing();
+        return;
+      }
+      break;
+
+    default:
+      VERBOSE("Ignoring binary message of unknown type " << type);
+      return;
+  }
+  ERROR("Binary message of type " << type << " is too short!");
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -25,47 +25,37 @@
  ******************************************************************************/
 
 /// @file
-/// Audio recorder using ecasound (definition).
+/// BinaryCommandParser class (definition).
 
-#ifndef SSR_AUDIORECORDER_H
-#define SSR_AUDIORECORDER_H
+#ifndef SSR_BINARYCOMMANDPARSER_H
+#define SSR_BINARYCOMMANDPARSER_H
 
-#include <eca-control-interface.h>
-#include <string>
-#include <memory>
-#include <stdexcept> // for std::runtime_error
+#include <cstddef>  // for size_t
 
-/**
- * Writes a (multichannel) soundfile using ecasound and JACK transport.
- **/
-class AudioRecorder
+namespace ssr
 {
-  public:
-    using ptr_t = std::unique_ptr<AudioRecorder>; ///< auto_ptr to AudioRecorder
-
-    /// exception to be thrown by ctor.
-    struct audiorecorder_error : public std::runtime_error
-    {
-      audiorecorder_error(const std::string& s): std::runtime_error(s) {}
-    };
 
-    ~AudioRecorder();
+struct Publisher;
 
-    AudioRecorder(const std::string& audio_file_name,
-        const std::string& format_string, const std::string& record_source,
-        const std::string& client_name = "recorder",
-        const std::string& input_prefix = "channel") throw(audiorecorder_error);
-
-    bool enable();   ///< enable recording as soon as transport is started
-    bool disable();  ///< disable recording
+/** Parses binary messages and maps them to the Controller.
+ * This is the counterpart of CommandParser for connections which were
+ * switched to the binary protocol (see binaryprotocol.h).
+ **/
+class BinaryCommandParser
+{
+  public:
+    explicit BinaryCommandParser(Publisher& controller);
 
-    const std::string client_name;   ///< name of JACK client used by ecasound
-    const std::string input_prefix;  ///< prefix used for channels
+    size_t parse(const char* first, const char* last);
 
   private:
-    ECA_CONTROL_INTERFACE _eca; ///< interface to ecasound
+    void _dispatch(unsigned type, const char* first, const char* last);
+
+    Publisher& _controller;
 };
 
+}  // namespace ssr
+
 #endif
 
 // Settings for Vim (http://www.vim.org/), please do not remove:
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Binary network protocol (message format).
+
+#ifndef SSR_BINARYPROTOCOL_H
+#define SSR_BINARYPROTOCOL_H
+
+#include <cassert>  // for assert()
+#include <cstring>  // for std::memcpy()
+#include <stdint.h>
+#include <string>
+
+namespace ssr
+{
+
+/** Compact binary alternative to the XML network protocol.
+ * A client switches a connection to binary mode by sending the zero-terminated
+ * string #handshake instead of an XML message.  The server answers with the
+ * same zero-terminated string, everything after that is binary in both
+ * directions.  Right after the handshake, the server sends the current scene
+ * (starting with a #delete_source record for all sources), because XML updates
+ * which were not sent before the switch are discarded.
+ *
+ * Each message (record) consists of a 4 byte header (16 bit message type,
+ * 16 bit payload size in bytes) followed by the payload.  All numbers are
+ * little-endian, IDs are 32 bit unsigned integers, all other numbers are 32
+ * bit IEEE floats (flags are stored as 8 bit values).  Records of unknown type
+ * are skipped, additional payload bytes are ignored.
+ **/
+namespace binary
+{
+
+/// Sent by the client to switch to binary mode (and echoed by the server).
+const char* const handshake = "SSR-BINARY-1";
+
+const size_t header_size = 4;
+/// The payload size is stored in 16 bits
+const size_t max_payload_size = 0xffff;
+
+/// Message types (and their payload).
+enum message_t
+{
+  source_position = 1,  ///< id, x, y (in meters)
+  source_orientation = 2,  ///< id, azimuth (in degrees)
+  source_gain = 3,  ///< id, gain (linear)
+  source_mute = 4,  ///< id, mute (8 bit)
+  reference_position = 5,  ///< x, y (in meters)
+  reference_orientation = 6,  ///< azimuth (in degrees)
+  master_volume = 7,  ///< volume (linear)
+  transport = 8,  ///< start (8 bit, 1: start, 0: stop)
+  processing = 9,  ///< start (8 bit), client to server only
+  new_source = 16,  ///< id, server to client only
+  delete_source = 17,  ///< id (0: all sources), server to client only
+  source_levels = 18,  ///< n, n times (id, level), server to client only
+};
+
+/// Maximum number of sources in one #source_levels record, the levels of more
+/// sources are split into several records.
+const size_t max_source_levels = (max_payload_size - 4) / 8;
+
+/// Append little-endian values to a string.
+class Writer
+{
+  public:
+    explicit Writer(std::string& buffer) : _buffer(buffer), _start(0) {}
+
+    /// Start a new record, the size is filled in by end().
+    /// The payload must not be larger than #max_payload_size.
+    Writer& begin(message_t type)
+    {
+      _start = _buffer.size();
+      this->u16(static_cast<uint16_t>(type));
+      return this->u16(0);
+    }
+
+    void end()
+    {
+      size_t size = _buffer.size() - _start - header_size;
+      assert(size <= max_payload_size);
+      _buffer[_start + 2] = static_cast<char>(size & 0xff);
+      _buffer[_start + 3] = static_cast<char>((size >> 8) & 0xff);
+    }
+
+    Writer& u8(uint8_t value)
+    {
+      _buffer.push_back(static_cast<char>(value));
+      return *this;
+    }
+
+    Writer& u16(uint16_t value)
+    {
+      this->u8(static_cast<uint8_t>(value & 0xff));
+      return this->u8(static_cast<uint8_t>(value >> 8));
+    }
+
+    Writer& u32(uint32_t value)
+    {
+      this->u16(static_cast<uint16_t>(value & 0xffff));
+      return this->u16(static_cast<uint16_t>(value >> 16));
+    }
+
+    Writer& f32(float value)
+    {
+      uint32_t temp;
+      std::memcpy(&temp, &value, sizeof temp);
+      return this->u32(temp);
+    }
+
+  private:
+    std::string& _buffer;
+    size_t _start;
+};
+
+/// Read little-endian values from the payload of one record.
+/// All functions return @b false if there are not enough bytes left.
+class Reader
+{
+  public:
+    Reader(const char* first, const char* last) : _first(first), _last(last) {}
+
+    bool u8(uint8_t& value)
+    {
+      if (_last - _first < 1) return false;
+      value = static_cast<uint8_t>(*_first++);
+      return true;
+    }
+
+    bool u16(uint16_t& value)
+    {
+      uint8_t low, high;
+      if (!this->u8(low) || !this->u8(high)) return false;
+      value = static_cast<uint16_t>(low | (high << 8));
+      return true;
+    }
+
+    bool u32(uint32_t& value)
+    {
+      uint16_t low, high;
+      if (!this->u16(low) || !this->u16(high)) return false;
+      value = static_cast<uint32_t>(low) | (static_cast<uint32_t>(high) << 16);
+      return true;
+    }
+
+    bool f32(float& value)
+    {
+      uint32_t temp;
+      if (!this->u32(temp)) return false;
+      std::memcpy(&value, &temp, sizeof value);
+      return true;
+    }
+
+  private:
+    const char* _first;
+    const char* const _last;
+};
+
+}  // namespace binary
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -0,0 +1,282 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// BinarySubscriber class (implementation).
+
+#include <algorithm>  // for std::min()
+
+#include "binarysubscriber.h"
+#include "connection.h"
+
+ssr::BinarySubscriber::BinarySubscriber(Connection& connection)
+  : _connection(connection)
+  , _levels_sent(0)
+  , _transport_state(false)
+{}
+
+/// Send the most recent levels of all sources (if they have changed).
+/// This is called periodically by the Connection.
+void
+ssr::BinarySubscriber::send_levels()
+{
+  auto levels = std::atomic_load(&_levels);
+  if (!levels || levels->version == _levels_sent) return;
+  _levels_sent = levels->version;
+
+  // NB: send_levels() is called from another thread than the other functions,
+  // it must not use _buffer.
+  auto buffer = std::string();
+  auto out = binary::Writer(buffer);
+  const size_t total = levels->ids.size();
+  size_t i = 0;
+  do  // at least one record, even without sources
+  {
+    const size_t n = std::min(total - i, binary::max_source_levels);
+    out.begin(binary::source_levels).u32(static_cast<uint32_t>(n));
+    for (const size_t last = i + n; i < last; ++i)
+    {
+      out.u32(levels->ids[i]).f32(levels->source_levels[i]);
+    }
+    out.end();
+  }
+  while (i < total);
+  _connection.write_binary(buffer);
+}
+
+void
+ssr::BinarySubscriber::_send_id(binary::message_t type, id_t id)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(type).u32(id);
+  out.end();
+  _connection.write_binary(_buffer);
+}
+
+// Subscriber interface
+
+void
+ssr::BinarySubscriber::set_loudspeakers(const Loudspeaker::container_t&) {}
+
+void
+ssr::BinarySubscriber::new_source(id_t id)
+{
+  _send_id(binary::new_source, id);
+}
+
+void
+ssr::BinarySubscriber::delete_source(id_t id)
+{
+  _send_id(binary::delete_source, id);
+}
+
+void
+ssr::BinarySubscriber::delete_all_sources()
+{
+  _send_id(binary::delete_source, 0);
+}
+
+bool
+ssr::BinarySubscriber::set_source_position(id_t id, const Position& position)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::source_position).u32(id).f32(position.x).f32(position.y);
+  out.end();
+  _connection.write_binary(_buffer);
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_position_fixed(id_t, const bool&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_orientation(id_t id
+    , const Orientation& orientation)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::source_orientation).u32(id).f32(orientation.azimuth);
+  out.end();
+  _connection.write_binary(_buffer);
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_gain(id_t id, const float& gain)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::source_gain).u32(id).f32(gain);
+  out.end();
+  _connection.write_binary(_buffer);
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_mute(id_t id, const bool& mute)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::source_mute).u32(id).u8(mute ? 1 : 0);
+  out.end();
+  _connection.write_binary(_buffer);
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_name(id_t, const std::string&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_properties_file(id_t, const std::string&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_model(id_t, const Source::model_t&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_port_name(id_t, const std::string&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_file_name(id_t, const std::string&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_file_channel(id_t, const int&)
+{
+  return true;
+}
+
+bool
+ssr::BinarySubscriber::set_source_file_length(id_t, const long int&)
+{
+  return true;
+}
+
+void
+ssr::BinarySubscriber::set_reference_position(const Position& position)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::reference_position).f32(position.x).f32(position.y);
+  out.end();
+  _connection.write_binary(_buffer);
+}
+
+void
+ssr::BinarySubscriber::set_reference_orientation(
+    const Orientation& orientation)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::reference_orientation).f32(orientation.azimuth);
+  out.end();
+  _connection.write_binary(_buffer);
+}
+
+void
+ssr::BinarySubscriber::set_reference_offset_position(const Position&) {}
+
+void
+ssr::BinarySubscriber::set_reference_offset_orientation(const Orientation&) {}
+
+void
+ssr::BinarySubscriber::set_master_volume(float volume)
+{
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::master_volume).f32(volume);
+  out.end();
+  _connection.write_binary(_buffer);
+}
+
+void
+ssr::BinarySubscriber::set_source_output_levels(id_t, float*, float*) {}
+
+void
+ssr::BinarySubscriber::set_levels(const LevelSnapshot::ptr& levels)
+{
+  // nothing is sent here, see send_levels()
+  std::atomic_store(&_levels, levels);
+}
+
+void
+ssr::BinarySubscriber::set_processing_state(bool) {}
+
+void
+ssr::BinarySubscriber::set_transport_state(
+    const std::pair<bool, jack_nframes_t>& state)
+{
+  // only start/stop is forwarded, the "time" in samples is ignored
+  if (state.first == _transport_state) return;
+  _transport_state = state.first;
+
+  _buffer.clear();
+  auto out = binary::Writer(_buffer);
+  out.begin(binary::transport).u8(state.first ? 1 : 0);
+  out.end();
+  _connection.write_binary(_buffer);
+}
+
+void
+ssr::BinarySubscriber::set_amplitude_reference_distance(float) {}
+
+void
+ssr::BinarySubscriber::set_master_signal_level(float) {}
+
+void
+ssr::BinarySubscriber::set_cpu_load(float) {}
+
+void
+ssr::BinarySubscriber::set_sample_rate(int) {}
+
+bool
+ssr::BinarySubscriber::set_source_signal_level(const id_t, const float&)
+{
+  // levels are sent periodically from the level snapshot, see send_levels()
+  return true;
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
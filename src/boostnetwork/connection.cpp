@@ -31,34 +31,54 @@
 
 #include "connection.h"
 #include "publisher.h"
+#include "binaryprotocol.h"
+#include "ssr_global.h"  // for WARNING()
+
+namespace
+{
+/// If more bytes are waiting to be written, the client is too slow
+const size_t max_queued_bytes = 1 << 20;
+}
 
 /// ctor
 ssr::Connection::Connection(boost::asio::io_service &io_service
-    , Publisher &controller)
+    , Publisher &controller, int update_interval)
   : _socket(io_service)
   , _timer(io_service)
+  , _update_interval(update_interval)
+  , _io_service(io_service)
+  , _queued_bytes(0)
+  , _writing(false)
+  , _flush_pending(false)
+  , _closing(false)
   , _controller(controller)
   , _subscriber(*this)
   , _commandparser(controller)
+  , _requestparser(controller)
+  , _binary(false)
+  , _binary_subscriber(*this)
+  , _binary_commandparser(controller)
 {}
 
 /// dtor
 ssr::Connection::~Connection()
 {
   _controller.unsubscribe(&_subscriber);
+  _controller.unsubscribe(&_binary_subscriber);
   std::cout << "Connection destroyed" << std::endl;
 }
 
 /** Get an instance of Connection.
  * @param io_service 
  * @param controller used to (un)subscribe and get the actual Scene
+ * @param update_interval minimum time between two flushes (in milliseconds)
  * @return ptr to Connection
  **/
 ssr::Connection::pointer
 ssr::Connection::create(boost::asio::io_service &io_service
-    , Publisher& controller)
+    , Publisher& controller, int update_interval)
 {
-  return pointer(new Connection(io_service, controller));
+  return pointer(new Connection(io_service, controller, update_interval));
 }
 
 /** Start the connection.
@@ -83,13 +103,20 @@ ssr::Connection::start()
   start_read();
 
   // intialize the timer
-  _timer.expires_from_now(boost::posix_time::milliseconds(100));
+  this->start_timer();
+}
+
+/// Wait for the next flush.
+void
+ssr::Connection::start_timer()
+{
+  _timer.expires_from_now(boost::posix_time::milliseconds(_update_interval));
   _timer.async_wait(boost::bind(&Connection::timeout_handler, shared_from_this()
         , boost::asio::placeholders::error));
 }
 
-/** Send levels on timeout.
- * - Send level.
+/** Flush on timeout.
+ * - Flush subscriber (or postpone it until all messages are written).
  * - Reset timer.
  * - Wait async.
  * @param e self explanatory
@@ -99,12 +126,31 @@ ssr::Connection::timeout_handler(const boost::system::error_code &e)
 {
   if (e) return;
 
-  _subscriber.send_levels();
+  bool writing;
+  {
+    std::lock_guard<std::mutex> lock(_write_mutex);
+    writing = _writing;
+    // the client is still busy, the flush is done in write_handler()
+    _flush_pending = writing;
+  }
+  if (!writing) this->flush();
 
   // Set timer again.
-  _timer.expires_from_now(boost::posix_time::milliseconds(100));
-  _timer.async_wait(boost::bind(&Connection::timeout_handler, shared_from_this()
-        , boost::asio::placeholders::error));
+  this->start_timer();
+}
+
+/// Send pending changes (and levels) of the active subscriber.
+void
+ssr::Connection::flush()
+{
+  if (_binary)
+  {
+    _binary_subscriber.send_levels();
+  }
+  else
+  {
+    _subscriber.flush();
+  }
 }
 
 /// Start reading from socket. 
@@ -124,13 +170,29 @@ ssr::Connection::read_handler(const boost::system::error_code &error
 {
   if (!error)
   {
+    // The request is parsed directly in the buffer, only if RequestParser
+    // cannot handle it, it is copied to a string and given to CommandParser.
+    // size includes the terminating zero.
+    const char* data = boost::asio::buffer_cast<const char*>(_streambuf.data());
+    if (size > 0 && _requestparser.parse(data, data + size - 1))
+    {
+      _streambuf.consume(size);
+      this->start_read();
+      return;
+    }
+
     std::istream input_stream(&_streambuf);
     std::string  packet_string;
     getline(input_stream, packet_string, '\0');
-    (void) size;
     //cout << "size= " << size << endl;
     //cout << "line: " << packet_string << endl;
 
+    if (packet_string == binary::handshake)
+    {
+      this->switch_to_binary();
+      return;
+    }
+
     _commandparser.parse_cmd(packet_string);
 
     this->start_read();
@@ -141,43 +203,168 @@ ssr::Connection::read_handler(const boost::system::error_code &error
   }
 }
 
+/** Switch to the binary protocol (see binaryprotocol.h).
+ * The handshake is sent back, after that only binary messages are exchanged.
+ * XML updates which were not sent yet are discarded, instead, the whole scene
+ * is sent again in binary messages.
+ **/
+void
+ssr::Connection::switch_to_binary()
+{
+  // no more XML updates after the handshake
+  _controller.unsubscribe(&_subscriber);
+
+  std::string handshake = binary::handshake;
+  this->write(handshake);
+
+  _binary = true;
+  _controller.subscribe(&_binary_subscriber);
+  _controller.replay_scene(&_binary_subscriber);
+
+  // the client may have sent binary messages right after the handshake
+  this->binary_read_handler(boost::system::error_code(), 0);
+}
+
+/// Start reading binary messages from socket.
+void
+ssr::Connection::start_binary_read()
+{
+  boost::asio::async_read(_socket, _streambuf, boost::asio::transfer_at_least(1)
+      , boost::bind(&Connection::binary_read_handler, shared_from_this()
+        , boost::asio::placeholders::error
+        , boost::asio::placeholders::bytes_transferred));
+}
+
+/// Forward all complete binary messages to BinaryCommandParser.
+void
+ssr::Connection::binary_read_handler(const boost::system::error_code &error
+    , size_t size)
+{
+  (void) size;
+
+  if (error)
+  {
+    _timer.cancel();
+    return;
+  }
+
+  const char* data = boost::asio::buffer_cast<const char*>(_streambuf.data());
+  size_t used = _binary_commandparser.parse(data, data + _streambuf.size());
+  _streambuf.consume(used);
+
+  this->start_binary_read();
+}
+
 /** Write to socket.
  * @param writestring: String to be send over the network. 
  **/
 void
 ssr::Connection::write(std::string &writestring)
 {
-  // Create a Copy of this string.
-  // Put into shared_ptr bound to the callback
-  // handler. This is sufficient to make it
-  // be destroyed on exit.
+  this->enqueue(writestring + '\0');
+}
+
+/** Write binary data to socket (without terminating zero).
+ * @param data binary message(s), see binaryprotocol.h
+ **/
+void
+ssr::Connection::write_binary(const std::string& data)
+{
+  this->enqueue(data);
+}
+
+/** Append data to the write queue.
+ * This may be called from any thread, the actual writing is done in the
+ * network thread.
+ * @param data bytes to be written
+ **/
+void
+ssr::Connection::enqueue(std::string data)
+{
+  std::lock_guard<std::mutex> lock(_write_mutex);
+  if (_closing) return;
 
-  boost::shared_ptr<std::string> str_ptr(new std::string(writestring + '\0'));
+  if (!_write_queue.empty() && _queued_bytes + data.size() > max_queued_bytes)
+  {
+    WARNING("Network client doesn't receive messages fast enough, "
+        "closing connection!");
+    _closing = true;
+    _io_service.post(boost::bind(&Connection::close, shared_from_this()));
+    return;
+  }
+
+  _queued_bytes += data.size();
+  _write_queue.push_back(std::move(data));
+  if (!_writing)
+  {
+    _writing = true;
+    _io_service.post(boost::bind(&Connection::start_write, shared_from_this()));
+  }
+}
 
-  boost::asio::async_write(_socket, boost::asio::buffer(*str_ptr)
-      , boost::bind(&Connection::write_handler, shared_from_this(), str_ptr
+/// Write the first message of the queue.
+void
+ssr::Connection::start_write()
+{
+  std::lock_guard<std::mutex> lock(_write_mutex);
+  // references to deque elements stay valid when other elements are added
+  boost::asio::async_write(_socket, boost::asio::buffer(_write_queue.front())
+      , boost::bind(&Connection::write_handler, shared_from_this()
         , boost::asio::placeholders::error
         , boost::asio::placeholders::bytes_transferred));
 }
 
-/** Empty callback handler.  
- *
- * @param str_ptr String passed to Connection::write 
+/** Remove written message from queue and write the next one.
+ * If the queue is empty and a flush was postponed, it is done now.
  * @param error error code
  * @param bytes_transferred self explanatory 
- *
- * @todo Check if we can delete this function.
  **/
 void
-ssr::Connection::write_handler(boost::shared_ptr<std::string> str_ptr
-    , const boost::system::error_code &error, size_t bytes_transferred)
+ssr::Connection::write_handler(const boost::system::error_code &error
+    , size_t bytes_transferred)
 {
-  (void) str_ptr;
-  (void) error;
   (void) bytes_transferred;
-  // Dont do nothing. we could check for error and stuff.
-  // the shared_ptr was just used to keep the string alive and
-  // destroy it now.
+
+  bool flush = false;
+  {
+    std::lock_guard<std::mutex> lock(_write_mutex);
+    _queued_bytes -= _write_queue.front().size();
+    _write_queue.pop_front();
+
+    if (error)
+    {
+      // the read handler will notice as well and stop the timer
+      _write_queue.clear();
+      _queued_bytes = 0;
+      _closing = true;
+      _writing = false;
+      return;
+    }
+
+    if (!_write_queue.empty())
+    {
+      boost::asio::async_write(_socket
+          , boost::asio::buffer(_write_queue.front())
+          , boost::bind(&Connection::write_handler, shared_from_this()
+            , boost::asio::placeholders::error
+            , boost::asio::placeholders::bytes_transferred));
+      return;
+    }
+
+    _writing = false;
+    std::swap(flush, _flush_pending);
+  }
+  if (flush) this->flush();
+}
+
+/// Close the socket, this also stops reading and the timer.
+void
+ssr::Connection::close()
+{
+  boost::system::error_code error;
+  _socket.shutdown(socket_t::shutdown_both, error);
+  _socket.close(error);
+  _timer.cancel();
 }
 
 // Settings for Vim (http://www.vim.org/), please do not remove:
@@ -37,16 +37,27 @@
 #include <boost/asio.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <iostream>
+#include <deque>
+#include <mutex>
 
 #include "networksubscriber.h"
 #include "commandparser.h"
+#include "requestparser.h"
+#include "binarysubscriber.h"
+#include "binarycommandparser.h"
 
 namespace ssr
 {
 
 struct Publisher;
 
-/// Connection class.
+/** Connection class.
+ * Only one message is written to the socket at a time, further messages are
+ * queued.  The NetworkSubscriber is flushed periodically (see
+ * timeout_handler()), but only if the queue is empty.  This way, a slow client
+ * receives fewer (but larger) messages instead of an ever-growing queue.
+ * If the queue grows too large anyway, the connection is closed.
+ **/
 class Connection : public boost::enable_shared_from_this<Connection>
 {
   public:
@@ -55,10 +66,11 @@ class Connection : public boost::enable_shared_from_this<Connection>
     typedef boost::asio::ip::tcp::socket socket_t;
 
     static pointer create(boost::asio::io_service &io_service
-        , Publisher &controller);
+        , Publisher &controller, int update_interval = 100);
 
     void start();
     void write(std::string &writestring);
+    void write_binary(const std::string& data);
 
     /// @return Reference to socket
     socket_t& socket() { return _socket; }
@@ -66,13 +78,23 @@ class Connection : public boost::enable_shared_from_this<Connection>
     ~Connection();
 
   private:
-    Connection(boost::asio::io_service &io_service, Publisher &controller);
+    Connection(boost::asio::io_service &io_service, Publisher &controller
+        , int update_interval);
 
     void start_read();
     void read_handler(const boost::system::error_code &error, size_t size);
-    void write_handler(boost::shared_ptr<std::string> str_ptr
-        , const boost::system::error_code &error, size_t bytes_transferred);
-
+    void start_binary_read();
+    void binary_read_handler(const boost::system::error_code &error
+        , size_t size);
+    void switch_to_binary();
+    void enqueue(std::string data);
+    void start_write();
+    void write_handler(const boost::system::error_code &error
+        , size_t bytes_transferred);
+    void close();
+
+    void flush();
+    void start_timer();
     void timeout_handler(const boost::system::error_code &e);
 
     /// TCP/IP socket
@@ -81,6 +103,18 @@ class Connection : public boost::enable_shared_from_this<Connection>
     boost::asio::streambuf _streambuf;
     /// @see Connection::timeout_handler
     boost::asio::deadline_timer _timer;
+    /// Minimum time between two flushes (in milliseconds)
+    int _update_interval;
+
+    boost::asio::io_service &_io_service;
+    /// Protects the write queue (write() is called from other threads)
+    std::mutex _write_mutex;
+    /// Messages to be written, the first one is currently being written
+    std::deque<std::string> _write_queue;
+    size_t _queued_bytes;  ///< Sum of all message sizes in @c _write_queue
+    bool _writing;  ///< @b true while a message is being written
+    bool _flush_pending;  ///< @b true if a flush is due after writing
+    bool _closing;  ///< @b true if close() has been requested
 
     /// Reference to Controller
     Publisher &_controller;
@@ -88,6 +122,13 @@ class Connection : public boost::enable_shared_from_this<Connection>
     NetworkSubscriber _subscriber;
     /// Commandparser obj 
     CommandParser _commandparser;
+    /// Fast path for the most frequent requests
+    RequestParser _requestparser;
+
+    /// @b true after the client requested the binary protocol
+    bool _binary;
+    BinarySubscriber _binary_subscriber;
+    BinaryCommandParser _binary_commandparser;
 };
 
 }  // namespace ssr
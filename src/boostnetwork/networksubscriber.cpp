@@ -27,6 +27,8 @@
 /// @file
 /// NetworkSubscriber class (implementation). 
 
+#include <algorithm>  // for std::equal()
+
 #include "networksubscriber.h"
 #include "apf/stringtools.h"
 #include "apf/math.h" // for linear2dB()
@@ -34,34 +36,140 @@
 
 using apf::str::A2S;
 
-// temporary hack:
-//static bool previous_state = false;
+namespace
+{
+
+/// Replace characters which are not allowed in XML attribute values.
+std::string escape_attribute(const std::string& input)
+{
+  std::string result;
+  for (auto ch: input)
+  {
+    switch (ch)
+    {
+      case '<': result += "&lt;"; break;
+      case '>': result += "&gt;"; break;
+      case '&': result += "&amp;"; break;
+      case '\'': result += "&apos;"; break;
+      case '"': result += "&quot;"; break;
+      default: result += ch;
+    }
+  }
+  return result;
+}
+
+}  // unnamed namespace
 
 ssr::NetworkSubscriber::NetworkSubscriber(Connection &connection)
   : _connection(connection)
-  , _master_level(0.0)
+  , _transport_state(false)
 {}
 
 ssr::NetworkSubscriber::~NetworkSubscriber() {}
 
+/** Send a message right away.
+ * All pending changes are sent before.
+ * @param str complete XML message
+ **/
 void
 ssr::NetworkSubscriber::update_all_clients(std::string str)
 {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _send_pending();
   _connection.write(str);
 }
 
+/** Send all pending changes and the levels which have changed since the last
+ * flush as one message.
+ * This is called periodically by the Connection, but only if the previous
+ * messages have been written to the socket.
+ **/
+void
+ssr::NetworkSubscriber::flush()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::string ms;
+  _append_pending(ms);
+  _append_levels(ms);
+  if (ms.empty()) return;
+  ms = "<update>" + ms + "</update>";
+  _connection.write(ms);
+}
+
+/// Store a changed property, replacing a previous value (if any).
+/// @param id source ID, 0 for other properties
+/// @param property which property
+/// @param element XML element (without the surrounding @c update element)
+void
+ssr::NetworkSubscriber::_update(id_t id, property_t property
+    , std::string element)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _pending[key_t(id, property)].swap(element);
+}
+
+/// Send pending changes (if any).  @pre @c _mutex is locked.
+void
+ssr::NetworkSubscriber::_send_pending()
+{
+  std::string ms;
+  _append_pending(ms);
+  if (ms.empty()) return;
+  ms = "<update>" + ms + "</update>";
+  _connection.write(ms);
+}
+
+/// Move pending changes to @p ms.  @pre @c _mutex is locked.
 void
-ssr::NetworkSubscriber::send_levels()
+ssr::NetworkSubscriber::_append_pending(std::string& ms)
 {
-  source_level_map_t::iterator i;
-  std::string ms = "<update>";
-  for (i=_source_levels.begin(); i!=_source_levels.end(); i++)
+  for (const auto& item: _pending)
   {
-    ms += ("<source id='" + A2S((*i).first) + "' level='"
-        + A2S(apf::math::linear2dB((*i).second)) + "'/>");
+    ms += item.second;
   }
-  ms += "</update>";
-  update_all_clients(ms);
+  _pending.clear();
+}
+
+/// Append levels which changed since the last call.  @pre @c _mutex is locked.
+void
+ssr::NetworkSubscriber::_append_levels(std::string& ms)
+{
+  auto levels = std::atomic_load(&_levels);
+  if (!levels || levels == _levels_sent) return;
+
+  for (size_t i = 0; i < levels->ids.size(); ++i)
+  {
+    if (_levels_sent)
+    {
+      size_t j = _levels_sent->find(levels->ids[i]);
+      if (j != _levels_sent->ids.size()
+          && levels->source_levels[i] == _levels_sent->source_levels[j]
+          && (levels->outputs == 0 || (levels->outputs == _levels_sent->outputs
+              && std::equal(levels->output_levels_of(i)
+                , levels->output_levels_of(i) + levels->outputs
+                , _levels_sent->output_levels_of(j)))))
+      {
+        continue;  // nothing has changed
+      }
+    }
+
+    ms += "<source id='" + A2S(levels->ids[i]) + "' level='"
+      + A2S(apf::math::linear2dB(levels->source_levels[i])) + "'";
+    if (levels->outputs != 0)
+    {
+      const float* first = levels->output_levels_of(i);
+      const float* last = first + levels->outputs;
+      ms += " output_level='" + A2S(*first++);
+      for ( ; first != last; ++first)
+      {
+        ms += " ";
+        ms += A2S(*first);
+      }
+      ms += "'";
+    }
+    ms += "/>";
+  }
+  _levels_sent = levels;
 }
 
 // Subscriber interface
@@ -79,12 +187,15 @@ ssr::NetworkSubscriber::new_source(id_t id)
 {
   std::string ms = "<update><source id='" + A2S(id) + "'/></update>";
   update_all_clients(ms);
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  // the ID may have been used before, all levels are sent again
+  _levels_sent.reset();
 }
 
 void
 ssr::NetworkSubscriber::delete_source(id_t id)
 {
-  _source_levels.erase(id);
   std::string ms = "<update><delete><source id='" + A2S(id) + "' />" +
     + "</delete></update>";
   update_all_clients(ms);
@@ -93,7 +204,6 @@ ssr::NetworkSubscriber::delete_source(id_t id)
 void
 ssr::NetworkSubscriber::delete_all_sources()
 {
-  _source_levels.clear();
   std::string ms = "<update><delete><source id='0'/></delete></update>";
   update_all_clients(ms);
 }
@@ -101,18 +211,16 @@ ssr::NetworkSubscriber::delete_all_sources()
 bool
 ssr::NetworkSubscriber::set_source_position(id_t id, const Position& position)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "'><position x='"
-    + A2S(position.x) + "' y='" + A2S(position.y) + "'/></source></update>";
-  update_all_clients(ms);
+  _update(id, source_position, "<source id='" + A2S(id) + "'><position x='"
+      + A2S(position.x) + "' y='" + A2S(position.y) + "'/></source>");
   return true;
 }
 
 bool
 ssr::NetworkSubscriber::set_source_position_fixed(id_t id, const bool& fixed)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "'><position fixed='"
-    + A2S(fixed) + "'/></source></update>";
-  update_all_clients(ms);
+  _update(id, source_position_fixed, "<source id='" + A2S(id)
+      + "'><position fixed='" + A2S(fixed) + "'/></source>");
   return true;
 }
 
@@ -120,27 +228,24 @@ bool
 ssr::NetworkSubscriber::set_source_orientation(id_t id
     , const Orientation& orientation)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "'><orientation azimuth='"
-    + A2S(orientation.azimuth) + "'/></source></update>";
-  update_all_clients(ms);
+  _update(id, source_orientation, "<source id='" + A2S(id)
+      + "'><orientation azimuth='" + A2S(orientation.azimuth) + "'/></source>");
   return true;
 }
 
 bool
 ssr::NetworkSubscriber::set_source_gain(id_t id, const float& gain)
 {
-  std::string ms = "<update><source id='"
-    + A2S(id) + "' volume='" + A2S(apf::math::linear2dB(gain)) + "'/></update>";
-  update_all_clients(ms);
+  _update(id, source_volume, "<source id='" + A2S(id) + "' volume='"
+      + A2S(apf::math::linear2dB(gain)) + "'/>");
   return true;
 }
 
 bool
 ssr::NetworkSubscriber::set_source_mute(id_t id, const bool& mute)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "' mute='" + A2S(mute)
-    + "'/></update>";
-  update_all_clients(ms);
+  _update(id, source_mute, "<source id='" + A2S(id) + "' mute='" + A2S(mute)
+      + "'/>");
   return true;
 }
 
@@ -185,9 +290,8 @@ ssr::NetworkSubscriber::set_source_model(id_t id, const Source::model_t& model)
   tmp = A2S(model);
   if (tmp == "") return false;
 
-  std::string ms = "<update><source id='" + A2S(id) + "' model='" + tmp
-    + "'/></update>";
-  update_all_clients(ms);
+  _update(id, source_model, "<source id='" + A2S(id) + "' model='" + tmp
+      + "'/>");
   return true;
 }
 
@@ -224,64 +328,76 @@ ssr::NetworkSubscriber::set_source_file_channel(id_t id
 bool
 ssr::NetworkSubscriber::set_source_file_length(id_t id, const long int& length)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "' file_length='"
-    + A2S(length) + "'/></update>";
-  update_all_clients(ms);
+  _update(id, source_file_length, "<source id='" + A2S(id) + "' file_length='"
+      + A2S(length) + "'/>");
+  return true;
+}
+
+bool
+ssr::NetworkSubscriber::set_source_error(id_t id, const std::string& message)
+{
+  _update(id, source_error, "<source id='" + A2S(id) + "' error='"
+      + escape_attribute(message) + "'/>");
   return true;
 }
 
 void
 ssr::NetworkSubscriber::set_reference_position(const Position& position)
 {
-  std::string ms = "<update><reference><position x='" + A2S(position.x)
-    + "' y='" + A2S(position.y) + "'/></reference></update>";
-  update_all_clients(ms);
+  _update(0, reference_position, "<reference><position x='" + A2S(position.x)
+      + "' y='" + A2S(position.y) + "'/></reference>");
 }
 
 void
 ssr::NetworkSubscriber::set_reference_orientation(const Orientation& orientation)
 {
-  std::string ms = "<update><reference><orientation azimuth='"
-    + A2S(orientation.azimuth) + "'/></reference></update>";
-  update_all_clients(ms);
+  _update(0, reference_orientation, "<reference><orientation azimuth='"
+      + A2S(orientation.azimuth) + "'/></reference>");
 }
 
 void
 ssr::NetworkSubscriber::set_reference_offset_position(const Position& position)
 {
-  std::string ms = "<update><reference_offset><position x='" + A2S(position.x)
-    + "' y='" + A2S(position.y) + "'/></reference_offset></update>";
-  update_all_clients(ms);
+  _update(0, reference_offset_position, "<reference_offset><position x='"
+      + A2S(position.x) + "' y='" + A2S(position.y)
+      + "'/></reference_offset>");
 }
 
 void
 ssr::NetworkSubscriber::set_reference_offset_orientation(const Orientation& orientation)
 {
-  std::string ms = "<update><reference_offset><orientation azimuth='"
-    + A2S(orientation.azimuth) + "'/></reference_offset></update>";
-  update_all_clients(ms);
+  _update(0, reference_offset_orientation
+      , "<reference_offset><orientation azimuth='" + A2S(orientation.azimuth)
+      + "'/></reference_offset>");
 }
 
 void
 ssr::NetworkSubscriber::set_master_volume(float volume)
 {
-  std::string ms = "<update><scene volume='" + A2S(apf::math::linear2dB(volume))    + "'/></update>";
-  update_all_clients(ms);
+  _update(0, master_volume, "<scene volume='"
+      + A2S(apf::math::linear2dB(volume)) + "'/>");
 }
 
 void
 ssr::NetworkSubscriber::set_source_output_levels(id_t id, float* first
     , float* last)
 {
-  std::string ms = "<update><source id='" + A2S(id) + "' output_level='";
+  std::string ms = "<source id='" + A2S(id) + "' output_level='";
 
-  for ( ; first != last; ++first)
+  for (float* i = first; i != last; ++i)
   {
-    ms += A2S(*first);
-    ms += " ";
+    if (i != first) ms += " ";
+    ms += A2S(*i);
   }
-  ms += "'/></update>";
-  update_all_clients(ms);
+  ms += "'/>";
+  _update(id, source_output_level, ms);
+}
+
+void
+ssr::NetworkSubscriber::set_levels(const LevelSnapshot::ptr& levels)
+{
+  // nothing is sent here, see flush()
+  std::atomic_store(&_levels, levels);
 }
 
 void
@@ -296,14 +412,13 @@ ssr::NetworkSubscriber::set_transport_state(
 {
   // temporary hack: only start/stop is forwarded, the "time" in samples is
   // ignored
-  static bool previous_state = false;
-  if (previous_state != state.first)
+  if (_transport_state != state.first)
   {
-    std::string ms = "<update><state transport='";
+    std::string ms = "<state transport='";
     ms += state.first?"start":"stop";
-    ms += "'/></update>";
-    update_all_clients(ms);
-    previous_state = state.first;
+    ms += "'/>";
+    _update(0, transport_state, ms);
+    _transport_state = state.first;
   }
 }
 
@@ -327,7 +442,7 @@ ssr::NetworkSubscriber::set_sample_rate(int sr)
 void
 ssr::NetworkSubscriber::set_master_signal_level(float level)
 {
-  _master_level = level;
+  (void)level;
   //std::string ms = "<update><master level='" + A2S(level) +
   //  "'/></update>";
   //update_all_clients(ms);
@@ -336,10 +451,9 @@ ssr::NetworkSubscriber::set_master_signal_level(float level)
 bool
 ssr::NetworkSubscriber::set_source_signal_level(const id_t id, const float& level)
 {
-  _source_levels[id] = level;
-  std::string ms = "<update><source id='" + A2S(id) + "' level='" + A2S(level)
-    + "'/></update>";
-  //update_all_clients(ms);
+  (void)id;
+  (void)level;
+  // levels are sent periodically from the level snapshot, see flush()
   return true;
 }
 
@@ -31,7 +31,9 @@
 #define SSR_NETWORKSUBSCRIBER_H
 
 #include "subscriber.h"
+#include <memory>  // for std::shared_ptr
 #include <map>
+#include <mutex>
 
 namespace ssr
 {
@@ -43,6 +45,12 @@ class Connection;
  * strings (XML-messages in ASDF format) and sends it over a Connection to
  * connected clients.  
  *
+ * Changes of scene properties are not sent right away, they are collected and
+ * sent as one merged message when the Connection calls flush().  If a property
+ * changes several times between two flushes, only the last value is sent.
+ * Messages about new and deleted sources (and the like) are sent immediately,
+ * but only after all pending changes.
+ *
  * @todo There will be a set of flags, which can filter certain
  * events. But this will be done by deriving.
  **/
@@ -55,7 +63,7 @@ class NetworkSubscriber : public Subscriber
     // XXX: This is just to make the old code work.
     //	only sends string to one connection.
     void update_all_clients(std::string str);
-    void send_levels();
+    void flush();
 
     // Subscriber Interface
     virtual void set_loudspeakers(const Loudspeaker::container_t& loudspeakers);
@@ -74,6 +82,7 @@ class NetworkSubscriber : public Subscriber
     virtual bool set_source_file_name(id_t id, const std::string& file_name);
     virtual bool set_source_file_channel(id_t id, const int& file_channel);
     virtual bool set_source_file_length(id_t id, const long int& length);
+    virtual bool set_source_error(id_t id, const std::string& message);
     virtual void set_reference_position(const Position& position);
     virtual void set_reference_orientation(const Orientation& orientation);
     virtual void set_reference_offset_position(const Position& position);
@@ -81,6 +90,7 @@ class NetworkSubscriber : public Subscriber
     virtual void set_master_volume(float volume);
 
     virtual void set_source_output_levels(id_t id, float* first, float* last);
+    virtual void set_levels(const LevelSnapshot::ptr& levels);
     virtual void set_processing_state(bool state);
     //virtual void set_transport_state(JackClient::State state);
     virtual void set_transport_state(
@@ -93,11 +103,46 @@ class NetworkSubscriber : public Subscriber
     virtual bool set_source_signal_level(const id_t id, const float& level);
 
   private:
+    /// Properties which are merged between two flushes
+    enum property_t
+    {
+      source_position
+      , source_position_fixed
+      , source_orientation
+      , source_volume
+      , source_mute
+      , source_model
+      , source_file_length
+      , source_error
+      , source_output_level
+      , reference_position
+      , reference_orientation
+      , reference_offset_position
+      , reference_offset_orientation
+      , master_volume
+      , transport_state
+    };
+
+    /// ID (0 if not source-related) and property
+    typedef std::pair<id_t, property_t> key_t;
+
+    void _update(id_t id, property_t property, std::string element);
+    void _send_pending();
+    void _append_pending(std::string& ms);
+    void _append_levels(std::string& ms);
+
     Connection &_connection;
 
-    typedef std::map<id_t,float> source_level_map_t;
-    source_level_map_t           _source_levels;
-    float                        _master_level;
+    /// protects everything below, and keeps the order of written messages
+    std::mutex _mutex;
+    /// XML elements which were not yet sent
+    std::map<key_t, std::string> _pending;
+
+    /// most recent levels, written by the query thread, read by flush()
+    LevelSnapshot::ptr _levels;
+    /// levels of the last flush, only changed levels are sent
+    LevelSnapshot::ptr _levels_sent;
+    bool _transport_state;
 };
 
 }  // namespace ssr
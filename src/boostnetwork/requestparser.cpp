@@ -0,0 +1,591 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// RequestParser class (implementation).
+
+#include <cstdlib>  // for std::strtof(), std::strtoul()
+#include <cstring>  // for std::strlen(), std::strncmp()
+
+#include "requestparser.h"
+#include "publisher.h"
+#include "apf/math.h"  // for dB2linear()
+
+namespace
+{
+
+bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_name_char(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+    || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == ':' || c == '.';
+}
+
+}  // anonymous namespace
+
+bool
+ssr::RequestParser::Token::operator==(const char* str) const
+{
+  size_t size = static_cast<size_t>(last - first);
+  return std::strlen(str) == size && std::strncmp(first, str, size) == 0;
+}
+
+bool
+ssr::RequestParser::Token::operator==(const Token& other) const
+{
+  return last - first == other.last - other.first
+    && std::strncmp(first, other.first, static_cast<size_t>(last - first)) == 0;
+}
+
+/// Value of an attribute (empty if it doesn't exist)
+ssr::RequestParser::Token
+ssr::RequestParser::Tag::get(const char* attribute) const
+{
+  for (size_t i = 0; i < attributes; ++i)
+  {
+    if (attribute_names[i] == attribute) return attribute_values[i];
+  }
+  return Token();
+}
+
+/// Check if there are only attributes from a null-terminated list
+bool
+ssr::RequestParser::Tag::only(const char* const* allowed) const
+{
+  for (size_t i = 0; i < attributes; ++i)
+  {
+    const char* const* name = allowed;
+    while (*name && !(attribute_names[i] == *name)) ++name;
+    if (!*name) return false;
+  }
+  return true;
+}
+
+ssr::RequestParser::RequestParser(Publisher& controller)
+  : _controller(controller)
+  , _pos(0)
+  , _end(0)
+  , _size(0)
+{}
+
+/** Parse a request and map it to the Controller.
+ * @param first begin of the request (without terminating zero)
+ * @param last end of the request
+ * @return @b true if the request was executed, @b false if it has to be
+ *   given to CommandParser (nothing was executed in this case).
+ **/
+bool
+ssr::RequestParser::parse(const char* first, const char* last)
+{
+  _pos = first;
+  _end = last;
+  _size = 0;
+
+  Tag request;
+  _skip_space();
+  if (!_open_tag(request) || !(request.name == "request")
+      || request.attributes != 0)
+  {
+    return false;
+  }
+
+  if (!request.empty)
+  {
+    for (;;)
+    {
+      _skip_space();
+      if (_at_close_tag()) break;
+
+      Tag tag;
+      if (!_open_tag(tag)) return false;
+
+      bool success = false;
+      if (tag.name == "source") success = _parse_source(tag);
+      else if (tag.name == "reference") success = _parse_reference(tag, false);
+      else if (tag.name == "reference_offset")
+      {
+        success = _parse_reference(tag, true);
+      }
+      else if (tag.name == "delete") success = _parse_delete(tag);
+      else if (tag.name == "scene") success = _parse_scene(tag);
+      else if (tag.name == "state") success = _parse_state(tag);
+
+      if (!success) return false;
+    }
+    if (!_close_tag("request")) return false;
+  }
+
+  _skip_space();
+  if (_pos != _end) return false;
+
+  // Only now that the whole request is known to be valid, it is executed.
+  for (size_t i = 0; i < _size; ++i)
+  {
+    _execute(_commands[i]);
+  }
+  return true;
+}
+
+bool
+ssr::RequestParser::_parse_source(const Tag& tag)
+{
+  static const char* const allowed[] = { "id", "volume", "mute", 0 };
+
+  id_t id;
+  if (!tag.only(allowed) || !_convert(tag.get("id"), id)) return false;
+
+  if (!tag.empty)
+  {
+    for (;;)
+    {
+      _skip_space();
+      if (_at_close_tag()) break;
+
+      Tag inner;
+      if (!_open_tag(inner) || !inner.empty) return false;
+
+      if (inner.name == "position")
+      {
+        static const char* const position_allowed[] = { "x", "y", "fixed", 0 };
+        if (!inner.only(position_allowed)) return false;
+
+        Token x_str = inner.get("x"), y_str = inner.get("y");
+        if (!x_str.empty() || !y_str.empty())
+        {
+          float x, y;
+          if (!_convert(x_str, x) || !_convert(y_str, y)
+              || !_add(Command::source_position, id, x, y))
+          {
+            return false;
+          }
+        }
+
+        Token fixed_str = inner.get("fixed");
+        if (!fixed_str.empty())
+        {
+          bool fixed;
+          if (!_convert(fixed_str, fixed)
+              || !_add(Command::source_position_fixed, id, 0, 0, fixed))
+          {
+            return false;
+          }
+        }
+      }
+      else if (inner.name == "orientation")
+      {
+        static const char* const orientation_allowed[] = { "azimuth", 0 };
+        float azimuth;
+        if (!inner.only(orientation_allowed)
+            || !_convert(inner.get("azimuth"), azimuth)
+            || !_add(Command::source_orientation, id, azimuth))
+        {
+          return false;
+        }
+      }
+      else return false;
+    }
+    if (!_close_tag("source")) return false;
+  }
+
+  // attributes are handled after the child elements (like in CommandParser)
+
+  Token volume_str = tag.get("volume");
+  if (!volume_str.empty())
+  {
+    float volume;
+    if (!_convert(volume_str, volume)
+        || !_add(Command::source_gain, id, apf::math::dB2linear(volume)))
+    {
+      return false;
+    }
+  }
+
+  Token mute_str = tag.get("mute");
+  if (!mute_str.empty())
+  {
+    bool mute;
+    if (!_convert(mute_str, mute)
+        || !_add(Command::source_mute, id, 0, 0, mute))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+ssr::RequestParser::_parse_reference(const Tag& tag, bool offset)
+{
+  if (tag.attributes != 0) return false;
+  if (tag.empty) return true;
+
+  for (;;)
+  {
+    _skip_space();
+    if (_at_close_tag()) break;
+
+    Tag inner;
+    if (!_open_tag(inner) || !inner.empty) return false;
+
+    if (inner.name == "position")
+    {
+      static const char* const allowed[] = { "x", "y", 0 };
+      float x, y;
+      if (!inner.only(allowed)
+          || !_convert(inner.get("x"), x) || !_convert(inner.get("y"), y)
+          || !_add(offset ? Command::reference_offset_position
+            : Command::reference_position, 0, x, y))
+      {
+        return false;
+      }
+    }
+    else if (inner.name == "orientation")
+    {
+      static const char* const allowed[] = { "azimuth", 0 };
+      float azimuth;
+      if (!inner.only(allowed) || !_convert(inner.get("azimuth"), azimuth)
+          || !_add(offset ? Command::reference_offset_orientation
+            : Command::reference_orientation, 0, azimuth))
+      {
+        return false;
+      }
+    }
+    else return false;
+  }
+  return _close_tag(offset ? "reference_offset" : "reference");
+}
+
+bool
+ssr::RequestParser::_parse_delete(const Tag& tag)
+{
+  if (tag.attributes != 0) return false;
+  if (tag.empty) return true;
+
+  for (;;)
+  {
+    _skip_space();
+    if (_at_close_tag()) break;
+
+    static const char* const allowed[] = { "id", 0 };
+    Tag inner;
+    id_t id;
+    if (!_open_tag(inner) || !inner.empty || !(inner.name == "source")
+        || !inner.only(allowed) || !_convert(inner.get("id"), id)
+        || !_add(Command::delete_source, id))
+    {
+      return false;
+    }
+  }
+  return _close_tag("delete");
+}
+
+bool
+ssr::RequestParser::_parse_scene(const Tag& tag)
+{
+  // loading and saving are left to CommandParser
+  static const char* const allowed[] = { "volume", "clear", 0 };
+  if (!tag.empty || !tag.only(allowed)) return false;
+
+  Token volume_str = tag.get("volume");
+  if (!volume_str.empty())
+  {
+    float volume;
+    if (!_convert(volume_str, volume)
+        || !_add(Command::master_volume, 0, apf::math::dB2linear(volume)))
+    {
+      return false;
+    }
+  }
+
+  Token clear_str = tag.get("clear");
+  if (!clear_str.empty())
+  {
+    bool clear;
+    if (!_convert(clear_str, clear)) return false;
+    if (clear && !_add(Command::clear_scene)) return false;
+  }
+  return true;
+}
+
+bool
+ssr::RequestParser::_parse_state(const Tag& tag)
+{
+  // seeking is left to CommandParser
+  static const char* const allowed[]
+    = { "processing", "transport", "tracker", 0 };
+  if (!tag.empty || !tag.only(allowed)) return false;
+
+  Token processing = tag.get("processing");
+  if (processing == "start") _add(Command::start_processing);
+  else if (processing == "stop") _add(Command::stop_processing);
+  else if (!processing.empty()) return false;
+
+  Token transport = tag.get("transport");
+  if (transport == "start") _add(Command::transport_start);
+  else if (transport == "stop") _add(Command::transport_stop);
+  else if (transport == "rewind") _add(Command::transport_rewind);
+  else if (!transport.empty()) return false;
+
+  Token tracker = tag.get("tracker");
+  if (tracker == "reset") _add(Command::calibrate_client);
+  else if (!tracker.empty()) return false;
+
+  // if the command list was full, _add() has set _size beyond the maximum
+  return _size <= _max_commands;
+}
+
+/// Parse an opening (or self-closing) tag with its attributes.
+bool
+ssr::RequestParser::_open_tag(Tag& tag)
+{
+  if (_pos == _end || *_pos != '<') return false;
+  ++_pos;
+  if (!_token(tag.name)) return false;
+
+  tag.attributes = 0;
+  for (;;)
+  {
+    _skip_space();
+    if (_pos == _end) return false;
+
+    if (*_pos == '>')
+    {
+      ++_pos;
+      tag.empty = false;
+      return true;
+    }
+    if (*_pos == '/')
+    {
+      ++_pos;
+      if (_pos == _end || *_pos != '>') return false;
+      ++_pos;
+      tag.empty = true;
+      return true;
+    }
+
+    if (tag.attributes == Tag::max_attributes) return false;
+    Token& name = tag.attribute_names[tag.attributes];
+    Token& value = tag.attribute_values[tag.attributes];
+
+    if (!_token(name)) return false;
+    _skip_space();
+    if (_pos == _end || *_pos != '=') return false;
+    ++_pos;
+    _skip_space();
+    if (_pos == _end || (*_pos != '"' && *_pos != '\'')) return false;
+    char quote = *_pos++;
+    value.first = _pos;
+    while (_pos != _end && *_pos != quote)
+    {
+      // entities and special characters are left to CommandParser
+      if (*_pos == '&' || *_pos == '<') return false;
+      ++_pos;
+    }
+    if (_pos == _end) return false;
+    value.last = _pos++;
+
+    // attributes may only appear once
+    for (size_t i = 0; i < tag.attributes; ++i)
+    {
+      if (tag.attribute_names[i] == name) return false;
+    }
+    ++tag.attributes;
+  }
+}
+
+bool
+ssr::RequestParser::_at_close_tag()
+{
+  return _end - _pos >= 2 && _pos[0] == '<' && _pos[1] == '/';
+}
+
+bool
+ssr::RequestParser::_close_tag(const char* name)
+{
+  if (!_at_close_tag()) return false;
+  _pos += 2;
+  Token token;
+  if (!_token(token) || !(token == name)) return false;
+  _skip_space();
+  if (_pos == _end || *_pos != '>') return false;
+  ++_pos;
+  return true;
+}
+
+bool
+ssr::RequestParser::_token(Token& token)
+{
+  token.first = _pos;
+  while (_pos != _end && is_name_char(*_pos)) ++_pos;
+  token.last = _pos;
+  return !token.empty();
+}
+
+void
+ssr::RequestParser::_skip_space()
+{
+  while (_pos != _end && is_space(*_pos)) ++_pos;
+}
+
+/// Store a command for later execution.
+/// @return @b false if there are too many commands
+bool
+ssr::RequestParser::_add(Command::type_t type, id_t id, float x, float y
+    , bool flag)
+{
+  if (_size >= _max_commands)
+  {
+    _size = _max_commands + 1;
+    return false;
+  }
+  Command& command = _commands[_size++];
+  command.type = type;
+  command.id = id;
+  command.x = x;
+  command.y = y;
+  command.flag = flag;
+  return true;
+}
+
+void
+ssr::RequestParser::_execute(const Command& command)
+{
+  switch (command.type)
+  {
+    case Command::source_position:
+      _controller.set_source_position(command.id
+          , Position(command.x, command.y));
+      break;
+    case Command::source_position_fixed:
+      _controller.set_source_position_fixed(command.id, command.flag);
+      break;
+    case Command::source_orientation:
+      _controller.set_source_orientation(command.id, Orientation(command.x));
+      break;
+    case Command::source_gain:
+      _controller.set_source_gain(command.id, command.x);
+      break;
+    case Command::source_mute:
+      _controller.set_source_mute(command.id, command.flag);
+      break;
+    case Command::delete_source:
+      _controller.delete_source(command.id);
+      break;
+    case Command::reference_position:
+      _controller.set_reference_position(Position(command.x, command.y));
+      break;
+    case Command::reference_orientation:
+      _controller.set_reference_orientation(Orientation(command.x));
+      break;
+    case Command::reference_offset_position:
+      _controller.set_reference_offset_position(
+          Position(command.x, command.y));
+      break;
+    case Command::reference_offset_orientation:
+      _controller.set_reference_offset_orientation(Orientation(command.x));
+      break;
+    case Command::master_volume:
+      _controller.set_master_volume(command.x);
+      break;
+    case Command::clear_scene:
+      _controller.delete_all_sources();
+      break;
+    case Command::start_processing:
+      _controller.start_processing();
+      break;
+    case Command::stop_processing:
+      _controller.stop_processing();
+      break;
+    case Command::transport_start:
+      _controller.transport_start();
+      break;
+    case Command::transport_stop:
+      _controller.transport_stop();
+      break;
+    case Command::transport_rewind:
+      _controller.transport_locate(0);
+      break;
+    case Command::calibrate_client:
+      _controller.calibrate_client();
+      break;
+  }
+}
+
+/// Convert a number, surrounding whitespace is allowed.
+bool
+ssr::RequestParser::_convert(const Token& token, float& value)
+{
+  if (token.empty()) return false;
+  // The character after the token is a quote, so strtof() stops there.
+  char* end;
+  float result = std::strtof(token.first, &end);
+  if (end == token.first) return false;
+  while (end != token.last && is_space(*end)) ++end;
+  if (end != token.last) return false;
+  value = result;
+  return true;
+}
+
+bool
+ssr::RequestParser::_convert(const Token& token, id_t& value)
+{
+  const char* first = token.first;
+  while (first != token.last && is_space(*first)) ++first;
+  if (first == token.last || *first < '0' || *first > '9') return false;
+  char* end;
+  unsigned long result = std::strtoul(first, &end, 10);
+  while (end != token.last && is_space(*end)) ++end;
+  if (end != token.last) return false;
+  value = static_cast<id_t>(result);
+  return true;
+}
+
+/// Convert "1", "0", "true" or "false".
+bool
+ssr::RequestParser::_convert(const Token& token, bool& value)
+{
+  Token trimmed = token;
+  while (trimmed.first != trimmed.last && is_space(*trimmed.first))
+  {
+    ++trimmed.first;
+  }
+  while (trimmed.first != trimmed.last && is_space(trimmed.last[-1]))
+  {
+    --trimmed.last;
+  }
+  if (trimmed == "1" || trimmed == "true") value = true;
+  else if (trimmed == "0" || trimmed == "false") value = false;
+  else return false;
+  return true;
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// RequestParser class (definition).
+
+#ifndef SSR_REQUESTPARSER_H
+#define SSR_REQUESTPARSER_H
+
+#include <cstddef>  // for size_t
+
+#include "ssr_global.h"  // for id_t
+
+namespace ssr
+{
+
+struct Publisher;
+
+/** Fast parser for the most frequent XML requests.
+ * The request is parsed in place (without creating a DOM tree and without
+ * allocating memory) and mapped directly to the Controller.
+ *
+ * Only a subset of what CommandParser accepts is handled: source position,
+ * orientation, volume and mute, reference (offset) position and orientation,
+ * deleting sources, master volume, clearing the scene and the simple state
+ * requests.  If anything else (or anything malformed) is found, nothing is
+ * executed and @b false is returned, the request should then be given to
+ * CommandParser.
+ **/
+class RequestParser
+{
+  public:
+    explicit RequestParser(Publisher& controller);
+
+    bool parse(const char* first, const char* last);
+
+  private:
+    struct Command
+    {
+      enum type_t
+      {
+        source_position
+        , source_position_fixed
+        , source_orientation
+        , source_gain
+        , source_mute
+        , delete_source
+        , reference_position
+        , reference_orientation
+        , reference_offset_position
+        , reference_offset_orientation
+        , master_volume
+        , clear_scene
+        , start_processing
+        , stop_processing
+        , transport_start
+        , transport_stop
+        , transport_rewind
+        , calibrate_client
+      } type;
+      id_t id;
+      float x, y;
+      bool flag;
+    };
+
+    /// Range of characters (not zero-terminated)
+    struct Token
+    {
+      Token() : first(0), last(0) {}
+      bool operator==(const char* str) const;
+      bool operator==(const Token& other) const;
+      bool empty() const { return first == last; }
+      const char* first;
+      const char* last;
+    };
+
+    struct Tag
+    {
+      static const size_t max_attributes = 8;
+
+      Token get(const char* attribute) const;
+      bool only(const char* const* allowed) const;
+
+      Token name;
+      Token attribute_names[max_attributes];
+      Token attribute_values[max_attributes];
+      size_t attributes;
+      bool empty;  ///< self-closing tag
+    };
+
+    bool _parse_source(const Tag& tag);
+    bool _parse_reference(const Tag& tag, bool offset);
+    bool _parse_delete(const Tag& tag);
+    bool _parse_scene(const Tag& tag);
+    bool _parse_state(const Tag& tag);
+
+    bool _open_tag(Tag& tag);
+    bool _close_tag(const char* name);
+    bool _at_close_tag();
+    bool _token(Token& token);
+    void _skip_space();
+
+    bool _add(Command::type_t type, id_t id = 0, float x = 0.0f
+        , float y = 0.0f, bool flag = false);
+    void _execute(const Command& command);
+
+    static bool _convert(const Token& token, float& value);
+    static bool _convert(const Token& token, id_t& value);
+    static bool _convert(const Token& token, bool& value);
+
+    Publisher& _controller;
+
+    const char* _pos;
+    const char* _end;
+
+    static const size_t _max_commands = 32;
+    Command _commands[_max_commands];
+    size_t _size;
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -50,7 +50,7 @@ struct Publisher;
 class Server
 {
   public:
-    Server(Publisher& controller, int port);
+    Server(Publisher& controller, int port, int update_interval = 100);
     ~Server();
     void start();
     void stop();
@@ -65,6 +65,7 @@ class Server
     boost::asio::io_service _io_service;
     boost::asio::ip::tcp::acceptor _acceptor;
     boost::thread *_network_thread;
+    int _update_interval;  ///< see Connection
 };
 
 }  // namespace ssr
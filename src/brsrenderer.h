@@ -33,9 +33,10 @@
 #include "rendererbase.h"
 
 #include "apf/convolver.h"  // for apf::conv::*
-#include "apf/sndfiletools.h"  // for apf::load_sndfile
 #include "apf/combine_channels.h"  // for apf::raised_cosine_fade, ...
 
+#include "ircache.h"
+
 namespace ssr
 {
 
@@ -47,7 +48,7 @@ class BrsRenderer : public SourceToOutput<BrsRenderer, RendererBase>
   public:
     static const char* name() { return "BrsRenderer"; }
 
-    using Input = _base::DefaultInput;
+    using Input = _base::Input;
     class Source;
     struct SourceChannel;
     class Output;
@@ -56,10 +57,14 @@ class BrsRenderer : public SourceToOutput<BrsRenderer, RendererBase>
     BrsRenderer(const apf::parameter_map& params)
       : _base(params)
       , _fade(this->block_size())
+      , _ir_cache(this->params.get("ir_cache_dir", ""))
     {}
 
     void load_reproduction_setup();
 
+    /// Wait for the IRs of all sources, see IrCache::wait()
+    void wait_for_background_loads() { _ir_cache.wait(); }
+
     APF_PROCESS(BrsRenderer, _base)
     {
       this->_process_list(_source_list);
@@ -67,6 +72,7 @@ class BrsRenderer : public SourceToOutput<BrsRenderer, RendererBase>
 
   private:
     apf::raised_cosine_fade<sample_type> _fade;
+    IrCache _ir_cache;
 };
 
 struct BrsRenderer::SourceChannel : apf::has_begin_and_end<sample_type*>
@@ -92,11 +98,15 @@ class BrsRenderer::Source : public _base::Source
       , _weighting_factor(-1.0f)
       , _brtf_index(size_t(-1))
     {
-      SndfileHandle ir_file
-        = apf::load_sndfile(p.get<std::string>("properties_file")
-            , this->parent.sample_rate(), 0);
+      auto filename = p.get<std::string>("properties_file");
+      size_t block_size = this->parent.block_size();
 
-      size_t no_of_channels = ir_file.channels();
+      // Only the header is read here, the actual BRIRs are loaded and
+      // transformed in the background.
+      auto ir_file = IrCache::get_file_info(filename
+          , this->parent.sample_rate());
+
+      size_t no_of_channels = ir_file.channels;
 
       if (no_of_channels % 2 != 0)
       {
@@ -106,43 +116,25 @@ class BrsRenderer::Source : public _base::Source
 
       _angles = no_of_channels / 2;
 
-      size_t size = ir_file.frames();
-
-      using matrix_t = apf::fixed_matrix<sample_type>;
-
-      auto ir_data = matrix_t(size, no_of_channels);
-
-      // TODO: check return value?
-      ir_file.readf(ir_data.data(), size);
-
-      size_t block_size = this->parent.block_size();
-
-      auto temp = apf::conv::Transform(block_size);
-
-      size_t partitions = apf::conv::min_partitions(block_size, size);
-
-      _brtf_set.reset(new brtf_set_t(no_of_channels, block_size, partitions));
-
-      auto target = _brtf_set->begin();
-      for (const auto& slice: ir_data.slices)
-      {
-        temp.prepare_filter(slice.begin(), slice.end(), *target++);
-      }
-
-      assert(target == _brtf_set->end());
-
-      _convolver_input.reset(new apf::conv::Input(block_size, partitions));
+      _convolver_input.reset(new apf::conv::Input(block_size
+            , apf::conv::min_partitions(block_size, ir_file.frames)));
 
       this->sourcechannels.reserve(2);
       this->sourcechannels.emplace_back(*_convolver_input);
       this->sourcechannels.emplace_back(*_convolver_input);
+
+      _brtf_slot = this->parent._ir_cache.load_async(filename
+          , this->parent.sample_rate(), block_size, this->parent);
     }
 
     APF_PROCESS(Source, _base::Source)
     {
       _convolver_input->add_block(_input.begin());
 
-      _weighting_factor = this->weighting_factor;
+      _brtf_set = _brtf_slot->filters.get();
+
+      // The source stays silent until its BRIRs are loaded
+      _weighting_factor = _brtf_set.get() ? this->weighting_factor : 0.0f;
 
       float azi = this->parent.state.reference_orientation.get().azimuth;
 
@@ -196,22 +188,27 @@ class BrsRenderer::Source : public _base::Source
 
         if (!queues_empty) this->sourcechannels[i].rotate_queues();
 
-        if (_brtf_index.changed())
+        if (_brtf_set.get() && (_brtf_index.changed() || _brtf_set.changed()))
         {
           // left and right channels are interleaved
-          this->sourcechannels[i].set_filter((*_brtf_set)[2 * _brtf_index + i]);
+          this->sourcechannels[i].set_filter(
+              (*_brtf_set.get())[2 * _brtf_index + i]);
         }
 
         this->sourcechannels[i].crossfade_mode = crossfade_mode;
         this->sourcechannels[i].new_weighting_factor = _weighting_factor;
       }
+      assert(_brtf_set.exactly_one_assignment());
       assert(_brtf_index.exactly_one_assignment());
       assert(_weighting_factor.exactly_one_assignment());
     }
 
+    bool load_failed() const { return _brtf_slot->failed; }
+
   private:
-    using brtf_set_t = apf::fixed_vector<apf::conv::Filter>;
-    std::unique_ptr<brtf_set_t> _brtf_set;
+    // Shared with all other sources using the same BRIR file
+    std::shared_ptr<const IrCache::Slot> _brtf_slot;
+    apf::BlockParameter<const IrCache::filter_set_t*> _brtf_set;
 
     apf::BlockParameter<sample_type> _weighting_factor;
     apf::BlockParameter<size_t> _brtf_index;
@@ -88,9 +88,6 @@ namespace // anonymous
 #endif
 #ifdef ENABLE_RAZOR
       ", Razor AHRS"
-#endif
-#ifdef ENABLE_ECASOUND
-      ", Ecasound"
 #endif
       "\n\n"
       SSR_AUTHORS
@@ -136,6 +133,7 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
   conf.ip_server = false;
 #endif
   conf.server_port = 4711;
+  conf.network_update_interval = 100;
 
   conf.freewheeling = false;
   conf.scene_file_name = "";
@@ -144,6 +142,7 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
   conf.xml_schema = SSR_DATA_DIR"/asdf.xsd";
   conf.audio_recorder_file_name = ""; // default: no recording
   conf.renderer_params.set("threads", 1);  // TODO: obtain reasonable default
+  conf.renderer_params.set("true_peak_metering", false);
 
   conf.input_port_prefix = "system:capture_";
   conf.output_port_prefix = "system:playback_";
@@ -160,6 +159,13 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
   conf.renderer_params.set("hrir_size", 0); // "0" means use all that are there
   conf.renderer_params.set("hrir_file", SSR_DATA_DIR"/default_hrirs.wav");
 
+  // HOME may not be set, e.g. for daemons
+  const char* home = getenv("HOME");
+
+  // for binaural, BRS and generic renderer ("" means no cache files)
+  conf.renderer_params.set("ir_cache_dir"
+      , home ? std::string(home) + "/.ssr/cache" : std::string());
+
   // for AAP renderer
   conf.renderer_params.set("ambisonics_order", 0); // "0" means use maximum that makes sense
   conf.renderer_params.set("in_phase", false);
@@ -170,18 +176,27 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
 
   conf.loop = false; // temporary solution!
 
+  // for ssr-offline
+  conf.offline_script = "";
+  conf.offline_duration = 0.0f;
+  conf.renderer_params.set("sample_rate", 44100);
+  conf.renderer_params.set("block_size", 1024);
+
   // load system-wide config file (Mac)
   load_config_file("/Library/SoundScapeRenderer/ssr.conf",conf);
   // load system-wide config file (Linux et al)
   load_config_file("/etc/ssr.conf",conf);
-  // load user config file (Mac)
-  std::string filename = getenv("HOME");
-  filename += "/Library/SoundScapeRenderer/ssr.conf";
-  load_config_file(filename.c_str(),conf);
-  // load user config file (Linux et al.)
-  filename = getenv("HOME");
-  filename += "/.ssr/ssr.conf";
-  load_config_file(filename.c_str(),conf);
+  if (home)
+  {
+    // load user config file (Mac)
+    std::string filename = home;
+    filename += "/Library/SoundScapeRenderer/ssr.conf";
+    load_config_file(filename.c_str(),conf);
+    // load user config file (Linux et al.)
+    filename = home;
+    filename += "/.ssr/ssr.conf";
+    load_config_file(filename.c_str(),conf);
+  }
 
   const std::string usage_string =
 "\nUSAGE: " + conf.exec_name + " [OPTIONS] <scene-file>"
@@ -200,7 +215,11 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
 "Renderer-specific options:\n"
 "    --hrirs=FILE       Load the HRIRs for binaural renderer from FILE\n"
 "    --hrir-size=VALUE  Maximum IR length (binaural and BRS renderer)\n"
+"    --lod-distance=VALUE Use shorter HRIRs for sources farther away than\n"
+"                       VALUE meters (binaural renderer)\n"
 "    --prefilter=FILE   Load WFS prefilter from FILE\n"
+"    --ir-cache-dir=DIR Store transformed IRs in DIR (default: ~/.ssr/cache)\n"
+"    --no-ir-cache      Don't store transformed IRs on disk\n"
 "-o, --ambisonics-order=VALUE Ambisonics order to use (default: maximum)\n"
 "    --in-phase-rendering     Use in-phase rendering for Ambisonics\n"
 "\n"
@@ -211,24 +230,41 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
 "    --output-prefix=PREFIX   Output port prefix "
                                              "(default: \"system:playback_\")\n"
 "-f, --freewheel        Use JACK in freewheeling mode\n"
+"    --periods-per-block=N    Process N JACK periods at once (default: 1;\n"
+"                             adds a latency of 2*N periods if N > 1)\n"
+"    --source-pool=N    Create N sources (and their ports) in advance and\n"
+"                       re-use them (not for BRS and generic renderer)\n"
+"\n"
+"Offline rendering options (ssr-offline only):\n"
+"    --script=FILE      Apply timestamped requests from FILE\n"
+"    --duration=TIME    Length of the output file (default: longest audio\n"
+"                       file or last request in the script)\n"
+"    --sample-rate=N    Sample rate (default: 44100)\n"
+"    --block-size=N     Block size (default: 1024)\n"
 "\n"
 "General options:\n"
 "-c, --config=FILE      Read configuration from FILE\n"
 "-s, --setup=FILE       Load reproduction setup from FILE\n"
 "    --threads=N        Number of audio threads (default N=1)\n"
 "-r, --record=FILE      Record the audio output of the renderer to FILE\n"
-#ifndef ENABLE_ECASOUND
-"                       (disabled at compile time!)\n"
-#endif
 // TODO: --loop is a temporary option, should rather be done in scene file
 "    --loop             Loop all audio files\n"
 "    --master-volume-correction=VALUE\n"
 "                       Correction of the master volume in dB "
                                                          "(default: 0 dB)\n"
+"    --true-peak-metering Measure true-peak levels (needs more CPU)\n"
+"    --culling-threshold=VALUE\n"
+"                       Don't render sources whose estimated level is below\n"
+"                       VALUE dB (default: render all sources)\n"
+"    --culling-hold=VALUE Time in seconds a source has to stay below the\n"
+"                       culling threshold (default: 1)\n"
 #ifdef ENABLE_IP_INTERFACE
 "-i, --ip-server[=PORT] Start IP server (default on)\n"
 "                       A port can be specified: --ip-server=5555\n"
 "-I, --no-ip-server     Don't start IP server\n"
+"    --update-interval=MS\n"
+"                       Minimum time between two updates sent to a network\n"
+"                       client (default: 100 ms)\n"
 #else
 "-i, --ip-server        Start IP server (not enabled at compile time!)\n"
 "-I, --no-ip-server     Don't start IP server (default)\n"
@@ -283,7 +319,10 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
   {
     {"hrirs",        required_argument, nullptr,  0 },
     {"hrir-size",    required_argument, nullptr,  0 },
+    {"lod-distance", required_argument, nullptr,  0 },
     {"prefilter",    required_argument, nullptr,  0 },
+    {"ir-cache-dir", required_argument, nullptr,  0 },
+    {"no-ir-cache",  no_argument,       nullptr,  0 },
     {"ambisonics-order",required_argument,nullptr,'o'},
     {"in-phase-rendering", no_argument, nullptr,  0 },
 
@@ -291,6 +330,13 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
     {"input-prefix", required_argument, nullptr,  0 },
     {"output-prefix",required_argument, nullptr,  0 },
     {"freewheel",    no_argument,       nullptr, 'f'},
+    {"periods-per-block", required_argument, nullptr, 0},
+    {"source-pool",  required_argument, nullptr,  0 },
+
+    {"script",       required_argument, nullptr,  0 },
+    {"duration",     required_argument, nullptr,  0 },
+    {"sample-rate",  required_argument, nullptr,  0 },
+    {"block-size",   required_argument, nullptr,  0 },
 
     {"config",       required_argument, nullptr, 'c'},
     {"setup",        required_argument, nullptr, 's'},
@@ -298,8 +344,12 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
     {"record",       required_argument, nullptr, 'r'},
     {"loop",         no_argument,       nullptr,  0 },
     {"master-volume-correction", required_argument, nullptr, 0},
+    {"true-peak-metering", no_argument, nullptr,  0 },
+    {"culling-threshold", required_argument, nullptr, 0},
+    {"culling-hold", required_argument, nullptr,  0 },
     {"ip-server",    optional_argument, nullptr, 'i'},
     {"no-ip-server", no_argument,       nullptr, 'I'},
+    {"update-interval", required_argument, nullptr, 0},
     {"gui",          no_argument,       nullptr, 'g'},
     {"no-gui",       no_argument,       nullptr, 'G'},
     {"tracker",      required_argument, nullptr, 't'},
@@ -339,10 +389,22 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
           conf.renderer_params.set("hrir_size", optarg);
           assert(conf.renderer_params.get("hrir_size", 0) >= 1);
         }
+        else if (strcmp("lod-distance", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("lod_distance", optarg);
+        }
         else if (strcmp("prefilter", longopts[longindex].name) == 0)
         {
           conf.renderer_params.set("prefilter_file", optarg);
         }
+        else if (strcmp("ir-cache-dir", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("ir_cache_dir", optarg);
+        }
+        else if (strcmp("no-ir-cache", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("ir_cache_dir", "");
+        }
         else if (strcmp("in-phase-rendering", longopts[longindex].name) == 0)
         {
           conf.renderer_params.set("in_phase", true);
@@ -355,6 +417,42 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
         {
           conf.output_port_prefix = optarg;
         }
+        else if (strcmp("periods-per-block", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("periods_per_block", optarg);
+          if (conf.renderer_params.get("periods_per_block", 0) < 1)
+          {
+            ERROR("Invalid number of periods per block specified!");
+            conf.renderer_params.set("periods_per_block", 1);
+          }
+        }
+        else if (strcmp("source-pool", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("source_pool_size", optarg);
+        }
+        else if (strcmp("script", longopts[longindex].name) == 0)
+        {
+          conf.offline_script = optarg;
+        }
+        else if (strcmp("duration", longopts[longindex].name) == 0)
+        {
+          if (!apf::str::string2time(optarg, conf.offline_duration)
+              || conf.offline_duration < 0.0f)
+          {
+            ERROR("Invalid duration specified!");
+            conf.offline_duration = 0.0f;
+          }
+        }
+        else if (strcmp("sample-rate", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("sample_rate", optarg);
+          assert(conf.renderer_params.get("sample_rate", 0) >= 1);
+        }
+        else if (strcmp("block-size", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("block_size", optarg);
+          assert(conf.renderer_params.get("block_size", 0) >= 1);
+        }
         else if (strcmp("threads", longopts[longindex].name) == 0)
         {
           conf.renderer_params.set("threads", optarg);
@@ -367,6 +465,29 @@ ssr::conf_struct ssr::configuration(int& argc, char* argv[])
         {
           conf.renderer_params.set("master_volume_correction", optarg);
         }
+        else if (strcmp("true-peak-metering", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("true_peak_metering", true);
+        }
+        else if (strcmp("culling-threshold", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("culling_threshold", optarg);
+        }
+        else if (strcmp("culling-hold", longopts[longindex].name) == 0)
+        {
+          conf.renderer_params.set("culling_hold_time", optarg);
+        }
+        else if (strcmp("update-interval", longopts[longindex].name) == 0)
+        {
+#ifdef ENABLE_IP_INTERFACE
+          if (!S2A(optarg, conf.network_update_interval)
+              || conf.network_update_interval <= 0)
+          {
+            ERROR("Invalid network update interval specified!");
+            conf.network_update_interval = 100;
+          }
+#endif
+        }
         else if (strcmp("tracker-port", longopts[longindex].name) == 0)
         {
           conf.tracker_ports = optarg;
@@ -638,6 +759,23 @@ int ssr::load_config_file(const char *filename, conf_struct& conf){
     {
       conf.renderer_params.set("master_volume_correction", value);
     }
+    else if (!strcmp(key, "TRUE_PEAK_METERING"))
+    {
+      if (!strcasecmp(value,"TRUE")) conf.renderer_params.set("true_peak_metering", true);
+      else if (!strcasecmp(value,"true")) conf.renderer_params.set("true_peak_metering", true);
+      else if (!strcasecmp(value,"FALSE")) conf.renderer_params.set("true_peak_metering", false);
+      else if (!strcasecmp(value,"false")) conf.renderer_params.set("true_peak_metering", false);
+      else ERROR("I don't understand the option '" << value
+          << "' for true-peak metering.");
+    }
+    else if (!strcmp(key, "CULLING_THRESHOLD"))
+    {
+      conf.renderer_params.set("culling_threshold", value);
+    }
+    else if (!strcmp(key, "CULLING_HOLD_TIME"))
+    {
+      conf.renderer_params.set("culling_hold_time", value);
+    }
     else if (!strcmp(key, "STANDARD_AMPLITUDE_REFERENCE_DISTANCE"))
     {
       conf.stand_ampl_ref_dist = atof(value);
@@ -694,6 +832,15 @@ int ssr::load_config_file(const char *filename, conf_struct& conf){
       conf.renderer_params.set("hrir_size", value);
       assert(conf.renderer_params.get("hrir_size", 0) >= 1);
     }
+    else if (!strcmp(key, "LOD_DISTANCE"))
+    {
+      conf.renderer_params.set("lod_distance", value);
+    }
+    else if (!strcmp(key, "IR_CACHE_DIR"))
+    {
+      conf.renderer_params.set("ir_cache_dir", value[0] == '\0' ? ""
+          : make_path_relative_to_current_dir(value, filename));
+    }
     else if (!strcmp(key, "AMBISONICS_ORDER"))
     {
       conf.renderer_params.set("ambisonics_order", atoi(value));
@@ -725,6 +872,14 @@ int ssr::load_config_file(const char *filename, conf_struct& conf){
       if (!strcasecmp(value, "yes")) conf.freewheeling = true;
       else conf.freewheeling = false;
     }
+    else if (!strcmp(key, "PERIODS_PER_BLOCK"))
+    {
+      conf.renderer_params.set("periods_per_block", value);
+    }
+    else if (!strcmp(key, "SOURCE_POOL_SIZE"))
+    {
+      conf.renderer_params.set("source_pool_size", value);
+    }
     else if (!strcmp(key, "GUI"))
     {
       if (!strcasecmp(value, "on")) conf.gui = true;
@@ -743,6 +898,17 @@ int ssr::load_config_file(const char *filename, conf_struct& conf){
       conf.server_port = atoi(value);
       #endif
     }
+    else if (!strcmp(key, "NETWORK_UPDATE_INTERVAL"))
+    {
+      #ifdef ENABLE_IP_INTERFACE
+      conf.network_update_interval = atoi(value);
+      if (conf.network_update_interval <= 0)
+      {
+        ERROR("Invalid network update interval specified!");
+        conf.network_update_interval = 100;
+      }
+      #endif
+    }
     else if (!strcmp(key, "VERBOSE"))
     {
       ssr::verbose = atoi(value);
@@ -60,6 +60,8 @@ struct conf_struct
 
   //int number_of_threads;
   int server_port;                      ///< listening port
+  /// minimum time between two updates to a network client (in milliseconds)
+  int network_update_interval;
   /// size of delay line (in samples)
   int wfs_delayline_size;
   /// maximum negative delay (in samples, wfs_initial_delay >= 0)
@@ -71,6 +73,9 @@ struct conf_struct
   bool         in_phase_rendering;
 
   bool loop; ///< temporary solution for looping sound files
+
+  std::string offline_script;           ///< timestamped requests (ssr-offline)
+  float offline_duration;               ///< in seconds, 0 means automatic
 };
 
 conf_struct configuration(int& argc, char* argv[]);
@@ -35,20 +35,25 @@
 #endif
 
 // TODO: move these includes to a more suitable location?
+#ifndef APF_MIMOPROCESSOR_INTERFACE_POLICY
 #include "apf/jack_policy.h"
+#endif
 #include "apf/posix_thread_policy.h"
 
 #define SSR_QUERY_POLICY apf::enable_queries
 
 #include <libxml/xmlsave.h> // temporary hack!
 
+#include <fstream>  // for std::ifstream
+#include <algorithm>  // for std::stable_sort()
+#include <chrono>  // for std::chrono::steady_clock
+#include <map>
+#include <set>
+
 #include "ssr_global.h"
 #include "publisher.h"
-
-#ifdef ENABLE_ECASOUND
-#include "audioplayer.h"
-#include "audiorecorder.h"
-#endif
+#include "diskplayer.h"
+#include "diskrecorder.h"
 
 #include "xmlparser.h"
 #include "configuration.h"
@@ -77,10 +82,13 @@
 
 #include "scene.h"  // for Scene
 #include "rendersubscriber.h"
+#include "asyncsubscriber.h"
 
+#include "boostnetwork/commandparser.h"  // for scripts in render_offline()
 #include "posixpathtools.h"
 #include "apf/math.h"
 #include "apf/stringtools.h"
+#include "apf/container.h"  // for apf::fixed_matrix
 
 using Node = XMLParser::Node; ///< a node of the DOM tree
 
@@ -116,6 +124,76 @@ inline void print_about_message()
   std::cout << about_string << std::endl;
 }
 
+/// Interface policies without realtime constraints (e.g. for offline
+/// rendering) have a static member @c realtime which is @b false.
+template<typename T>
+constexpr auto is_realtime(int) -> decltype(bool(T::realtime))
+{
+  return T::realtime;
+}
+
+template<typename T>
+constexpr bool is_realtime(long)
+{
+  return true;
+}
+
+/// Request (in the format of the network interface) and its time in samples.
+using timed_request = std::pair<size_t, std::string>;
+
+/** Load a script with timestamped requests.
+ * Each line consists of a time (without spaces, see apf::str::string2time())
+ * and a request in the format of the network interface, e.g.
+ * @code
+ * 2.5 <request><source id="1"><position x="1" y="2"/></source></request>
+ * @endcode
+ * Empty lines and lines starting with @c # are ignored.
+ * @param file_name name of the script file
+ * @param sample_rate for converting the times to samples
+ * @param[out] script the requests, sorted by time
+ * @return @b true on success
+ **/
+inline bool load_script(const std::string& file_name, size_t sample_rate
+    , std::vector<timed_request>& script)
+{
+  std::ifstream file(file_name);
+  if (!file)
+  {
+    ERROR("Couldn't open script file \"" << file_name << "\"!");
+    return false;
+  }
+
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(file, line))
+  {
+    ++line_number;
+    auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+
+    auto last = line.find_first_of(" \t", first);
+    float time;
+    if (last == std::string::npos
+        || !apf::str::string2time(line.substr(first, last - first), time)
+        || time < 0.0f)
+    {
+      ERROR("Invalid time in line " << line_number << " of \"" << file_name
+          << "\"!");
+      return false;
+    }
+    script.emplace_back(static_cast<size_t>(time * sample_rate + 0.5f)
+        , line.substr(last + 1));
+  }
+
+  // requests with the same time keep their order
+  std::stable_sort(script.begin(), script.end()
+      , [] (const timed_request& a, const timed_request& b)
+      {
+        return a.first < b.first;
+      });
+  return true;
+}
+
 }  // namespace internal
 
 /** %Controller class.
@@ -133,6 +211,7 @@ class Controller : public Publisher
     virtual ~Controller(); ///< dtor
 
     bool run();
+    bool render_offline();
 
     void set_source_output_levels(id_t id, float* first, float* last);
 
@@ -204,6 +283,7 @@ class Controller : public Publisher
 
     virtual void subscribe(Subscriber* subscriber);
     virtual void unsubscribe(Subscriber* subscriber);
+    virtual void replay_scene(Subscriber* subscriber);
 
     void set_loop_mode(bool loop) { _loop = loop; } ///< temporary solution!
 
@@ -216,13 +296,8 @@ class Controller : public Publisher
 
     class query_state;
 
-#ifdef ENABLE_ECASOUND
     /// load the audio recorder and set it to "record enable" mode.
-    void _load_audio_recorder(const std::string& audio_file_name
-        , const std::string& sample_format = "16"
-        , const std::string& client_name = "recorder"
-        , const std::string& input_prefix = "channel");
-#endif
+    void _load_audio_recorder(const std::string& audio_file_name);
 
     void _start_tracker(const std::string& type, const std::string& ports = "");
 #ifdef ENABLE_GUI
@@ -237,8 +312,12 @@ class Controller : public Publisher
     Scene _scene;
     /// a list of subscribers
     using subscriber_list_t = std::vector<Subscriber*>;
-    /// list of objects that will be notified on all events
+    /// list of objects that will be notified on all events (synchronously)
     subscriber_list_t _subscribers;
+    /// subscribers added with subscribe() are notified in their own thread
+    std::vector<std::unique_ptr<AsyncSubscriber>> _async_subscribers;
+    /// protects _async_subscribers
+    std::mutex _async_subscriber_mutex;
 #ifdef ENABLE_GUI
     std::unique_ptr<QGUI> _gui;
 #endif
@@ -246,10 +325,12 @@ class Controller : public Publisher
     Renderer _renderer;
 
     query_state _query_state;
-#ifdef ENABLE_ECASOUND
-    AudioRecorder::ptr_t    _audio_recorder; ///< pointer to audio recorder
-    AudioPlayer::ptr_t      _audio_player;   ///< pointer to audio player
-#endif
+    DiskPlayer::ptr_t       _disk_player;    ///< plays audio files
+    /// Track of each source which plays an audio file
+    std::map<id_t, DiskPlayer::Track*> _tracks;
+    std::mutex _tracks_mutex;  ///< protects _tracks
+    DiskRecorder::ptr_t     _disk_recorder;  ///< records the output signals
+
     std::string _schema_file_name;           ///< XML Schema
     std::string _input_port_prefix;          ///< e.g. alsa_pcm:capture
 #ifdef ENABLE_IP_INTERFACE
@@ -259,9 +340,6 @@ class Controller : public Publisher
 
     float _stand_ampl_ref_dist;
 
-    /// check if audio player is running and start it if necessary
-    bool _audio_player_is_running();
-
     void _subscribe(Subscriber* const subscriber); ///< add a new subscriber
 
     // TODO: write _unsubscribe() ?
@@ -269,13 +347,21 @@ class Controller : public Publisher
     /// Publishing function.
     /// The first argument is a pointer to a member function of the Subscriber
     /// class, the rest are arguments to said member function.
+    /// The internal subscribers (Scene, RenderSubscriber) are called
+    /// directly, the others only get the call queued.
     // FIXME: THREAD
     template<typename R, typename... FuncArgs, typename... Args>
     inline void _publish(R (Subscriber::*f)(FuncArgs...), Args&&... args)
     {
       for (auto& subscriber: _subscribers)
       {
-        (subscriber->*f)(std::forward<Args>(args)...);  // ignore return value
+        (subscriber->*f)(args...);  // ignore return value
+      }
+
+      std::lock_guard<std::mutex> guard(_async_subscriber_mutex);
+      for (auto& subscriber: _async_subscribers)
+      {
+        (subscriber.get()->*f)(args...);
       }
     }
 
@@ -327,6 +413,16 @@ Controller<Renderer>::Controller(int argc, char* argv[])
 
   _renderer.load_reproduction_setup();
 
+  try
+  {
+    _renderer.fill_source_pool();
+  }
+  catch (const std::exception& e)
+  {
+    // e.g. if the renderer needs a properties file for each source
+    WARNING("Couldn't create source pool: " << e.what());
+  }
+
 #ifndef ENABLE_IP_INTERFACE
   if (_conf.ip_server)
   {
@@ -376,9 +472,7 @@ Controller<Renderer>::Controller(int argc, char* argv[])
   auto subscriber = new RenderSubscriber<Renderer>(_renderer);
   _subscribe(subscriber);
 
-#ifdef ENABLE_ECASOUND
   _load_audio_recorder(_conf.audio_recorder_file_name);
-#endif
 
   if (!this->load_scene(_conf.scene_file_name))
   {
@@ -397,7 +491,8 @@ Controller<Renderer>::Controller(int argc, char* argv[])
   if (_conf.ip_server)
   {
     VERBOSE("Starting IP Server with port " << _conf.server_port);
-    _network_interface.reset(new Server(*this, _conf.server_port));
+    _network_interface.reset(new Server(*this, _conf.server_port
+          , _conf.network_update_interval));
     _network_interface->start();
   }
 #endif // ENABLE_IP_INTERFACE
@@ -410,8 +505,8 @@ class Controller<Renderer>::query_state
     query_state(Controller& controller, Renderer& renderer)
       : _controller(controller)
       , _renderer(renderer)
-      , _discard_source_levels(true)
-      , _last_source(0)
+      , _next(std::make_shared<LevelSnapshot>())
+      , _version(0)
     {}
 
     void query()
@@ -427,91 +522,82 @@ class Controller<Renderer>::query_state
         _master_level = std::max(_master_level, out.get_level());
       }
 
-      _last_source = 0;
+      // NB: The signal levels are published by the level meters and can be
+      // read at any time (see update()), only the output levels of the
+      // sources have to be copied here.
 
       using source_list_t
         = typename Renderer::template rtlist_proxy<typename Renderer::Source>;
-      auto source_list = source_list_t(_renderer.get_source_list());
-
-      if (_source_levels.size() == source_list.size())
-      {
-        auto levels = _source_levels.begin();
-
-        for (const auto& source: source_list)
-        {
-          _last_source = &source;
-          levels->source = source.get_level();
-
-          levels->outputs_available = source.get_output_levels(
-              &*levels->outputs.begin(), &*levels->outputs.end());
-
-          ++levels;
-        }
-        _discard_source_levels = false;
-      }
-      else
-      {
-        _discard_source_levels = true;
-      }
+      _output_levels.query(source_list_t(_renderer.get_source_list())
+          , output_list.size());
     }
 
     void update()
     {
       _controller._publish(&Subscriber::set_transport_state, _state);
       _controller.set_cpu_load(_cpu_load);
-      _controller.set_master_signal_level(_master_level);
 
+      // The map itself could be read without the lock, but the sources
+      // mustn't be removed while their levels are read
       auto lock = _renderer.get_scoped_lock();
 
-      // To check the size is not sufficient, we also check the last element
-      if (!_discard_source_levels
-          && _source_levels.size() == _renderer.get_source_map().size()
-          && (_renderer.get_source_map().empty()
-              || _last_source == _renderer.get_source_map().rbegin()->second))
+      auto sources = _renderer.get_source_map();
+      const auto& source_map = *sources;
+      size_t outputs = _renderer.get_output_list().size();
+
+      auto& snapshot = *_next;
+      snapshot.version = ++_version;
+      snapshot.master = _master_level;
+      snapshot.ids.clear();
+      snapshot.source_levels.clear();
+
+      for (const auto& item: source_map)
       {
-        _set_source_signal_levels(_renderer.get_source_map().begin()
-            , _renderer.get_source_map().end());
+        snapshot.ids.push_back(static_cast<id_t>(item.first));
+        snapshot.source_levels.push_back(item.second->get_level());
       }
-      _source_levels.resize(_renderer.get_source_map().size()
-          , SourceLevel(_renderer.get_output_list().size()));
-    }
-
-  private:
-    struct SourceLevel
-    {
-      explicit SourceLevel(size_t n)
-        : outputs_available(false)
-        , outputs(n)
-      {}
 
-      typename Renderer::sample_type source;
+      _report_failed_sources(source_map);
 
-      bool outputs_available;
-      // this may never be resized:
-      std::vector<typename Renderer::sample_type> outputs;
-    };
+      _output_levels.copy_to(snapshot, source_map, outputs);
 
-    using source_levels_t = std::vector<SourceLevel>;
+      _controller._publish(&Subscriber::set_levels
+          , LevelSnapshot::ptr(_next));
 
-    // TODO: quick hack, maybe implement properly some day?
-    template<typename MapIterator>
-    void _set_source_signal_levels(MapIterator first, MapIterator last)
-    {
-      assert(size_t(std::distance(first, last)) == _source_levels.size());
+      // Re-use the previous snapshot if no subscriber holds on to it anymore,
+      // this way no memory is allocated in the steady state.
+      std::swap(_next, _previous);
+      if (!_next || _next.use_count() != 1)
+      {
+        _next = std::make_shared<LevelSnapshot>();
+      }
 
-      auto levels = _source_levels.begin();
+      _output_levels.reserve(source_map.size(), outputs);
+    }
 
-      for (; first != last; ++first)
+  private:
+    /// Publish an error once for each source whose data (e.g. impulse
+    /// responses) couldn't be loaded in the background.
+    template<typename SourceMap>
+    void _report_failed_sources(const SourceMap& source_map)
+    {
+      // Forget removed sources, their IDs may be used again
+      for (auto it = _failed_sources.begin(); it != _failed_sources.end(); )
       {
-        _controller.set_source_signal_level(first->first, levels->source);
+        if (source_map.count(*it)) ++it;
+        else it = _failed_sources.erase(it);
+      }
 
-        // TODO: make this a compile-time decision:
-        if (levels->outputs_available)
+      for (const auto& item: source_map)
+      {
+        using source_t = const typename Renderer::Source;
+        auto source = static_cast<source_t*>(item.second);
+        if (source->load_failed() && _failed_sources.insert(item.first).second)
         {
-          _controller.set_source_output_levels(first->first
-              , &*levels->outputs.begin(), &*levels->outputs.end());
+          _controller._publish(&Subscriber::set_source_error
+              , static_cast<id_t>(item.first)
+              , std::string("impulse responses couldn't be loaded"));
         }
-        ++levels;
       }
     }
 
@@ -521,9 +607,13 @@ class Controller<Renderer>::query_state
     float _cpu_load;
     typename Renderer::sample_type _master_level;
 
-    source_levels_t _source_levels;
-    bool _discard_source_levels;
-    const typename Renderer::Source* _last_source;
+    /// snapshot which is filled by query() and update() and published next
+    std::shared_ptr<LevelSnapshot> _next;
+    std::shared_ptr<LevelSnapshot> _previous;  ///< most recently published
+    unsigned long _version;
+
+    SourceOutputLevels<typename Renderer::Source> _output_levels;
+    std::set<int> _failed_sources;  ///< already reported with set_source_error
 };
 
 template<typename Renderer>
@@ -599,10 +689,125 @@ bool Controller<Renderer>::run()
   return true;
 }
 
+/** Render the scene as fast as possible, without JACK (see ssr-offline).
+ * The audio files are played from the beginning, the output signals are
+ * written to the file given with @c --record.
+ * Requests from the script given with @c --script are applied at the
+ * beginning of the first audio block which starts at (or after) their time.
+ * Rendering stops after the time given with @c --duration or, if none is
+ * given, at the end of the longest audio file (or after the last request of
+ * the script).  The output file is rounded up to a whole number of blocks.
+ * @return @b true on success
+ * @note This needs a Renderer with the offline_policy.
+ **/
+template<typename Renderer>
+bool Controller<Renderer>::render_offline()
+{
+  if (!_disk_recorder)
+  {
+    ERROR("No output file specified (use --record=FILE)!");
+    return false;
+  }
+
+  using sample_type = typename Renderer::sample_type;
+
+  const auto sample_rate = static_cast<size_t>(_renderer.sample_rate());
+  const auto block_size = static_cast<size_t>(_renderer.block_size());
+
+  std::vector<internal::timed_request> script;
+  if (_conf.offline_script != ""
+      && !internal::load_script(_conf.offline_script, sample_rate, script))
+  {
+    return false;
+  }
+
+  size_t length = 0;
+  if (_conf.offline_duration > 0.0f)
+  {
+    length = static_cast<size_t>(_conf.offline_duration * sample_rate + 0.5f);
+  }
+  else if (_loop)
+  {
+    ERROR("A duration must be specified for looped audio files!");
+    return false;
+  }
+  else
+  {
+    typename SourceCopy::container_t sources;
+    _scene.get_sources(sources);
+    for (const auto& source: sources)
+    {
+      length = std::max(length, static_cast<size_t>(source.file_length));
+    }
+    if (!script.empty())
+    {
+      length = std::max(length, script.back().first + 1);
+    }
+  }
+
+  if (length == 0)
+  {
+    ERROR("Nothing to render (use --duration=TIME)!");
+    return false;
+  }
+
+  // Sources without audio file get silence
+  auto silence = std::vector<sample_type>(block_size);
+  auto inputs = std::vector<sample_type*>();
+  apf::fixed_matrix<sample_type> outputs(_renderer.out_channels(), block_size);
+
+  CommandParser parser(*this);
+
+  // All sources have to start with their IRs, like in a realtime run with
+  // enough time between loading the scene and starting the transport
+  _renderer.wait_for_background_loads();
+
+  if (!_renderer.activate()) return false;
+
+  this->set_processing_state(true);
+  this->transport_locate(0.0f);
+  this->transport_start();
+
+  VERBOSE("Rendering " << static_cast<float>(length) / sample_rate
+      << " seconds to \"" << _conf.audio_recorder_file_name << "\" ...");
+  auto start = std::chrono::steady_clock::now();
+
+  auto request = script.begin();
+  for (size_t frame = 0; frame < length; frame += block_size)
+  {
+    if (request != script.end() && request->first <= frame)
+    {
+      // Without audio thread, the requests are executed immediately
+      _renderer.deactivate();
+      for ( ; request != script.end() && request->first <= frame; ++request)
+      {
+        parser.parse_cmd(request->second);
+      }
+      _renderer.wait_for_background_loads();
+      _renderer.activate();
+    }
+
+    // new sources may have been added
+    inputs.resize(_renderer.in_channels(), silence.data());
+
+    _renderer.audio_callback(static_cast<int>(block_size)
+        , inputs.data()
+        , outputs.get_channel_ptrs());
+  }
+
+  this->transport_stop();
+
+  std::chrono::duration<float> elapsed
+    = std::chrono::steady_clock::now() - start;
+  VERBOSE("Rendering took " << elapsed.count() << " seconds ("
+      << static_cast<float>(length) / sample_rate / elapsed.count()
+      << " times realtime).");
+  return true;
+}
+
 template<typename Renderer>
 Controller<Renderer>::~Controller()
 {
-  //recorder->disable();
   this->stop_processing();
 
   // TODO: check if transport needs to be stopped
@@ -614,8 +819,16 @@ Controller<Renderer>::~Controller()
   }
 
   _subscribers.clear();
+  {
+    std::lock_guard<std::mutex> guard(_async_subscriber_mutex);
+    _async_subscribers.clear();
+  }
 
   this->deactivate();
+
+  // the file is completed after the audio thread has stopped
+  _renderer.set_recorder(nullptr);
+  _disk_recorder.reset();
 }
 
 namespace internal
@@ -759,23 +972,61 @@ get_file_or_port_name(const Node& node, std::string& file_or_port_name)
 
 } // end of anonymous namespace
 
-// Public version of subscribe... private method will soon
-// be phased out.
-//
-// FIXME: THREAD
+/** Add an external subscriber (e.g. a network client).
+ * The subscriber gets its own queue and thread, see AsyncSubscriber.
+ * If it falls behind too far, it gets the whole scene again.
+ **/
 template<typename Renderer>
 void
 Controller<Renderer>::subscribe(Subscriber* const subscriber)
 {
-  _subscribers.push_back(subscriber);
+  // FIXME: THREAD (like _publish(), the Scene is read without locking)
+  auto temp = std::unique_ptr<AsyncSubscriber>(new AsyncSubscriber(*subscriber
+        , [this] (Subscriber& s) { _scene.replay(s); }));
+  std::lock_guard<std::mutex> guard(_async_subscriber_mutex);
+  _async_subscribers.push_back(std::move(temp));
 }
 
-// FIXME: THREAD
+/// Remove a subscriber which was added with subscribe().
+/// Calls which are still queued are discarded.
 template<typename Renderer>
 void
 Controller<Renderer>::unsubscribe(Subscriber* subscriber)
 {
-  std::remove(_subscribers.begin(), _subscribers.end(), subscriber);
+  std::unique_ptr<AsyncSubscriber> temp;
+  {
+    std::lock_guard<std::mutex> guard(_async_subscriber_mutex);
+    auto found = std::find_if(_async_subscribers.begin()
+        , _async_subscribers.end()
+        , [subscriber] (const std::unique_ptr<AsyncSubscriber>& s)
+          {
+            return &s->target() == subscriber;
+          });
+    if (found == _async_subscribers.end()) return;
+    temp = std::move(*found);
+    _async_subscribers.erase(found);
+  }
+  // the dispatch thread is stopped outside of the lock
+}
+
+/** Send the whole scene (see Scene::replay()) to a subscriber which was added
+ * with subscribe().
+ * The calls are queued after the ones which are already waiting, this can be
+ * used if the subscriber lost track of the scene.
+ **/
+template<typename Renderer>
+void
+Controller<Renderer>::replay_scene(Subscriber* subscriber)
+{
+  // FIXME: THREAD (like _publish(), the Scene is read without locking)
+  std::lock_guard<std::mutex> guard(_async_subscriber_mutex);
+  for (auto& async_subscriber: _async_subscribers)
+  {
+    if (&async_subscriber->target() == subscriber)
+    {
+      _scene.replay(*async_subscriber);
+    }
+  }
 }
 
 template<typename Renderer>
@@ -1003,13 +1254,7 @@ template<typename Renderer>
 bool
 Controller<Renderer>::_create_spontaneous_scene(const std::string& audio_file_name)
 {
-#ifndef ENABLE_ECASOUND
-  ERROR("Couldn't create scene from file \"" << audio_file_name
-        << "\"! Ecasound was disabled at compile time.");
-  return false;
-#else
-  size_t no_of_audio_channels;
-  AudioPlayer::Soundfile::get_format(audio_file_name, no_of_audio_channels);
+  size_t no_of_audio_channels = DiskPlayer::get_channels(audio_file_name);
 
   if (no_of_audio_channels == 0)
   {
@@ -1110,7 +1355,6 @@ Controller<Renderer>::_create_spontaneous_scene(const std::string& audio_file_na
       } // for each audio channel
   } // switch
   return true;
-#endif  // ENABLE_ECASOUND
 }
 
 #ifdef ENABLE_GUI
@@ -1223,42 +1467,25 @@ Controller<Renderer>::calibrate_client()
 #endif
 }
 
-#ifdef ENABLE_ECASOUND
 /**
  * The recorder is started as soon the JACK transport is running.
  * @param audio_file_name quite obviously, the file which will be recorded
- * to. It will have the given @a sample_format, the same number of channels as
- * the renderer has output channels and it will have the same sample rate as the
- * JACK audio server.
- * @param sample_format for more information see the ecasound(1) manpage and
- * especially the documentation of the -f option.
+ * to. It will have the same number of channels as the renderer has output
+ * channels and it will have the same sample rate as the JACK audio server.
+ * The file type is chosen according to the extension, see DiskRecorder.
  * @warning This may only be used before activate() is called!
  **/
 template<typename Renderer>
 void
-Controller<Renderer>::_load_audio_recorder(const std::string& audio_file_name
-    , const std::string& sample_format, const std::string& client_name
-    , const std::string& input_prefix)
+Controller<Renderer>::_load_audio_recorder(const std::string& audio_file_name)
 {
   if (audio_file_name == "") return;
 
-  output_list_t output_list = _renderer.get_output_list();
-
-  size_t channels = output_list.size();
-  int sample_rate = _renderer.sample_rate();
-
-  _audio_recorder.reset(new AudioRecorder(audio_file_name
-      , sample_format + "," + apf::str::A2S(channels) + ","
-      + apf::str::A2S(sample_rate), "", client_name, input_prefix));
-
-  size_t channel = 1;
-  for (const auto& out: output_list)
-  {
-    _renderer.connect_ports(out.port_name()
-        , client_name + ":" + input_prefix + "_" + apf::str::A2S(channel++));
-  }
+  _disk_recorder.reset(new DiskRecorder(audio_file_name
+        , _renderer.get_output_list().size(), _renderer.sample_rate()
+        , _renderer.block_size(), 4.0f, internal::is_realtime<Renderer>(0)));
+  _renderer.set_recorder(_disk_recorder.get());
 }
-#endif
 
 /** start audio processing.
  * This sets the Scene's processing state to "processing". The
@@ -1364,32 +1591,28 @@ Controller<Renderer>::new_source(const std::string& name, const Source::model_t
   std::string port_name;
   std::string file_name = "";
   long int file_length = 0;
+  DiskPlayer::Track* track = nullptr;
 
   if (channel > 0) // we're dealing with a soundfile
   {
-#ifdef ENABLE_ECASOUND
-    // if not already running, start AudioPlayer
-    if (!_audio_player)
+    // if not already running, start DiskPlayer
+    if (!_disk_player)
     {
-      _audio_player = AudioPlayer::ptr_t(new AudioPlayer);
+      // the thing with _loop is a temporary hack, should be removed some time
+      _disk_player = DiskPlayer::ptr_t(
+          new DiskPlayer(_renderer.sample_rate(), _loop, 2
+            , internal::is_realtime<Renderer>(0)));
     }
-    // the thing with _loop is a temporary hack, should be removed some time:
-    port_name = _audio_player->get_port_name(file_or_port_name, channel, _loop);
-    //port_name   = _audio_player->get_port_name  (file_or_port_name, channel);
-    file_length = _audio_player->get_file_length(file_or_port_name);
+    track = _disk_player->get_track(file_or_port_name, channel);
+    file_length = _disk_player->get_file_length(file_or_port_name);
     file_name   = file_or_port_name;
-#else
-    ERROR("Couldn't open audio file \"" << file_or_port_name
-        << "\"! Ecasound was disabled at compile time.");
-    return;
-#endif
   }
   else // no audio file
   {
     port_name = file_or_port_name;
   }
 
-  if (port_name == "" && get_renderer_name() != "bpb")
+  if (port_name == "" && !track && get_renderer_name() != "bpb")
   {
     VERBOSE("No audio file or port specified for source '" << name << "'.");
   }
@@ -1401,14 +1624,21 @@ Controller<Renderer>::new_source(const std::string& name, const Source::model_t
 
   try
   {
-    id = _renderer.add_source(p);
+    id = _renderer.add_source(p, track);
   }
   catch (std::exception& e)
   {
     ERROR(e.what());
+    if (track) _disk_player->remove_track(track);
     return;
   }
 
+  if (track)
+  {
+    std::lock_guard<std::mutex> guard(_tracks_mutex);
+    _tracks[id] = track;
+  }
+
   _publish(&Subscriber::new_source, id);
   // mute while transmitting data
   _publish(&Subscriber::set_source_mute, id, true);
@@ -1436,11 +1666,14 @@ void
 Controller<Renderer>::delete_all_sources()
 {
   _publish(&Subscriber::delete_all_sources);
-#ifdef ENABLE_ECASOUND
-  _audio_player.reset(); // shut down audio player
-#endif
   // Wait until InternalInput objects are destroyed
   _renderer.wait_for_rt_thread();
+  // the audio thread doesn't use any Track anymore
+  {
+    std::lock_guard<std::mutex> guard(_tracks_mutex);
+    _tracks.clear();
+  }
+  _disk_player.reset();
 }
 
 template<typename Renderer>
@@ -1448,7 +1681,18 @@ void
 Controller<Renderer>::delete_source(id_t id)
 {
   _publish(&Subscriber::delete_source, id);
-  // TODO: stop AudioPlayer if not needed anymore?
+
+  DiskPlayer::Track* track = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(_tracks_mutex);
+    auto iter = _tracks.find(id);
+    if (iter == _tracks.end()) return;
+    track = iter->second;
+    _tracks.erase(iter);
+  }
+  // Wait until the InternalInput doesn't read from the Track anymore
+  _renderer.wait_for_rt_thread();
+  _disk_player->remove_track(track);
 }
 
 template<typename Renderer>
@@ -0,0 +1,430 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Streaming audio file player (implementation).
+
+#include <sndfile.hh>
+#include <chrono>
+#include <stdexcept>  // for std::runtime_error
+
+#include "diskplayer.h"
+#include "ssr_global.h"  // for ERROR(), VERBOSE2()
+#include "apf/container.h"  // for fixed_matrix
+#include "apf/resampler.h"
+#include "apf/stringtools.h"
+
+namespace
+{
+/// size of the ring buffer of each Track (in samples)
+const size_t track_buffer_size = 1 << 16;
+/// number of frames read at once
+const size_t chunk_size = 1 << 13;
+/// time between two checks if the buffers need to be filled
+const auto prefetch_interval = std::chrono::milliseconds(10);
+}
+
+/// An audio file with all its Track%s.
+class ssr::DiskPlayer::File : apf::NonCopyable
+{
+  public:
+    File(const std::string& name, size_t sample_rate, bool loop);
+
+    const std::string& name() const { return _name; }
+    size_t channels() const { return _channels; }
+    size_t length() const { return _length; }
+
+    Track* add_track(int channel, bool wait);
+    bool remove_track(Track* track);
+    bool fill();
+
+  private:
+    size_t _read(size_t position, size_t frames);
+
+    const std::string _name;
+    const bool _loop;
+    SndfileHandle _handle;
+    size_t _channels;
+    size_t _length;  ///< in samples (at the sample rate of the renderer)
+    size_t _file_position;  ///< current position of _handle
+
+    /// @b true if the sample rates are different, see _memory
+    bool _in_memory;
+    /// whole (resampled) file
+    apf::fixed_matrix<float> _memory;
+
+    std::vector<float> _chunk;  ///< interleaved samples
+    std::vector<float> _samples;  ///< samples of one channel
+
+    std::vector<std::pair<std::unique_ptr<Track>, size_t>> _tracks;
+    std::mutex _mutex;  ///< protects _tracks
+};
+
+/** Open an audio file.
+ * @param name file name
+ * @param sample_rate sample rate of the renderer
+ * @param loop if @b true, the file is repeated endlessly
+ * @throw std::runtime_error if the file cannot be opened
+ **/
+ssr::DiskPlayer::File::File(const std::string& name, size_t sample_rate
+    , bool loop)
+  : _name(name)
+  , _loop(loop)
+  , _handle(name)
+  , _channels(0)
+  , _length(0)
+  , _file_position(0)
+  , _in_memory(false)
+  , _chunk(chunk_size)
+  , _samples(chunk_size)
+{
+  if (!_handle || _handle.error())
+  {
+    throw std::runtime_error("Couldn't open audio file \"" + name + "\": "
+        + _handle.strError());
+  }
+
+  _channels = static_cast<size_t>(_handle.channels());
+  _length = static_cast<size_t>(_handle.frames());
+  if (_channels == 0)
+  {
+    throw std::runtime_error("No audio channels found in \"" + name + "\"!");
+  }
+  _chunk.resize(chunk_size * _channels);
+
+  auto file_rate = static_cast<size_t>(_handle.samplerate());
+  if (file_rate != sample_rate)
+  {
+    WARNING("'" + name + "' has a different sample rate than JACK! ("
+        + apf::str::A2S(file_rate) + " vs. " + apf::str::A2S(sample_rate)
+        + "), it is converted in memory.");
+
+    auto resampler = apf::Resampler(file_rate, sample_rate);
+    auto input = apf::fixed_matrix<float>(_length, _channels);
+    _handle.readf(input.data(), static_cast<sf_count_t>(_length));
+
+    _length = resampler.output_size(_length);
+    _in_memory = true;
+    _memory.initialize(_length, _channels);
+    auto temp = std::vector<float>(_length);
+    auto target = _memory.slices.begin();
+    for (const auto& slice: input.slices)
+    {
+      resampler.process(slice.begin(), slice.end(), temp.begin());
+      std::copy(temp.begin(), temp.end(), target->begin());
+      ++target;
+    }
+  }
+
+  VERBOSE2("Added '" + name + "', channels: " + apf::str::A2S(_channels)
+      + ", sample rate: " + apf::str::A2S(file_rate) + ".");
+}
+
+/** Create a new Track.
+ * @param channel channel number (starting with 1)
+ * @param wait see Track::Track()
+ * @return pointer to the new Track, it stays valid until it is removed with
+ *   remove_track() or the DiskPlayer is destroyed.
+ * @throw std::runtime_error if @p channel doesn't exist
+ **/
+ssr::DiskPlayer::Track*
+ssr::DiskPlayer::File::add_track(int channel, bool wait)
+{
+  if (channel < 1 || static_cast<size_t>(channel) > _channels)
+  {
+    throw std::runtime_error("Channel " + apf::str::A2S(channel)
+        + " doesn't exist in '" + _name + "'!");
+  }
+
+  auto track = new Track(_length, _loop, track_buffer_size, wait);
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tracks.emplace_back(std::unique_ptr<Track>(track)
+      , static_cast<size_t>(channel) - 1);
+  return track;
+}
+
+/** Destroy a Track.
+ * @param track a Track which was created by add_track()
+ * @return @b false if @p track doesn't belong to this File
+ **/
+bool
+ssr::DiskPlayer::File::remove_track(Track* track)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto iter = std::find_if(_tracks.begin(), _tracks.end()
+      , [track] (const decltype(_tracks)::value_type& item)
+      {
+        return item.first.get() == track;
+      });
+  if (iter == _tracks.end()) return false;
+  _tracks.erase(iter);
+  return true;
+}
+
+/** Fill the buffers of all Tracks (prefetch thread).
+ * Tracks at the same position are filled with one read operation.
+ * @return @b true if anything was written.
+ **/
+bool
+ssr::DiskPlayer::File::fill()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // handle seek requests
+  for (auto& item: _tracks)
+  {
+    Track& track = *item.first;
+    unsigned request = track._request.load(std::memory_order_acquire);
+    if (request != track._acknowledged)
+    {
+      track._write_position
+        = track._request_position.load(std::memory_order_relaxed);
+      track._ack_index.store(track._buffer.write_index()
+          , std::memory_order_relaxed);
+      track._acknowledged = request;
+      track._ack.store(request, std::memory_order_release);
+    }
+  }
+
+  bool result = false;
+  for (;;)
+  {
+    auto first = std::find_if(_tracks.begin(), _tracks.end()
+        , [] (const decltype(_tracks)::value_type& item)
+        {
+          return item.first->_buffer.write_space() >= chunk_size;
+        });
+    if (first == _tracks.end()) break;
+
+    size_t position = first->first->_write_position;
+    size_t frames = _read(position, chunk_size);
+
+    for (auto i = first; i != _tracks.end(); ++i)
+    {
+      Track& track = *i->first;
+      if (track._write_position != position
+          || track._buffer.write_space() < chunk_size) continue;
+
+      if (frames == 0)
+      {
+        // after the end of the file (if not looping)
+        track._buffer.write_zeros(chunk_size);
+        track._write_position += chunk_size;
+        continue;
+      }
+
+      size_t channel = i->second;
+      for (size_t n = 0; n < frames; ++n)
+      {
+        _samples[n] = _chunk[n * _channels + channel];
+      }
+      track._buffer.write(_samples.begin(), _samples.begin() + frames);
+      track._write_position = _loop
+        ? (position + frames) % _length : position + frames;
+    }
+    result = true;
+  }
+  return result;
+}
+
+/** Read interleaved frames into _chunk.
+ * @return number of frames, 0 at the end of the file.
+ **/
+size_t
+ssr::DiskPlayer::File::_read(size_t position, size_t frames)
+{
+  if (position >= _length) return 0;
+  frames = std::min(frames, _length - position);
+
+  if (_in_memory)
+  {
+    std::copy(_memory.data() + position * _channels
+        , _memory.data() + (position + frames) * _channels, _chunk.begin());
+    return frames;
+  }
+
+  if (position != _file_position)
+  {
+    _handle.seek(static_cast<sf_count_t>(position), SEEK_SET);
+  }
+  auto n = static_cast<size_t>(std::max(sf_count_t(0)
+        , _handle.readf(_chunk.data(), static_cast<sf_count_t>(frames))));
+  // in case of an error, silence is played
+  std::fill(_chunk.begin() + n * _channels
+      , _chunk.begin() + frames * _channels, 0.0f);
+  _file_position = position + n;
+  return frames;
+}
+
+/** Constructor.
+ * @param sample_rate sample rate of the renderer
+ * @param loop if @b true, all files are repeated endlessly
+ * @param threads number of prefetch threads
+ * @param realtime if @b false, Track::read() waits for the prefetch threads
+ **/
+ssr::DiskPlayer::DiskPlayer(size_t sample_rate, bool loop, size_t threads
+    , bool realtime)
+  : _sample_rate(sample_rate)
+  , _loop(loop)
+  , _realtime(realtime)
+  , _stop(false)
+{
+  for (size_t i = 0; i < std::max(threads, size_t(1)); ++i)
+  {
+    _threads.emplace_back(&DiskPlayer::_prefetch, this, i
+        , std::max(threads, size_t(1)));
+  }
+}
+
+/// Stop prefetch threads and close all files.
+ssr::DiskPlayer::~DiskPlayer()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  for (auto& thread: _threads)
+  {
+    thread.join();
+  }
+  VERBOSE2("DiskPlayer dtor.");
+}
+
+/** Get a Track for the given file and channel.
+ * If the file isn't opened yet, it's opened.
+ * @param file_name name of audio file
+ * @param channel select a channel of a multichannel file (starting with 1)
+ * @return Pointer to the Track (it stays valid until remove_track() is called
+ *   or the DiskPlayer is destroyed), @c nullptr on error.
+ * @warning If @a file_name uses symbolic links or such things it can
+ * happen that one file is opened several times.
+ **/
+ssr::DiskPlayer::Track*
+ssr::DiskPlayer::get_track(const std::string& file_name, int channel)
+{
+  File* file = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& f: _files)
+    {
+      if (f->name() == file_name) file = f.get();
+    }
+  }
+
+  try
+  {
+    if (!file)
+    {
+      auto temp = std::unique_ptr<File>(
+          new File(file_name, _sample_rate, _loop));
+      file = temp.get();
+      std::lock_guard<std::mutex> lock(_mutex);
+      _files.push_back(std::move(temp));
+    }
+    else
+    {
+      VERBOSE2("DiskPlayer: Input file '" + file_name
+          + "' already registered.");
+    }
+    auto track = file->add_track(channel, !_realtime);
+    // start filling right away
+    _condition.notify_all();
+    return track;
+  }
+  catch (const std::runtime_error& e)
+  {
+    ERROR("DiskPlayer: " << e.what());
+    return nullptr;
+  }
+}
+
+/** Destroy a Track (and free its buffer).
+ * The file stays open, it may be used again by get_track().
+ * @param track a Track returned by get_track()
+ * @warning The audio thread must not use @p track anymore!
+ **/
+void
+ssr::DiskPlayer::remove_track(Track* track)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (const auto& f: _files)
+  {
+    if (f->remove_track(track)) return;
+  }
+}
+
+/** _.
+ * @param file_name the audio file you want to know the length of.
+ * @warning If the file wasn't loaded before, 0 is returned!
+ **/
+long int
+ssr::DiskPlayer::get_file_length(const std::string& file_name) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (const auto& f: _files)
+  {
+    if (f->name() == file_name) return static_cast<long int>(f->length());
+  }
+  return 0;
+}
+
+/// Get number of channels of an audio file (0 on error).
+size_t
+ssr::DiskPlayer::get_channels(const std::string& file_name)
+{
+  SndfileHandle handle(file_name);
+  if (!handle || handle.error()) return 0;
+  return static_cast<size_t>(handle.channels());
+}
+
+/// Thread function, files are distributed evenly to all threads.
+/// @param index number of this thread
+/// @param threads total number of threads
+void
+ssr::DiskPlayer::_prefetch(size_t index, size_t threads)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_stop)
+  {
+    bool busy = false;
+    for (size_t i = index; i < _files.size(); i += threads)
+    {
+      File* file = _files[i].get();
+      lock.unlock();
+      busy |= file->fill();
+      lock.lock();
+      if (_stop) return;
+    }
+    // without realtime constraints, the buffers are drained much faster
+    if (!busy) _condition.wait_for(lock
+        , _realtime ? prefetch_interval : prefetch_interval / 10);
+  }
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
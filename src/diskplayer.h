@@ -0,0 +1,240 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Streaming audio file player (definition).
+
+#ifndef SSR_DISKPLAYER_H
+#define SSR_DISKPLAYER_H
+
+#include <string>
+#include <vector>
+#include <memory>  // for std::unique_ptr
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>  // for std::fill(), std::min()
+#include <limits>  // for std::numeric_limits
+
+#include "apf/misc.h"  // for NonCopyable
+#include "apf/ringbuffer.h"
+
+namespace ssr
+{
+
+/** Plays audio files from disk, synchronized to JACK transport.
+ * Each channel of a file which is used by a source is a Track.  A Track
+ * contains a lock-free ring buffer which is filled by a pool of prefetch
+ * threads and read by the audio thread (see Track::read()).
+ *
+ * Files are read with libsndfile.  If the sample rate of a file is different
+ * from the sample rate of the renderer, the whole file is converted when it
+ * is opened and kept in memory.
+ *
+ * For non-realtime rendering (see ssr-offline), the audio thread waits for
+ * the prefetch threads instead of returning silence.
+ **/
+class DiskPlayer : apf::NonCopyable
+{
+  public:
+    using ptr_t = std::unique_ptr<DiskPlayer>; ///< unique_ptr to DiskPlayer
+
+    class Track;
+
+    explicit DiskPlayer(size_t sample_rate, bool loop = false
+        , size_t threads = 2, bool realtime = true);
+    ~DiskPlayer();
+
+    Track* get_track(const std::string& file_name, int channel);
+    void remove_track(Track* track);
+    long int get_file_length(const std::string& file_name) const;
+
+    static size_t get_channels(const std::string& file_name);
+
+  private:
+    class File;
+
+    void _prefetch(size_t index, size_t threads);
+
+    const size_t _sample_rate;
+    const bool _loop;
+    const bool _realtime;
+
+    /// Files are never removed (only when the DiskPlayer is destroyed)
+    std::vector<std::unique_ptr<File>> _files;
+    /// protects _files and _stop
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;  ///< to stop the prefetch threads
+    bool _stop;
+    std::vector<std::thread> _threads;
+};
+
+/** One channel of an audio file.
+ * The audio thread reads samples with read(), the file position is taken
+ * from JACK transport.  If the position doesn't match the buffered samples,
+ * the prefetch thread is asked to continue reading at the new position, in
+ * the meantime, silence is returned.
+ **/
+class DiskPlayer::Track : apf::NonCopyable
+{
+  public:
+    /// Constructor.
+    /// @param length length of the file (in samples)
+    /// @param loop if @b true, the file is repeated endlessly
+    /// @param buffer_size size of the ring buffer (in samples)
+    /// @param wait if @b true, read() waits until the samples are available
+    Track(size_t length, bool loop, size_t buffer_size, bool wait)
+      : _buffer(buffer_size)
+      , _length(length)
+      , _loop(loop)
+      , _wait(wait)
+      , _position(0)
+      , _requested(0)
+      , _handled(0)
+      , _request(0)
+      , _request_position(0)
+      , _ack(0)
+      , _ack_index(0)
+      , _write_position(0)
+      , _acknowledged(0)
+    {}
+
+    /** Get samples for one audio block (audio thread).
+     * This never blocks (unless @c wait was requested in the constructor).
+     * If not enough samples are available, the rest is filled with zeros.
+     * @param first begin of output block
+     * @param last end of output block
+     * @param rolling @b true if JACK transport is rolling
+     * @param frame JACK transport position
+     **/
+    void read(float* first, float* last, bool rolling, size_t frame)
+    {
+      if (!rolling || _length == 0 || (!_loop && frame >= _length))
+      {
+        std::fill(first, last, 0.0f);
+        return;
+      }
+
+      while (!_read(first, last, frame))
+      {
+        if (!_wait)
+        {
+          std::fill(first, last, 0.0f);
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+
+  private:
+    friend class File;
+
+    /// Try to read a block.  If the samples aren't available yet, nothing is
+    /// written to the output and @b false is returned.  In this case, it can
+    /// be tried again later with the same @p frame.
+    bool _read(float* first, float* last, size_t frame)
+    {
+      if (_ack.load(std::memory_order_acquire) != _requested) return false;
+
+      if (_handled != _requested)
+      {
+        // first block after a seek, discard the samples before the new position
+        _buffer.skip_to(_ack_index.load(std::memory_order_relaxed));
+        _position = _request_position.load(std::memory_order_relaxed);
+        _handled = _requested;
+      }
+
+      size_t target = _loop ? frame % _length : frame;
+      size_t gap = _distance(_position, target);
+      if (gap > _buffer.size())
+      {
+        _request_position.store(target, std::memory_order_relaxed);
+        _request.store(++_requested, std::memory_order_release);
+        return false;
+      }
+
+      // catch up (after seeking or after a buffer underrun)
+      size_t skipped = _buffer.skip(gap);
+      _position = _advance(_position, skipped);
+      if (skipped < gap) return false;
+
+      auto size = static_cast<size_t>(last - first);
+      if (_wait)
+      {
+        // all samples up to the end of the file
+        size_t needed = _loop ? size : std::min(size, _length - target);
+        if (_buffer.read_space() < needed) return false;
+      }
+
+      size_t n = _buffer.read(first, size);
+      std::fill(first + n, last, 0.0f);
+      _position = _advance(_position, n);
+      return true;
+    }
+
+    /// Number of samples from @p from to @p to (both file positions)
+    size_t _distance(size_t from, size_t to) const
+    {
+      if (_loop) return (to + _length - from) % _length;
+      return to >= from ? to - from : std::numeric_limits<size_t>::max();
+    }
+
+    size_t _advance(size_t position, size_t samples) const
+    {
+      return _loop ? (position + samples) % _length : position + samples;
+    }
+
+    apf::RingBuffer<float> _buffer;
+    const size_t _length;
+    const bool _loop;
+    const bool _wait;
+
+    // only used by the audio thread:
+    size_t _position;  ///< file position of the next sample in _buffer
+    unsigned _requested;  ///< number of seek requests
+    unsigned _handled;  ///< number of seek requests finished
+
+    // seek requests from the audio thread to the prefetch thread:
+    std::atomic<unsigned> _request;
+    std::atomic<size_t> _request_position;
+    std::atomic<unsigned> _ack;
+    /// first sample in _buffer which belongs to the new position
+    std::atomic<size_t> _ack_index;
+
+    // only used by the prefetch thread:
+    size_t _write_position;  ///< file position of next sample to be written
+    unsigned _acknowledged;
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
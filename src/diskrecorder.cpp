@@ -0,0 +1,285 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Streaming multichannel audio file recorder (implementation).
+
+#include <sndfile.hh>
+#include <chrono>
+#include <algorithm>  // for std::min(), std::fill(), std::transform()
+#include <cctype>  // for ::tolower()
+#include <stdexcept>  // for std::runtime_error
+
+#include "diskrecorder.h"
+#include "ssr_global.h"  // for WARNING(), ERROR(), VERBOSE()
+#include "posixpathtools.h"  // for get_file_extension()
+
+namespace
+{
+/// number of frames written at once
+const size_t chunk_size = 1 << 13;
+/// time between two checks if there is something to write
+const auto write_interval = std::chrono::milliseconds(50);
+
+/// File name extension in lower case
+std::string get_extension(const std::string& file_name)
+{
+  auto ext = posixpathtools::get_file_extension(file_name);
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  return ext;
+}
+
+/// Choose file type according to the file name extension.
+int get_format(const std::string& file_name)
+{
+  auto ext = get_extension(file_name);
+
+  // WAV files are automatically downgraded from RF64, see below
+  if (ext == "wav" || ext == "rf64") return SF_FORMAT_RF64 | SF_FORMAT_FLOAT;
+  if (ext == "w64") return SF_FORMAT_W64 | SF_FORMAT_FLOAT;
+  if (ext == "caf") return SF_FORMAT_CAF | SF_FORMAT_FLOAT;
+  if (ext == "aif" || ext == "aiff") return SF_FORMAT_AIFF | SF_FORMAT_FLOAT;
+  if (ext == "flac") return SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+  throw std::runtime_error("Unknown file type: \"" + file_name + "\" "
+      "(supported: .wav, .rf64, .w64, .caf, .aiff, .flac)");
+}
+}
+
+/// The audio file and a buffer for interleaving.
+class ssr::DiskRecorder::File : apf::NonCopyable
+{
+  public:
+    File(const std::string& name, size_t channels, size_t sample_rate)
+      : _handle(name, SFM_WRITE, get_format(name), static_cast<int>(channels)
+          , static_cast<int>(sample_rate))
+      , _channels(channels)
+      , _chunk(chunk_size * channels)
+      , _samples(chunk_size)
+    {
+      if (!_handle || _handle.error())
+      {
+        throw std::runtime_error("Couldn't open \"" + name + "\" for writing: "
+            + _handle.strError());
+      }
+      if (get_extension(name) == "wav")
+      {
+        // If the file ends up smaller than 4 GB, it is written as WAV
+        _handle.command(SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+      }
+      // values outside of [-1, 1] are clipped (only relevant for FLAC)
+      _handle.command(SFC_SET_CLIPPING, nullptr, SF_TRUE);
+    }
+
+    /// Interleave one channel into the chunk buffer.
+    void set_channel(size_t channel, size_t frames)
+    {
+      for (size_t i = 0; i < frames; ++i)
+      {
+        _chunk[i * _channels + channel] = _samples[i];
+      }
+    }
+
+    /// Write @p frames frames from the chunk buffer.
+    bool write(size_t frames)
+    {
+      return _handle.writef(_chunk.data(), static_cast<sf_count_t>(frames))
+        == static_cast<sf_count_t>(frames);
+    }
+
+    /// Write @p frames frames of silence.
+    bool write_silence(size_t frames)
+    {
+      std::fill(_chunk.begin(), _chunk.end(), 0.0f);
+      while (frames > 0)
+      {
+        size_t n = std::min(frames, chunk_size);
+        if (!this->write(n)) return false;
+        frames -= n;
+      }
+      return true;
+    }
+
+    const char* error() const { return _handle.strError(); }
+
+    float* samples() { return _samples.data(); }
+
+  private:
+    SndfileHandle _handle;
+    const size_t _channels;
+    std::vector<float> _chunk;  ///< interleaved samples
+    std::vector<float> _samples;  ///< samples of one channel
+};
+
+/** Constructor.
+ * The file is opened and the writer thread is started.
+ * @param file_name name of the audio file, the file type is chosen according
+ *   to the extension
+ * @param channels number of channels
+ * @param sample_rate sample rate of the renderer
+ * @param block_size number of frames per audio block
+ * @param buffer_time length of the ring buffers (in seconds), i.e. how long
+ *   the disk may be blocked without losing samples
+ * @param realtime if @b false, begin_block() waits for the writer thread
+ * @throw std::runtime_error if the file cannot be opened
+ **/
+ssr::DiskRecorder::DiskRecorder(const std::string& file_name, size_t channels
+    , size_t sample_rate, size_t block_size, float buffer_time
+    , bool realtime)
+  : _file_name(file_name)
+  , _block_size(block_size)
+  , _realtime(realtime)
+  , _gaps(64)
+  , _rolling(false)
+  , _expected_frame(0)
+  , _gap_frames(0)
+  , _jumps(0)
+  , _file(new File(file_name, channels, sample_rate))
+  , _next_gap()
+  , _have_gap(false)
+  , _failed(false)
+  , _jumps_reported(0)
+  , _dropped_frames(0)
+  , _stop(false)
+{
+  // the writer thread waits for whole chunks, so they have to fit in
+  auto size = std::max(static_cast<size_t>(buffer_time
+        * static_cast<float>(sample_rate)), 2 * chunk_size + block_size);
+  for (size_t i = 0; i < channels; ++i)
+  {
+    _buffers.emplace_back(new apf::RingBuffer<float>(size));
+  }
+
+  VERBOSE("Recording " << channels << " channels to \"" << file_name
+      << "\" (buffer size: " << _buffers.front()->size() << " samples).");
+
+  _thread = std::thread(&DiskRecorder::_writer, this);
+}
+
+/// Write the remaining samples, stop the writer thread and close the file.
+/// @pre The audio thread doesn't call begin_block() anymore.
+ssr::DiskRecorder::~DiskRecorder()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  _thread.join();
+
+  _dropped_frames += _gap_frames;
+  if (_dropped_frames)
+  {
+    WARNING("The recording \"" << _file_name << "\" contains "
+        << _dropped_frames << " frames of silence (disk too slow)!");
+  }
+  VERBOSE2("DiskRecorder dtor.");
+}
+
+/// Writer thread function.  On exit, all remaining samples are written.
+void
+ssr::DiskRecorder::_writer()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  for (;;)
+  {
+    bool stop = _stop;
+    lock.unlock();
+    bool busy = _write(stop);
+    lock.lock();
+    if (!busy)
+    {
+      if (stop) break;
+      // without realtime constraints, the buffers are filled much faster
+      _condition.wait_for(lock
+          , _realtime ? write_interval : write_interval / 10);
+    }
+  }
+}
+
+/** Write one chunk (or a gap) from the ring buffers to the file.
+ * @param drain if @b false, only whole chunks are written
+ * @return @b true if something was written
+ **/
+bool
+ssr::DiskRecorder::_write(bool drain)
+{
+  auto jumps = _jumps.load(std::memory_order_relaxed);
+  if (jumps != _jumps_reported)
+  {
+    WARNING("Recorder: JACK transport position jumped "
+        << jumps - _jumps_reported << " time(s) (xrun or relocation)!");
+    _jumps_reported = jumps;
+  }
+
+  size_t position = _buffers.front()->read_index();
+
+  if (!_have_gap) _have_gap = (_gaps.read(&_next_gap, 1) == 1);
+
+  if (_have_gap && _next_gap.index == position)
+  {
+    _have_gap = false;
+    _dropped_frames += _next_gap.frames;
+    WARNING("Recorder: Disk too slow, " << _next_gap.frames
+        << " frames were replaced by silence!");
+    if (!_failed && !_file->write_silence(_next_gap.frames)) _error();
+    return true;
+  }
+
+  size_t frames = chunk_size;
+  for (const auto& buffer: _buffers)
+  {
+    frames = std::min(frames, buffer->read_space());
+  }
+  // samples before a gap are written even if it's not a whole chunk
+  if (_have_gap) frames = std::min(frames, _next_gap.index - position);
+
+  if (frames == 0 || (frames < chunk_size && !drain && !_have_gap))
+  {
+    return false;
+  }
+
+  for (size_t channel = 0; channel < _buffers.size(); ++channel)
+  {
+    _buffers[channel]->read(_file->samples(), frames);
+    _file->set_channel(channel, frames);
+  }
+  // after an error, the samples are still taken from the buffers (and
+  // discarded) to avoid a flood of warnings from the audio thread
+  if (!_failed && !_file->write(frames)) _error();
+  return true;
+}
+
+void
+ssr::DiskRecorder::_error()
+{
+  ERROR("Recorder: Couldn't write to \"" << _file_name << "\": "
+      << _file->error() << " Recording stopped!");
+  _failed = true;
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Streaming multichannel audio file recorder (definition).
+
+#ifndef SSR_DISKRECORDER_H
+#define SSR_DISKRECORDER_H
+
+#include <string>
+#include <vector>
+#include <memory>  // for std::unique_ptr
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+#include "apf/misc.h"  // for NonCopyable
+#include "apf/ringbuffer.h"
+
+namespace ssr
+{
+
+/** Records the output signals of the renderer to a multichannel audio file.
+ * The audio thread stores each block with begin_block() and write(), the
+ * samples of each channel go to a pre-allocated lock-free ring buffer.  A
+ * writer thread collects them from there and writes them to the file in large
+ * chunks.
+ *
+ * If the writer thread can't keep up (e.g. because of disk latency), the audio
+ * thread drops whole blocks instead of waiting.  The dropped frames are
+ * written as silence, so the timing of the recording is preserved.  Dropped
+ * blocks and jumps of the JACK transport position (which happen on xruns) are
+ * counted and reported by the writer thread.
+ *
+ * Only samples which are processed while JACK transport is rolling are
+ * recorded.
+ *
+ * For non-realtime rendering (see ssr-offline), the audio thread waits for
+ * the writer thread instead of dropping blocks.
+ *
+ * Files are written with libsndfile (as 32-bit float, except for FLAC), the
+ * file type is chosen according to the file name extension.  WAV files are
+ * switched to RF64 if they get larger than 4 GB.
+ **/
+class DiskRecorder : apf::NonCopyable
+{
+  public:
+    using ptr_t = std::unique_ptr<DiskRecorder>; ///< unique_ptr to DiskRecorder
+
+    DiskRecorder(const std::string& file_name, size_t channels
+        , size_t sample_rate, size_t block_size, float buffer_time = 4.0f
+        , bool realtime = true);
+    ~DiskRecorder();
+
+    /** Start a new audio block (audio thread).
+     * This never blocks (unless @c realtime is @b false).
+     * @param rolling @b true if JACK transport is rolling
+     * @param frame JACK transport position
+     * @return @b true if the block should be recorded, i.e. if write() has to
+     *   be called for each channel.
+     **/
+    bool begin_block(bool rolling, size_t frame)
+    {
+      if (!rolling)
+      {
+        _rolling = false;
+        return false;
+      }
+
+      if (_rolling && frame != _expected_frame)
+      {
+        _jumps.fetch_add(1, std::memory_order_relaxed);
+      }
+      _rolling = true;
+      _expected_frame = frame + _block_size;
+
+      for (const auto& buffer: _buffers)
+      {
+        while (buffer->write_space() < _block_size)
+        {
+          if (_realtime)
+          {
+            _gap_frames += _block_size;
+            return false;
+          }
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+      }
+
+      if (_gap_frames)
+      {
+        Gap gap;
+        gap.index = _buffers.front()->write_index();
+        gap.frames = _gap_frames;
+        if (_gaps.write(&gap, &gap + 1) == 1) _gap_frames = 0;
+      }
+      return true;
+    }
+
+    /// Store one channel of the current block (audio thread).
+    /// @pre begin_block() returned @b true.
+    template<typename I>
+    void write(size_t channel, I first, I last)
+    {
+      _buffers[channel]->write(first, last);
+    }
+
+  private:
+    /// Frames which were dropped by the audio thread
+    struct Gap
+    {
+      size_t index;  ///< position in the ring buffers where the gap starts
+      size_t frames;
+    };
+
+    void _writer();
+    bool _write(bool drain);
+    void _error();
+
+    const std::string _file_name;
+    const size_t _block_size;
+    const bool _realtime;
+
+    std::vector<std::unique_ptr<apf::RingBuffer<float>>> _buffers;
+    apf::RingBuffer<Gap> _gaps;
+
+    // only used by the audio thread:
+    bool _rolling;
+    size_t _expected_frame;  ///< transport position of the next block
+    size_t _gap_frames;  ///< dropped frames which are not yet in _gaps
+
+    /// number of jumps of the transport position (written by audio thread)
+    std::atomic<size_t> _jumps;
+
+    // only used by the writer thread:
+    class File;
+    std::unique_ptr<File> _file;
+    Gap _next_gap;
+    bool _have_gap;
+    bool _failed;  ///< @b true after a write error
+    size_t _jumps_reported;
+    size_t _dropped_frames;
+
+    std::mutex _mutex;  ///< protects _stop
+    std::condition_variable _condition;  ///< to stop the writer thread
+    bool _stop;
+    std::thread _thread;
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -33,9 +33,10 @@
 #include "loudspeakerrenderer.h"
 
 #include "apf/convolver.h"  // for apf::conv::*
-#include "apf/sndfiletools.h"  // for apf::load_sndfile
 #include "apf/combine_channels.h"  // for apf::raised_cosine_fade, ...
 
+#include "ircache.h"
+
 namespace ssr
 {
 
@@ -48,7 +49,7 @@ class GenericRenderer : public SourceToOutput<GenericRenderer
   public:
     static const char* name() { return "GenericRenderer"; }
 
-    using Input = _base::DefaultInput;
+    using Input = _base::Input;
     class Source;
     struct SourceChannel;
     class Output;
@@ -57,8 +58,12 @@ class GenericRenderer : public SourceToOutput<GenericRenderer
     GenericRenderer(const apf::parameter_map& params)
       : _base(params)
       , _fade(this->block_size())
+      , _ir_cache(this->params.get("ir_cache_dir", ""))
     {}
 
+    /// Wait for the IRs of all sources, see IrCache::wait()
+    void wait_for_background_loads() { _ir_cache.wait(); }
+
     APF_PROCESS(GenericRenderer, _base)
     {
       this->_process_list(_source_list);
@@ -66,20 +71,22 @@ class GenericRenderer : public SourceToOutput<GenericRenderer
 
   private:
     apf::raised_cosine_fade<sample_type> _fade;
+    IrCache _ir_cache;
 };
 
 struct GenericRenderer::SourceChannel : apf::has_begin_and_end<sample_type*>
 {
-  template<typename In>
-  explicit SourceChannel(const Source& s, In first, In last);
+  explicit SourceChannel(const Source& s, size_t index);
 
   // out-of-class definition because of cyclic dependencies with Source
+  void update_filter();
   void update();
   void convolve(sample_type weight);
 
   const Source& source;
+  const size_t index;  ///< Channel of the IR file
 
-  apf::conv::StaticOutput convolver;
+  apf::conv::Output convolver;
 };
 
 class GenericRenderer::Source : public _base::Source
@@ -89,58 +96,75 @@ class GenericRenderer::Source : public _base::Source
       : _base::Source(p)
       , _weighting_factor()
     {
-      using matrix_t = apf::fixed_matrix<sample_type>;
+      auto filename = p.get<std::string>("properties_file");
 
       size_t outputs = this->parent.get_output_list().size();
 
-      auto ir_file = apf::load_sndfile(
-          p.get<std::string>("properties_file"), this->parent.sample_rate()
-          , outputs);
-
-      size_t size = ir_file.frames();
-
-      auto ir_data = matrix_t(size, outputs);
-
-      // TODO: check return value?
-      ir_file.readf(ir_data.data(), size);
-
       size_t block_size = this->parent.block_size();
 
+      // Only the header is read here, the actual IRs are loaded and
+      // transformed in the background.
+      auto ir_file = IrCache::get_file_info(filename
+          , this->parent.sample_rate(), outputs);
+
       _convolver.reset(new apf::conv::Input(block_size
-            , apf::conv::min_partitions(block_size, size)));
+            , apf::conv::min_partitions(block_size, ir_file.frames)));
 
       this->sourcechannels.reserve(outputs);
 
-      for (matrix_t::slices_iterator slice = ir_data.slices.begin()
-          ; slice != ir_data.slices.end()
-          ; slice++)
+      for (size_t i = 0; i < outputs; ++i)
       {
-        this->sourcechannels.emplace_back(*this, slice->begin(), slice->end());
+        this->sourcechannels.emplace_back(*this, i);
       }
+
+      _slot = this->parent._ir_cache.load_async(filename
+          , this->parent.sample_rate(), block_size, this->parent);
     }
 
     APF_PROCESS(Source, _base::Source)
     {
-      _weighting_factor = this->weighting_factor;
+      _filters = _slot->filters.get();
+
+      // The source stays silent until its IRs are loaded
+      _weighting_factor = _filters.get() ? this->weighting_factor : 0.0f;
 
       _convolver->add_block(_input.begin());
 
+      assert(_filters.exactly_one_assignment());
       assert(_weighting_factor.exactly_one_assignment());
     }
 
+    bool load_failed() const { return _slot->failed; }
+
     apf::BlockParameter<sample_type> _weighting_factor;
 
+    // Shared with all other sources using the same IR file
+    std::shared_ptr<const IrCache::Slot> _slot;
+    apf::BlockParameter<const IrCache::filter_set_t*> _filters;
+
     std::unique_ptr<apf::conv::Input> _convolver;
 };
 
-template<typename In>
-GenericRenderer::SourceChannel::SourceChannel(const Source& s
-    , In first, In last)
+GenericRenderer::SourceChannel::SourceChannel(const Source& s, size_t i)
   : source(s)
+  , index(i)
   // TODO: assert s._convolver != 0?
-  , convolver(*s._convolver, first, last)
+  , convolver(*s._convolver)
 {}
 
+/// Install the IRs as soon as they are loaded.
+/// There is no previous filter, so no crossfade is needed while the queues of
+/// the convolver are processed.
+void GenericRenderer::SourceChannel::update_filter()
+{
+  if (!this->convolver.queues_empty()) this->convolver.rotate_queues();
+
+  if (this->source._filters.changed() && this->source._filters.get())
+  {
+    this->convolver.set_filter((*this->source._filters.get())[this->index]);
+  }
+}
+
 void GenericRenderer::SourceChannel::update()
 {
   this->convolve(this->source._weighting_factor);
@@ -162,6 +186,8 @@ class GenericRenderer::RenderFunction
     {
       _in = & in;
 
+      in.update_filter();
+
       const auto& factor = in.source._weighting_factor;
 
       using namespace apf::CombineChannelsResult;
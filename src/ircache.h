@@ -0,0 +1,831 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Shared cache for frequency-domain impulse responses.
+
+#ifndef SSR_IRCACHE_H
+#define SSR_IRCACHE_H
+
+#include <algorithm>  // for std::max_element, std::min
+#include <atomic>
+#include <cerrno>  // for errno
+#include <cmath>  // for std::abs
+#include <condition_variable>
+#include <cstdint>  // for uint64_t
+#include <cstdio>  // for std::rename, std::remove
+#include <cstdlib>  // for realpath(), std::free
+#include <cstring>  // for std::memcpy, std::memcmp
+#include <deque>
+#include <fstream>
+#include <functional>  // for std::function
+#include <iomanip>  // for std::setw, std::setfill
+#include <map>
+#include <memory>  // for std::shared_ptr, std::weak_ptr
+#include <mutex>  // for std::mutex
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>  // for std::tie
+#include <vector>
+
+#include <fcntl.h>  // for open()
+#include <sys/mman.h>  // for mmap(), munmap()
+#include <sys/stat.h>  // for stat(), mkdir()
+#include <unistd.h>  // for close(), getpid()
+
+#include "apf/convolver.h"  // for apf::conv::Filter, apf::conv::Transform
+#include "apf/sndfiletools.h"  // for apf::load_sndfile()
+#include "apf/resampler.h"  // for apf::Resampler
+#include "apf/commandqueue.h"  // for apf::CommandQueue::Command
+
+#include "ssr_global.h"  // for ERROR(), WARNING(), VERBOSE2()
+
+namespace ssr
+{
+
+/** Shared store for frequency-domain impulse responses.
+ * Several sources using the same IR file (e.g. BRIRs of the same room) get the
+ * same (immutable) partitioned filters instead of loading and transforming
+ * their own copy.
+ * Entries are reference-counted, as soon as the last user of a set of filters
+ * is gone, the memory is released.
+ *
+ * Filters can be loaded synchronously with get_filters() or in a pool of
+ * background threads with load_async().  For offline rendering, wait() can be
+ * used to get the same result as with synchronous loading.
+ *
+ * If a cache directory is given, the partitioned and coefficient-sorted
+ * filters are also stored on disk.  Later requests (also in other SSR
+ * processes or after a restart) read them from there, the IR file itself is
+ * only opened to check its header.
+ * Cache files are tagged with sample rate, block size, IR length and a
+ * fingerprint of the original file (see _fingerprint()).  If any of those
+ * doesn't match, the cache file is silently replaced.
+ * IR files with a different sample rate are resampled when they are loaded,
+ * the cache files contain the resampled filters.
+ * All public member functions can be called from several (non-realtime)
+ * threads.
+ **/
+class IrCache
+{
+  public:
+    /// One apf::conv::Filter per channel of the IR file
+    struct FilterSet : apf::fixed_vector<apf::conv::Filter>
+    {
+      FilterSet(size_t channels, size_t block_size, size_t partitions)
+        : apf::fixed_vector<apf::conv::Filter>(channels, block_size
+            , partitions)
+        , peaks(channels)
+      {}
+
+      /// Sample index of the absolute maximum of each (time-domain) IR
+      apf::fixed_vector<size_t> peaks;
+    };
+
+    using filter_set_t = FilterSet;
+    using filter_set_ptr = std::shared_ptr<const filter_set_t>;
+
+    /// Placeholder for filters which are loaded in the background.
+    /// @see load_async()
+    struct Slot
+    {
+      Slot() : failed(false) {}
+
+      /// Empty until loading has finished.
+      /// @warning This is changed in the realtime thread, it may only be
+      ///   accessed from there (or before the owner is visible to it).
+      filter_set_ptr filters;
+
+      /// Set by a loader thread if the file couldn't be loaded, #filters
+      /// stays empty in this case.  Can be read from any thread.
+      std::atomic<bool> failed;
+    };
+
+    /// Constructor.
+    /// @param cache_dir directory for cache files, if empty, nothing is
+    ///   stored on disk.
+    /// @param loader_threads number of threads used by load_async()
+    explicit IrCache(const std::string& cache_dir = ""
+        , size_t loader_threads = 2)
+      : _cache_dir(cache_dir)
+      , _unfinished_jobs(0)
+      , _loader_threads(loader_threads ? loader_threads : 1)
+      , _stop(false)
+    {}
+
+    ~IrCache();
+
+    /// Properties of an IR file after sample rate conversion.
+    struct FileInfo
+    {
+      size_t channels;
+      size_t frames;  ///< number of samples at the requested sample rate
+    };
+
+    static FileInfo get_file_info(const std::string& filename
+        , size_t sample_rate, size_t channels = 0);
+
+    filter_set_ptr get_filters(const std::string& filename
+        , size_t sample_rate, size_t block_size, size_t channels = 0
+        , size_t size = 0);
+
+    template<typename Renderer>
+    std::shared_ptr<const Slot> load_async(const std::string& filename
+        , size_t sample_rate, size_t block_size, Renderer& renderer);
+
+    void wait();
+
+  private:
+    using callback_t = std::function<void(filter_set_ptr)>;
+
+    struct Key
+    {
+      std::string filename;
+      size_t sample_rate;
+      size_t block_size;
+      size_t size;  ///< IR length (0: whole file)
+
+      bool operator<(const Key& other) const
+      {
+        return std::tie(filename, sample_rate, block_size, size)
+          < std::tie(other.filename, other.sample_rate, other.block_size
+              , other.size);
+      }
+    };
+
+    /// Header of cache files, numbers are stored in native byte order.
+    /// It is followed by the peak indices (one uint64_t per channel), the
+    /// "zero" flags of all partitions (one byte each, padded to a multiple of
+    /// 16 bytes) and finally the data of all partitions.
+    struct CacheFileHeader
+    {
+      char magic[8];
+      uint64_t fingerprint;
+      uint64_t sample_rate;
+      uint64_t block_size;
+      uint64_t size;
+      uint64_t channels;
+      uint64_t partitions;
+    };
+
+    struct Entry
+    {
+      Entry() : loading(false) {}
+
+      std::weak_ptr<const filter_set_t> filters;
+      bool loading;  ///< A loader thread is working on it
+      std::vector<callback_t> callbacks;  ///< Waiting for the loader thread
+    };
+
+    class SetFiltersCommand : public apf::CommandQueue::Command
+    {
+      public:
+        SetFiltersCommand(std::shared_ptr<Slot> slot, filter_set_ptr filters)
+          : _slot(std::move(slot))
+          , _filters(std::move(filters))
+        {}
+
+        // Swapping avoids reference counting in the realtime thread, the
+        // (empty) old value is released in the non-realtime thread.
+        virtual void execute() { std::swap(_slot->filters, _filters); }
+
+        virtual void cleanup() {}
+
+      private:
+        std::shared_ptr<Slot> _slot;
+        filter_set_ptr _filters;
+    };
+
+    filter_set_ptr _request(const Key& key, callback_t callback);
+    void _loader_thread();
+    void _remove_expired_entries();
+
+    filter_set_ptr _load(const Key& key) const;
+    static void _resample(SndfileHandle& file, const apf::Resampler& resampler
+        , apf::fixed_matrix<float>& result);
+    filter_set_ptr _read_cache_file(const std::string& name
+        , const CacheFileHeader& expected) const;
+    void _write_cache_file(const std::string& name
+        , const CacheFileHeader& header, const filter_set_t& filters) const;
+    std::string _cache_file_name(const Key& key) const;
+
+    static uint64_t _fingerprint(const std::string& filename);
+    static uint64_t _hash(const void* data, size_t size, uint64_t hash);
+    static bool _make_directories(const std::string& path);
+
+    const std::string _cache_dir;
+
+    std::map<Key, Entry> _entries;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    std::deque<Key> _jobs;
+    size_t _unfinished_jobs;  ///< including the ones still in _jobs
+    std::vector<std::thread> _threads;
+    const size_t _loader_threads;
+    bool _stop;
+};
+
+/// Destructor. Jobs which are not yet started are dropped.
+inline IrCache::~IrCache()
+{
+  {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+
+  for (auto& thread: _threads)
+  {
+    thread.join();
+  }
+}
+
+/** Check an IR file and get its size after sample rate conversion.
+ * @param filename name of the IR file
+ * @param sample_rate sample rate of the filters
+ * @param channels expected number of channels (0 for any number)
+ * @throw std::logic_error if the file cannot be opened or has the wrong
+ *   number of channels
+ **/
+inline IrCache::FileInfo
+IrCache::get_file_info(const std::string& filename, size_t sample_rate
+    , size_t channels)
+{
+  auto ir_file = apf::load_sndfile(filename, 0, channels);
+  auto info = FileInfo();
+  info.channels = ir_file.channels();
+  info.frames = apf::Resampler(ir_file.samplerate(), sample_rate)
+    .output_size(ir_file.frames());
+  return info;
+}
+
+/** Get frequency-domain filters for all channels of an IR file.
+ * If the same file was requested before with the same parameters (and the
+ * filters are still in use), the existing filters are returned.
+ * If the file is currently being loaded by a loader thread, this function
+ * waits until it's finished.
+ * @param filename name of the IR file
+ * @param sample_rate sample rate of the filters, the IR file is resampled if
+ *   necessary
+ * @param block_size audio block size of the convolver
+ * @param channels expected number of channels (0 for any number)
+ * @param size IR length (at @p sample_rate), longer IRs are truncated (0 for
+ *   whole file)
+ * @throw std::logic_error if the file cannot be loaded
+ **/
+inline IrCache::filter_set_ptr
+IrCache::get_filters(const std::string& filename, size_t sample_rate
+    , size_t block_size, size_t channels, size_t size)
+{
+  auto key = Key{filename, sample_rate, block_size, size};
+
+  filter_set_ptr result;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this, &key] () { return !_entries[key].loading; });
+    result = _entries[key].filters.lock();
+  }
+
+  if (!result)
+  {
+    // The lock is not held while loading, in the worst case a file is loaded
+    // several times concurrently and only one of the copies is kept.
+    auto loaded = _load(key);
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto& entry = _entries[key];
+    result = entry.filters.lock();
+    if (!result)
+    {
+      entry.filters = loaded;
+      result = loaded;
+    }
+    _remove_expired_entries();
+  }
+
+  if (channels && result->size() != channels)
+  {
+    throw std::logic_error("IrCache: \"" + filename + "\" has "
+        + apf::str::A2S(result->size()) + " channels instead of "
+        + apf::str::A2S(channels) + "!");
+  }
+  return result;
+}
+
+/** Load filters in the background.
+ * The IR file is only loaded and transformed once, even if it is requested
+ * several times while loading is still in progress.
+ * When it's finished, the filters are handed over to the realtime thread of
+ * @p renderer, the Slot is updated in between two audio blocks.
+ * Until then, the owner of the Slot is supposed to be silent.
+ * Errors during loading are logged, the Slot stays empty and Slot::failed is
+ * set in that case.
+ * @param filename name of the IR file
+ * @param sample_rate sample rate of the filters, the IR file is resampled if
+ *   necessary
+ * @param block_size audio block size of the convolver
+ * @param renderer used for get_scoped_lock() and its CommandQueue
+ * @return Slot which receives the filters. If they are already available,
+ *   it's filled immediately.
+ * @note The file should be checked beforehand (e.g. with get_file_info())
+ *   to get errors like missing files as exceptions in the calling thread.
+ **/
+template<typename Renderer>
+std::shared_ptr<const IrCache::Slot>
+IrCache::load_async(const std::string& filename, size_t sample_rate
+    , size_t block_size, Renderer& renderer)
+{
+  auto slot = std::make_shared<Slot>();
+  auto weak_slot = std::weak_ptr<Slot>(slot);
+
+  slot->filters = _request(Key{filename, sample_rate, block_size, 0}
+      , [weak_slot, &renderer] (filter_set_ptr filters)
+        {
+          if (!filters)
+          {
+            // The error has already been logged, the owner can report it
+            if (auto slot = weak_slot.lock()) slot->failed = true;
+            return;
+          }
+
+          auto guard = renderer.get_scoped_lock();
+          // If the Slot is gone, the owner was removed in the meantime
+          if (auto slot = weak_slot.lock())
+          {
+            renderer._fifo.push(new SetFiltersCommand(slot, filters));
+          }
+        });
+
+  return slot;
+}
+
+/** Wait until all jobs started by load_async() are finished.
+ * When this returns, the filters have been handed over to the CommandQueue
+ * of the renderer, the Slot%s are updated before the next audio block.
+ * @warning The lock of the renderer (see load_async()) must not be held!
+ **/
+inline void
+IrCache::wait()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _condition.wait(lock, [this] () { return _stop || _unfinished_jobs == 0; });
+}
+
+/** Return cached filters or enqueue a job for the loader threads.
+ * @return filters, if available. Otherwise, @p callback will be called from a
+ *   loader thread later.
+ **/
+inline IrCache::filter_set_ptr
+IrCache::_request(const Key& key, callback_t callback)
+{
+  std::lock_guard<std::mutex> guard(_mutex);
+
+  auto& entry = _entries[key];
+  if (auto result = entry.filters.lock()) return result;
+
+  entry.callbacks.push_back(std::move(callback));
+
+  if (!entry.loading)
+  {
+    entry.loading = true;
+    _jobs.push_back(key);
+    ++_unfinished_jobs;
+
+    // Threads are only started when needed for the first time
+    if (_threads.empty())
+    {
+      for (size_t i = 0; i < _loader_threads; ++i)
+      {
+        _threads.emplace_back(&IrCache::_loader_thread, this);
+      }
+    }
+    _condition.notify_all();
+  }
+  return filter_set_ptr();
+}
+
+inline void
+IrCache::_loader_thread()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  for (;;)
+  {
+    _condition.wait(lock, [this] () { return _stop || !_jobs.empty(); });
+
+    if (_stop) break;
+
+    auto key = _jobs.front();
+    _jobs.pop_front();
+
+    lock.unlock();
+
+    filter_set_ptr filters;
+    try
+    {
+      filters = _load(key);
+    }
+    catch (const std::exception& e)
+    {
+      ERROR("Couldn't load \"" << key.filename << "\": " << e.what()
+          << " (sources using it stay silent)");
+    }
+
+    lock.lock();
+
+    auto& entry = _entries[key];
+    entry.filters = filters;
+    entry.loading = false;
+    auto callbacks = std::move(entry.callbacks);
+    entry.callbacks.clear();
+    _remove_expired_entries();
+
+    // Wake up get_filters() if it is waiting for this entry
+    _condition.notify_all();
+
+    lock.unlock();
+
+    // The callbacks may take other locks, so _mutex must not be held here
+    for (auto& callback: callbacks)
+    {
+      callback(filters);
+    }
+
+    lock.lock();
+
+    --_unfinished_jobs;
+    // Wake up wait()
+    _condition.notify_all();
+  }
+}
+
+/// @attention _mutex must be locked!
+inline void
+IrCache::_remove_expired_entries()
+{
+  for (auto it = _entries.begin(); it != _entries.end(); )
+  {
+    if (it->second.filters.expired() && !it->second.loading)
+    {
+      it = _entries.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+inline IrCache::filter_set_ptr
+IrCache::_load(const Key& key) const
+{
+  auto ir_file = apf::load_sndfile(key.filename, 0, 0);
+
+  size_t no_of_channels = ir_file.channels();
+  auto resampler = apf::Resampler(ir_file.samplerate(), key.sample_rate);
+  size_t size = resampler.output_size(ir_file.frames());
+  if (key.size) size = std::min(size, key.size);
+
+  size_t partitions = apf::conv::min_partitions(key.block_size, size);
+
+  auto header = CacheFileHeader();
+  // Increment the version whenever the content of cache files changes
+  std::copy_n("SSRIRC2", 8, header.magic);
+  header.sample_rate = key.sample_rate;
+  header.block_size = key.block_size;
+  header.size = key.size;
+  header.channels = no_of_channels;
+  header.partitions = partitions;
+
+  auto cache_file = std::string();
+  if (_cache_dir != "")
+  {
+    header.fingerprint = _fingerprint(key.filename);
+    cache_file = _cache_file_name(key);
+
+    if (auto filters = _read_cache_file(cache_file, header))
+    {
+      VERBOSE2("IrCache: Using \"" << cache_file << "\" for \""
+          << key.filename << "\".");
+      return filters;
+    }
+  }
+
+  auto ir_data = apf::fixed_matrix<float>(size, no_of_channels);
+
+  if (resampler.identity())
+  {
+    // TODO: check return value?
+    ir_file.readf(ir_data.data(), size);
+  }
+  else
+  {
+    VERBOSE2("IrCache: Resampling \"" << key.filename << "\" from "
+        << ir_file.samplerate() << " Hz to " << key.sample_rate << " Hz.");
+    _resample(ir_file, resampler, ir_data);
+  }
+
+  auto filters = std::make_shared<filter_set_t>(no_of_channels
+      , key.block_size, partitions);
+
+  auto temp = apf::conv::Transform(key.block_size);
+
+  auto target = filters->begin();
+  auto peak = filters->peaks.begin();
+  for (const auto& slice: ir_data.slices)
+  {
+    temp.prepare_filter(slice.begin(), slice.end(), *target++);
+
+    *peak++ = std::distance(slice.begin(), std::max_element(slice.begin()
+          , slice.end(), [] (float left, float right)
+          {
+            return std::abs(left) < std::abs(right);
+          }));
+  }
+  assert(target == filters->end());
+
+  if (cache_file != "")
+  {
+    _write_cache_file(cache_file, header, *filters);
+  }
+
+  return filters;
+}
+
+/** Read a whole IR file and convert it to the sample rate of @p resampler.
+ * The IRs are scaled with the ratio of the sample rates to keep their
+ * frequency response the same.
+ * @param file IR file
+ * @param resampler sample rate converter
+ * @param result target, if it's shorter than the resampled IRs, they are
+ *   truncated.
+ **/
+inline void
+IrCache::_resample(SndfileHandle& file, const apf::Resampler& resampler
+    , apf::fixed_matrix<float>& result)
+{
+  size_t frames = file.frames();
+  auto input = apf::fixed_matrix<float>(frames, file.channels());
+  // TODO: check return value?
+  file.readf(input.data(), frames);
+
+  float gain = static_cast<float>(resampler.down())
+    / static_cast<float>(resampler.up());
+  auto temp = std::vector<float>(resampler.output_size(frames));
+
+  auto target = result.slices.begin();
+  for (const auto& slice: input.slices)
+  {
+    resampler.process(slice.begin(), slice.end(), temp.begin());
+    auto in = temp.begin();
+    for (auto& sample: *target++)
+    {
+      sample = *in++ * gain;
+    }
+  }
+}
+
+/** Load filters from a cache file.
+ * The file is mapped into memory and the partitions are copied into (properly
+ * aligned) apf::conv::Filter storage, no FFTs are necessary.
+ * @return Empty pointer if the file doesn't exist or doesn't match.
+ **/
+inline IrCache::filter_set_ptr
+IrCache::_read_cache_file(const std::string& name
+    , const CacheFileHeader& expected) const
+{
+  int fd = ::open(name.c_str(), O_RDONLY);
+  if (fd == -1) return filter_set_ptr();
+
+  struct stat info;
+  void* mapping = MAP_FAILED;
+  if (::fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(expected))
+  {
+    mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);  // the mapping stays valid
+
+  if (mapping == MAP_FAILED) return filter_set_ptr();
+
+  // Unmap when leaving this function (also if an exception is thrown)
+  auto unmap = std::unique_ptr<void, std::function<void(void*)>>(mapping
+      , [&info] (void* ptr) { ::munmap(ptr, info.st_size); });
+
+  auto data = static_cast<const char*>(mapping);
+
+  auto header = CacheFileHeader();
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(&header, &expected, sizeof(header)) != 0)
+  {
+    return filter_set_ptr();
+  }
+
+  size_t channels = header.channels;
+  size_t partitions = header.partitions;
+  size_t partition_size = 2 * header.block_size;
+
+  size_t flags_size = (channels * partitions + 15) / 16 * 16;
+  size_t offset = sizeof(header) + channels * sizeof(uint64_t);
+
+  if (size_t(info.st_size) != offset + flags_size
+      + channels * partitions * partition_size * sizeof(float))
+  {
+    WARNING("IrCache: \"" << name << "\" has the wrong size!");
+    return filter_set_ptr();
+  }
+
+  auto filters = std::make_shared<filter_set_t>(channels, header.block_size
+      , partitions);
+
+  auto peaks = data + sizeof(header);
+  for (auto& peak: filters->peaks)
+  {
+    uint64_t temp;
+    std::memcpy(&temp, peaks, sizeof(temp));
+    peak = temp;
+    peaks += sizeof(temp);
+  }
+
+  auto flags = data + offset;
+  auto floats = data + offset + flags_size;
+
+  for (auto& filter: *filters)
+  {
+    for (auto& partition: filter)
+    {
+      partition.zero = *flags++ != 0;
+      std::memcpy(partition.data(), floats, partition_size * sizeof(float));
+      floats += partition_size * sizeof(float);
+    }
+  }
+  return filters;
+}
+
+/** Store filters in a cache file.
+ * The file is written under a temporary name and renamed afterwards, so other
+ * processes never see incomplete files.
+ * Errors are reported, but otherwise ignored.
+ **/
+inline void
+IrCache::_write_cache_file(const std::string& name
+    , const CacheFileHeader& header, const filter_set_t& filters) const
+{
+  if (!_make_directories(_cache_dir))
+  {
+    WARNING("IrCache: Couldn't create directory \"" << _cache_dir << "\"!");
+    return;
+  }
+
+  // Process and thread ID make the temporary name unique
+  auto temp_name = name + ".tmp" + apf::str::A2S(::getpid()) + "-"
+    + apf::str::A2S(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+  {
+    std::ofstream file(temp_name.c_str(), std::ios::binary);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (uint64_t peak: filters.peaks)
+    {
+      file.write(reinterpret_cast<const char*>(&peak), sizeof(peak));
+    }
+
+    auto flags = std::vector<char>(
+        (header.channels * header.partitions + 15) / 16 * 16);
+    auto flag = flags.begin();
+    for (const auto& filter: filters)
+    {
+      for (const auto& partition: filter)
+      {
+        *flag++ = partition.zero;
+      }
+    }
+    file.write(flags.data(), flags.size());
+
+    for (const auto& filter: filters)
+    {
+      for (const auto& partition: filter)
+      {
+        file.write(reinterpret_cast<const char*>(partition.data())
+            , partition.size() * sizeof(float));
+      }
+    }
+
+    if (!file)
+    {
+      WARNING("IrCache: Couldn't write \"" << temp_name << "\"!");
+      file.close();
+      std::remove(temp_name.c_str());
+      return;
+    }
+  }
+
+  if (std::rename(temp_name.c_str(), name.c_str()) != 0)
+  {
+    WARNING("IrCache: Couldn't rename \"" << temp_name << "\"!");
+    std::remove(temp_name.c_str());
+  }
+}
+
+/// The file name is a hash of the IR file name (with absolute path) and the
+/// parameters which influence the result.
+inline std::string
+IrCache::_cache_file_name(const Key& key) const
+{
+  auto path = key.filename;
+
+  if (char* absolute = ::realpath(key.filename.c_str(), nullptr))
+  {
+    path = absolute;
+    std::free(absolute);
+  }
+
+  uint64_t numbers[] = { key.sample_rate, key.block_size, key.size };
+
+  auto hash = _hash(path.data(), path.size(), 0);
+  hash = _hash(numbers, sizeof(numbers), hash);
+
+  std::ostringstream name;
+  name << _cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+    << hash << ".ssrir";
+  return name.str();
+}
+
+/** Fingerprint of a file.
+ * Instead of hashing the whole content (which would defeat the purpose of the
+ * cache), device, inode, size and modification time are used.
+ * @return 0 if the file doesn't exist.
+ **/
+inline uint64_t
+IrCache::_fingerprint(const std::string& filename)
+{
+  struct stat info;
+  if (::stat(filename.c_str(), &info) != 0) return 0;
+
+  uint64_t numbers[] = { uint64_t(info.st_dev), uint64_t(info.st_ino)
+    , uint64_t(info.st_size), uint64_t(info.st_mtime) };
+
+  return _hash(numbers, sizeof(numbers), 0);
+}
+
+/// 64-bit FNV-1a hash. @param hash result of a previous call (or 0)
+inline uint64_t
+IrCache::_hash(const void* data, size_t size, uint64_t hash)
+{
+  if (hash == 0) hash = 14695981039346656037ull;
+
+  auto bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/// Create directory @p path and all of its parents (like "mkdir -p").
+inline bool
+IrCache::_make_directories(const std::string& path)
+{
+  for (auto pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+  {
+    auto dir = path.substr(0, pos);
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    if (pos == std::string::npos) break;
+  }
+  return true;
+}
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
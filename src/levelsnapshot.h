@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Snapshot of all signal levels (definition).
+
+#ifndef SSR_LEVELSNAPSHOT_H
+#define SSR_LEVELSNAPSHOT_H
+
+#include <vector>
+#include <memory>  // for std::shared_ptr
+#include <algorithm>  // for std::lower_bound(), std::sort(), std::fill_n()
+#include <utility>  // for std::pair
+
+#include "ssr_global.h"  // for id_t
+
+namespace ssr
+{
+
+/** Signal levels of all sources (and the master level) at one point in time.
+ * A snapshot is created by the Controller and handed to all subscribers as a
+ * whole.  Once published, it is never modified, therefore it can be kept and
+ * read from any thread without locking.
+ **/
+struct LevelSnapshot
+{
+  using ptr = std::shared_ptr<const LevelSnapshot>;
+
+  LevelSnapshot()
+    : version(0)
+    , master(0.0f)
+    , outputs(0)
+  {}
+
+  /// Find the index of a source.
+  /// @return index into @c ids, @c ids.size() if @p id is not found
+  size_t find(id_t id) const
+  {
+    auto i = std::lower_bound(ids.begin(), ids.end(), id);
+    if (i == ids.end() || *i != id) return ids.size();
+    return static_cast<size_t>(i - ids.begin());
+  }
+
+  /// Output levels of the source with the given index (@c outputs values).
+  /// @pre @c outputs != 0
+  const float* output_levels_of(size_t index) const
+  {
+    return &output_levels[index * outputs];
+  }
+
+  unsigned long version;  ///< incremented with each new snapshot
+  float master;  ///< overall signal level (linear scale)
+  /// number of output levels per source, 0 if not available
+  size_t outputs;
+  std::vector<id_t> ids;  ///< source IDs (in ascending order)
+  std::vector<float> source_levels;  ///< one level per source (linear scale)
+  std::vector<float> output_levels;  ///< @c outputs values per source
+};
+
+/** Output levels of all sources for a LevelSnapshot.
+ * The levels are collected in the order of the source list of the renderer
+ * (see query()), but the snapshot needs them in the order of the source IDs.
+ * The sources are matched by their address, because the source list and the
+ * source map may be in a different order (and may have changed in between).
+ * @tparam Source renderer source, needs a member function
+ *   <tt>bool get_output_levels(float* first, float* last) const</tt>
+ **/
+template<typename Source>
+class SourceOutputLevels
+{
+  public:
+    SourceOutputLevels() : _queried(0), _available(false) {}
+
+    /// Get the output levels of all sources.
+    /// No memory is allocated, this can be used in the audio thread.
+    /// If there are more sources than prepared with reserve(), their levels
+    /// are missing (see copy_to()).
+    template<typename SourceList>
+    void query(const SourceList& source_list, size_t outputs)
+    {
+      _queried = 0;
+      _available = true;
+      for (const Source& source: source_list)
+      {
+        if (_queried == _sources.size()
+            || (_queried + 1) * outputs > _levels.size())
+        {
+          break;
+        }
+        float* first = _levels.data() + _queried * outputs;
+        _available &= source.get_output_levels(first, first + outputs);
+        _sources[_queried++] = &source;
+      }
+    }
+
+    /// Store the output levels in @p snapshot (and set its @c outputs).
+    /// Sources which were not queried get zeros.
+    /// @param source_map ID and Source pointer of all sources (sorted by ID,
+    ///   like the @c ids of @p snapshot)
+    /// @param outputs number of outputs (the same as in query())
+    template<typename SourceMap>
+    void copy_to(LevelSnapshot& snapshot, const SourceMap& source_map
+        , size_t outputs)
+    {
+      snapshot.outputs = _available ? outputs : 0;
+      if (snapshot.outputs == 0) return;
+
+      _order.clear();
+      for (size_t i = 0; i < _queried; ++i)
+      {
+        _order.emplace_back(_sources[i], i);
+      }
+      std::sort(_order.begin(), _order.end());
+
+      snapshot.output_levels.resize(source_map.size() * outputs);
+      auto target = snapshot.output_levels.begin();
+
+      for (const auto& item: source_map)
+      {
+        const Source* source = static_cast<const Source*>(item.second);
+        auto found = std::lower_bound(_order.begin(), _order.end()
+            , std::make_pair(source, size_t()));
+        if (found != _order.end() && found->first == source)
+        {
+          const float* first = _levels.data() + found->second * outputs;
+          target = std::copy(first, first + outputs, target);
+        }
+        else
+        {
+          target = std::fill_n(target, outputs, 0.0f);
+        }
+      }
+    }
+
+    /// Make room for query().  Memory is never released.
+    void reserve(size_t sources, size_t outputs)
+    {
+      if (sources > _sources.size()) _sources.resize(sources);
+      if (sources * outputs > _levels.size()) _levels.resize(sources * outputs);
+      _order.reserve(_sources.size());
+    }
+
+  private:
+    std::vector<float> _levels;  ///< in the order of the source list
+    std::vector<const Source*> _sources;  ///< see _levels
+    size_t _queried;  ///< number of valid entries in _sources
+    bool _available;  ///< @b false if any source didn't provide levels
+    /// Addresses of the queried sources (and their index), sorted by address
+    std::vector<std::pair<const Source*, size_t>> _order;
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
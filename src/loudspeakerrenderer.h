@@ -30,10 +30,14 @@
 #ifndef SSR_LOUDSPEAKERRENDERER_H
 #define SSR_LOUDSPEAKERRENDERER_H
 
+#include <algorithm>  // for std::swap_ranges(), std::transform(), std::min()
+#include <functional>  // for std::plus
+
 #include "rendererbase.h"
 #include "loudspeaker.h"
 #include "xmlparser.h"
 #include "apf/parameter_map.h"
+#include "apf/biquad.h"  // for apf::BiQuadBank, apf::butterworth_lowpass(), ...
 
 namespace ssr
 {
@@ -46,14 +50,50 @@ class LoudspeakerRenderer : public RendererBase<Derived>
     using Node = XMLParser::Node;
 
   public:
+    using sample_type = typename _base::sample_type;
+
     class Output : public _base::Output, public Loudspeaker
     {
       public:
         struct Params : _base::Output::Params, Loudspeaker {};
 
-        // TODO: handle loudspeaker delays?
-
-        Output(const Params& p) : _base::Output(p), Loudspeaker(p) {}
+        Output(const Params& p)
+          : _base::Output(p)
+          , Loudspeaker(p)
+          , _delay_samples(static_cast<size_t>(
+                this->delay * static_cast<float>(this->parent.sample_rate())
+                + 0.5f))
+          , _delay_offset(this->parent._delay_buffer_size)
+          , _delay_position(0)
+        {
+          // reserve a section of the shared delay buffer
+          this->parent._delay_buffer_size += _delay_samples;
+        }
+
+        /// Loudspeaker delay and weight are applied after the derived class
+        /// has done its processing.  With bass management, this has to wait
+        /// for the crossover, see LoudspeakerRenderer::PostProcess.
+        struct Process : _base::Output::Process
+        {
+          explicit Process(Output& o) : _base::Output::Process(o), _out(o) {}
+
+          ~Process()
+          {
+            if (!_out._post_processing) _out._apply_delay_and_weight();
+          }
+
+          private:
+            Output& _out;
+        };
+
+      private:
+        friend class LoudspeakerRenderer<Derived>;
+
+        void _apply_delay_and_weight();
+
+        const size_t _delay_samples;
+        const size_t _delay_offset;  ///< start of delay line in shared buffer
+        size_t _delay_position;  ///< position of oldest sample in delay line
     };
 
     LoudspeakerRenderer(const apf::parameter_map& p)
@@ -61,6 +101,9 @@ class LoudspeakerRenderer : public RendererBase<Derived>
       , _reproduction_setup(p.get("reproduction_setup", ""))
       , _xml_schema(p.get("xml_schema", ""))
       , _next_loudspeaker_channel(1)
+      , _delay_buffer_size(0)
+      , _crossover_frequency(0.0f)
+      , _subwoofer_gain(0.0f)
     {
       this->_show_head = false;
     }
@@ -69,7 +112,20 @@ class LoudspeakerRenderer : public RendererBase<Derived>
 
     void get_loudspeakers(std::vector<Loudspeaker>& l);
 
+    /// Bass management is done after all outputs have been processed, but
+    /// before the loudspeaker delays and weights are applied.
+    struct PostProcess : _base::PostProcess
+    {
+      explicit PostProcess(Derived& d) : _base::PostProcess(d)
+      {
+        d._bass_management();
+      }
+    };
+
   private:
+    void _setup_bass_management();
+    void _bass_management();
+
     void _load_loudspeaker(const Node& node);
     void _load_linear_array(const Node& node);
     void _load_circular_array(const Node& node);
@@ -83,6 +139,22 @@ class LoudspeakerRenderer : public RendererBase<Derived>
     const std::string _xml_schema;
 
     int _next_loudspeaker_channel;
+
+    /// Delay lines of all loudspeakers, stored contiguously
+    apf::fixed_vector<sample_type> _delay_buffer;
+    size_t _delay_buffer_size;
+
+    /// @name Bass management
+    /// @{
+    float _crossover_frequency;  ///< in Hertz, 0 means no bass management
+    /// Linkwitz-Riley filters: highpass for normal loudspeakers, lowpass for
+    /// subwoofers.  Double precision is used because for low crossover
+    /// frequencies the poles are very close to the unit circle.
+    std::unique_ptr<apf::BiQuadBank<double>> _crossover;
+    apf::fixed_vector<sample_type*> _output_buffers;
+    apf::fixed_vector<sample_type> _bass;  ///< sum of all normal loudspeakers
+    sample_type _subwoofer_gain;
+    /// @}
 };
 
 template<typename Derived>
@@ -152,6 +224,18 @@ LoudspeakerRenderer<Derived>::load_reproduction_setup()
     {
       _load_circular_array(node);
     }
+    else if (node == "bass_management")
+    {
+      _crossover_frequency = apf::str::S2RV(
+          node.get_attribute("crossover_frequency"), 80.0f);
+
+      if (_crossover_frequency <= 0.0f || _crossover_frequency
+          >= static_cast<float>(this->sample_rate()) / 2.0f)
+      {
+        throw std::runtime_error("Invalid crossover frequency for bass "
+            "management in the file \"" + _reproduction_setup + "\"!");
+      }
+    }
     else if (node == "skip")
     {
       int number = 1;
@@ -180,6 +264,142 @@ LoudspeakerRenderer<Derived>::load_reproduction_setup()
 
   //VERBOSE("Loaded " << l.size() << " loudspeakers from '"
   //    << setup_file_name << "'.");
+
+  // all loudspeakers have reserved their part of the delay buffer
+  _delay_buffer.resize(_delay_buffer_size);
+
+  if (_crossover_frequency > 0.0f) _setup_bass_management();
+}
+
+template<typename Derived>
+void
+LoudspeakerRenderer<Derived>::_setup_bass_management()
+{
+  auto outputs = apf::make_cast_proxy<typename Derived::Output>(
+      const_cast<typename _base::rtlist_t&>(this->get_output_list()));
+
+  _crossover.reset(new apf::BiQuadBank<double>(outputs.size(), 2));
+
+  auto fc = static_cast<double>(_crossover_frequency);
+  auto fs = static_cast<double>(this->sample_rate());
+  // Two identical Butterworth sections form a Linkwitz-Riley filter
+  apf::SosCoefficients<double> lowpass[] = {
+    apf::butterworth_lowpass(fc, fs), apf::butterworth_lowpass(fc, fs) };
+  apf::SosCoefficients<double> highpass[] = {
+    apf::butterworth_highpass(fc, fs), apf::butterworth_highpass(fc, fs) };
+
+  size_t channel = 0, subwoofers = 0;
+  for (auto& out: outputs)
+  {
+    // delay, weight and level metering are done after the crossover
+    out._post_processing = true;
+
+    if (out.model == Loudspeaker::subwoofer)
+    {
+      _crossover->set(channel, lowpass, lowpass + 2);
+      ++subwoofers;
+    }
+    else
+    {
+      _crossover->set(channel, highpass, highpass + 2);
+    }
+    ++channel;
+  }
+
+  if (subwoofers == 0)
+  {
+    throw std::runtime_error(
+        "Bass management is not possible without subwoofers!");
+  }
+
+  // the low frequency part is distributed evenly to all subwoofers
+  _subwoofer_gain = 1.0f / static_cast<sample_type>(subwoofers);
+
+  _output_buffers.resize(outputs.size());
+  _bass.resize(this->block_size());
+}
+
+template<typename Derived>
+void
+LoudspeakerRenderer<Derived>::_bass_management()
+{
+  if (!_crossover) return;
+
+  using out_list_t
+    = typename _base::template rtlist_proxy<typename Derived::Output>;
+
+  std::fill(_bass.begin(), _bass.end(), sample_type());
+
+  // output buffers may change from block to block
+  auto buffer = _output_buffers.begin();
+  for (const auto& out: out_list_t(this->get_output_list()))
+  {
+    *buffer++ = out.buffer.begin();
+
+    if (out.model != Loudspeaker::subwoofer)
+    {
+      std::transform(_bass.begin(), _bass.end(), out.buffer.begin()
+          , _bass.begin(), std::plus<sample_type>());
+    }
+  }
+
+  const auto gain = _subwoofer_gain;
+  for (const auto& out: out_list_t(this->get_output_list()))
+  {
+    if (out.model == Loudspeaker::subwoofer)
+    {
+      std::transform(_bass.begin(), _bass.end(), out.buffer.begin()
+          , out.buffer.begin(), [gain] (sample_type bass, sample_type in)
+          {
+            return in + gain * bass;
+          });
+    }
+  }
+
+  // Linkwitz-Riley highpass for normal loudspeakers and lowpass for
+  // subwoofers, all in one go
+  _crossover->execute(_output_buffers.begin(), _output_buffers.end()
+      , this->block_size());
+
+  // this was skipped in Output::Process
+  for (auto& out: apf::make_cast_proxy<typename Derived::Output>(
+        const_cast<typename _base::rtlist_t&>(this->get_output_list())))
+  {
+    out._apply_delay_and_weight();
+    out._level_helper(out.parent);
+  }
+}
+
+template<typename Derived>
+void
+LoudspeakerRenderer<Derived>::Output::_apply_delay_and_weight()
+{
+  if (_delay_samples > 0)
+  {
+    // The delay line is a ring buffer holding the last _delay_samples input
+    // samples.  Swapping its contents with the output buffer yields the
+    // delayed signal and stores the new samples at the same time.
+    assert(_delay_offset + _delay_samples <= this->parent._delay_buffer.size());
+    auto delay_line = this->parent._delay_buffer.begin() + _delay_offset;
+
+    auto current = this->buffer.begin();
+    while (current != this->buffer.end())
+    {
+      auto chunk = std::min(static_cast<size_t>(this->buffer.end() - current)
+          , _delay_samples - _delay_position);
+      current = std::swap_ranges(delay_line + _delay_position
+          , delay_line + _delay_position + chunk, current);
+      _delay_position += chunk;
+      if (_delay_position == _delay_samples) _delay_position = 0;
+    }
+  }
+
+  if (this->weight != 1.0f)
+  {
+    const auto w = this->weight;
+    std::transform(this->buffer.begin(), this->buffer.end()
+        , this->buffer.begin(), [w] (sample_type in) { return in * w; });
+  }
 }
 
 template<typename Derived>
@@ -101,6 +101,8 @@ class NfcHoaRenderer::Source : public _base::Source
     void connect();
     void disconnect();
 
+    void reset();
+
     APF_PROCESS(Source, _base::Source)
     {
       // NOTE: reference offset is not taken into account!
@@ -335,6 +337,21 @@ NfcHoaRenderer::Source::Source(const Params& p)
   , source_model(coeff_t::source_t(-1))
 {}
 
+/// A pooled Source gets the same values as a new one, otherwise its filter
+/// coefficients wouldn't be computed if it re-appears at the same distance.
+/// The Mode%s (with their filter states and coefficients) don't have to be
+/// reset, they are re-created in connect().
+void
+NfcHoaRenderer::Source::reset()
+{
+  assert(_mode_pairs.empty());
+
+  _base::Source::reset();
+  distance = apf::BlockParameter<float>(-1.0f);
+  angle = apf::BlockParameter<float>(std::numeric_limits<float>::infinity());
+  source_model = apf::BlockParameter<coeff_t::source_t>(coeff_t::source_t(-1));
+}
+
 class NfcHoaRenderer::RenderFunction
 {
   public:
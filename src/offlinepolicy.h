@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Interface policy for offline rendering (without JACK).
+
+#ifndef SSR_OFFLINEPOLICY_H
+#define SSR_OFFLINEPOLICY_H
+
+#include <utility>  // for std::pair
+#include <cstdint>  // for uint32_t
+
+#ifndef APF_MIMOPROCESSOR_INTERFACE_POLICY
+#define APF_MIMOPROCESSOR_INTERFACE_POLICY ssr::offline_policy
+#endif
+
+#include "apf/pointer_policy.h"
+
+namespace ssr
+{
+
+/** @c interface_policy for rendering without JACK and without realtime
+ * constraints.
+ * Audio data is passed to audio_callback() like with apf::pointer_policy.
+ * JACK transport is emulated: while it is rolling, the position is advanced
+ * by one block in each audio_callback().
+ * @see ssr_offline.cpp
+ **/
+class offline_policy : public apf::pointer_policy<float*>
+{
+  private:
+    using _base = apf::pointer_policy<float*>;
+
+  public:
+    using nframes_t = uint32_t;  ///< like @c jack_nframes_t
+
+    /// DiskPlayer and DiskRecorder wait for the disk instead of dropping
+    /// samples, see internal::is_realtime().
+    static const bool realtime = false;
+
+    void audio_callback(int n, float* const* in, float* const* out)
+    {
+      _base::audio_callback(n, in, out);
+      if (_rolling) _frame += static_cast<nframes_t>(n);
+    }
+
+    /// @name emulated JACK transport
+    //@{
+    void transport_start() { _rolling = true; }
+    void transport_stop() { _rolling = false; }
+    bool transport_locate(nframes_t frame) { _frame = frame; return true; }
+
+    std::pair<bool, nframes_t> get_transport_state() const
+    {
+      return {_rolling, _frame};
+    }
+    //@}
+
+    /// There is no realtime thread, nothing to be done.
+    bool set_freewheel(int) const { return true; }
+
+    /// There is no time limit, therefore no meaningful CPU load.
+    float get_cpu_load() const { return 0.0f; }
+
+  protected:
+    /// Constructor
+    /// @param p Parameters, @c "sample_rate" and @c "block_size" are needed.
+    explicit offline_policy(const apf::parameter_map& p = apf::parameter_map())
+      : _base(p)
+      , _rolling(false)
+      , _frame(0)
+    {}
+
+    virtual ~offline_policy() = default;
+
+  private:
+    bool _rolling;
+    nframes_t _frame;  ///< transport position of the current block
+};
+
+}  // namespace ssr
+
+#endif
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
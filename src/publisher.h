@@ -156,6 +156,8 @@ struct Publisher
 
   virtual void subscribe(Subscriber* subscriber) = 0;
   virtual void unsubscribe(Subscriber* subscriber) = 0;
+  /// send the whole scene to a subscriber which was added with subscribe()
+  virtual void replay_scene(Subscriber* subscriber) = 0;
   virtual std::string get_scene_as_XML() const = 0;
 };
 
@@ -31,17 +31,27 @@
 #define SSR_RENDERERBASE_H
 
 #include <string>
+#include <vector>
+#include <map>
+#include <memory>  // for std::shared_ptr, std::unique_ptr, std::atomic_load()
+#include <atomic>
+#include <utility>  // for std::pair
+#include <iterator>  // for std::forward_iterator_tag
 
 #include "apf/mimoprocessor.h"
 #include "apf/shareddata.h"
 #include "apf/container.h"  // for distribute_list()
 #include "apf/parameter_map.h"
+#include "apf/stringtools.h"  // for A2S()
 #include "apf/math.h"  // for dB2linear()
+#include "apf/levelmeter.h"  // for apf::LevelMeter
 
 // TODO: avoid multiple ambiguous "Source" classes
 #include "source.h"  // for ::Source::model_t
 
 #include "maptools.h"
+#include "diskplayer.h"  // for DiskPlayer::Track
+#include "diskrecorder.h"
 
 #ifndef SSR_QUERY_POLICY
 #define SSR_QUERY_POLICY apf::disable_queries
@@ -50,6 +60,125 @@
 namespace ssr
 {
 
+namespace internal
+{
+
+/// JACK transport state (if the interface policy provides it).
+template<typename T>
+auto transport_state(const T& renderer, int)
+  -> decltype(renderer.get_transport_state())
+{
+  return renderer.get_transport_state();
+}
+
+/// Without transport, audio files are not played.
+template<typename T>
+std::pair<bool, size_t> transport_state(const T&, long)
+{
+  return {false, 0};
+}
+
+/// Connect an existing port to another one (if the interface policy has
+/// ports), all previous connections are removed.
+template<typename T>
+auto reconnect_port(T& input, const std::string& connect_to, int)
+  -> decltype(input.reconnect(connect_to))
+{
+  return input.reconnect(connect_to);
+}
+
+/// Without ports, there is nothing to connect.
+template<typename T>
+void reconnect_port(T&, const std::string&, long) {}
+
+}  // namespace internal
+
+/** Singly linked list of channels which are active in the current block.
+ * The list is intrusive, i.e. the items (typically SourceChannels) have to
+ * provide the link themselves by deriving from ActiveList::Hook.
+ * Nothing is allocated, therefore the list can be re-built in the realtime
+ * thread in each audio block.
+ * An item can only be in one ActiveList at a time.
+ * @see RendererBase::_distribute_active_channels()
+ **/
+template<typename T>
+class ActiveList
+{
+  public:
+    using value_type = T;
+
+    class Hook
+    {
+      private:
+        friend class ActiveList<T>;
+        T* _next_active = nullptr;
+    };
+
+    class iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        explicit iterator(T* item = nullptr) : _item(item) {}
+
+        reference operator*() const { return *_item; }
+        pointer operator->() const { return _item; }
+
+        iterator& operator++()
+        {
+          _item = ActiveList::_next(_item);
+          return *this;
+        }
+
+        iterator operator++(int)
+        {
+          auto temp = *this;
+          ++*this;
+          return temp;
+        }
+
+        bool operator==(const iterator& rhs) const { return _item == rhs._item; }
+        bool operator!=(const iterator& rhs) const { return _item != rhs._item; }
+
+      private:
+        T* _item;
+    };
+
+    iterator begin() const { return iterator(_first); }
+    iterator end() const { return iterator(); }
+
+    bool empty() const { return _first == nullptr; }
+
+    void clear() { _first = nullptr; }
+
+    void push_front(T& item)
+    {
+      static_cast<Hook&>(item)._next_active = _first;
+      _first = &item;
+    }
+
+    /// Remove first item.
+    /// @return pointer to removed item, @c nullptr if the list was empty
+    T* pop_front()
+    {
+      auto item = _first;
+      if (item) _first = _next(item);
+      return item;
+    }
+
+  private:
+    static T* _next(T* item)
+    {
+      return static_cast<Hook*>(item)->_next_active;
+    }
+
+    T* _first = nullptr;
+};
+
 /** Renderer base class.
  * @todo more documentation!
  *
@@ -57,6 +186,17 @@ namespace ssr
  * communicate between realtime and non-realtime threads.
  * All non-realtime accesses to RtList%s have to be locked with
  * get_scoped_lock() to ensure single-reader/single-writer operation.
+ *
+ * Sources are constructed without holding this lock, only the finished
+ * Source (and its Input) is handed over to the realtime thread while it is
+ * locked.  The map of sources (see get_source_map()) is never modified,
+ * a modified copy replaces it atomically.  Therefore, it can be read without
+ * locking, but a Source may only be dereferenced while the lock is held
+ * (otherwise it might be removed at any time).
+ *
+ * Optionally, a pool of sources is created in advance (see
+ * fill_source_pool()).  Those sources (including their JACK ports) are not
+ * destroyed when they are removed, they are re-used by add_source().
  **/
 template<typename Derived>
 class RendererBase : public apf::MimoProcessor<Derived
@@ -70,7 +210,7 @@ class RendererBase : public apf::MimoProcessor<Derived
 
   public:
     using rtlist_t = typename _base::rtlist_t;
-    using Input = typename _base::DefaultInput;
+    class Input;
     using ScopedLock = typename _base::ScopedLock;
     using sample_type = typename _base::sample_type;
 
@@ -169,16 +309,33 @@ class RendererBase : public apf::MimoProcessor<Derived
             input, output, member));
     }
 
-    int add_source(const apf::parameter_map& p = apf::parameter_map());
+    int add_source(const apf::parameter_map& p = apf::parameter_map()
+        , DiskPlayer::Track* track = nullptr);
     void rem_source(Source* source);
     void rem_all_sources();
 
+    void fill_source_pool();
+
+    /// Wait until everything which is loaded in the background for the
+    /// current sources is available.  Derived classes which load data in the
+    /// background override this, see e.g. BrsRenderer.
+    /// This is used for offline rendering, it must not be called while
+    /// holding the lock (see get_scoped_lock()).
+    void wait_for_background_loads() {}
+
     Source* get_source(int id);
 
     // May only be used in realtime thread!
     const rtlist_t& get_source_list() const { return _source_list; }
 
-    const std::map<int, Source*>& get_source_map() const { return _source_map; }
+    using source_map_t = std::map<int, Source*>;
+    using source_map_ptr = std::shared_ptr<const source_map_t>;
+
+    /// Snapshot of all sources, it is not affected by later changes.
+    source_map_ptr get_source_map() const
+    {
+      return std::atomic_load(&_source_map);
+    }
 
     sample_type get_master_level() const { return _master_level; }
 
@@ -188,6 +345,27 @@ class RendererBase : public apf::MimoProcessor<Derived
     template<typename SomeListType>
     void get_loudspeakers(SomeListType&) {}
 
+    /// Record the output signals (after all post-processing).
+    /// @param recorder The number of channels must match the number of
+    ///   outputs, use @c nullptr to stop recording.
+    /// @warning This may only be used while the renderer is not active!
+    void set_recorder(DiskRecorder* recorder) { _recorder = recorder; }
+
+    /// The output signals are recorded after the Derived class (and its
+    /// PostProcess) has finished, i.e. in the destructor.
+    struct PostProcess : _base::PostProcess
+    {
+      explicit PostProcess(Derived& d) : _base::PostProcess(d), _renderer(d) {}
+
+      ~PostProcess()
+      {
+        if (_renderer._recorder) _renderer._record();
+      }
+
+      private:
+        RendererBase& _renderer;
+    };
+
     std::unique_ptr<ScopedLock> get_scoped_lock()
     {
       // TODO: in C++14, use make_unique()
@@ -196,9 +374,22 @@ class RendererBase : public apf::MimoProcessor<Derived
 
     const sample_type master_volume_correction;  // linear
 
+    /// Compute true-peak levels (4x oversampling) in addition to peak and RMS
+    const bool true_peak_metering;
+
+    /// Sources with a lower (estimated) level are not rendered, see
+    /// Source::culled().  Linear value, 0 means no culling.
+    const sample_type culling_threshold;
+
+    /// Time (in samples) a source has to stay below @c culling_threshold before
+    /// it is culled, this should be longer than the renderer's impulse responses
+    const size_t culling_hold_samples;
+
   protected:
     RendererBase(const apf::parameter_map& p);
 
+    void _distribute_active_channels();
+
     // TODO: make private?
     sample_type _master_level;
 
@@ -215,13 +406,79 @@ class RendererBase : public apf::MimoProcessor<Derived
       return temp;
     }
 
+    /// Input and Source lists are changed in the same audio cycle.
+    class SourceCommand : public apf::CommandQueue::Command
+    {
+      public:
+        SourceCommand(apf::CommandQueue::Command* input
+            , apf::CommandQueue::Command* source)
+          : _input(input)
+          , _source(source)
+        {}
+
+        virtual void execute()
+        {
+          _input->execute();
+          _source->execute();
+        }
+
+        virtual void cleanup()
+        {
+          _input->cleanup();
+          _source->cleanup();
+        }
+
+      private:
+        std::unique_ptr<apf::CommandQueue::Command> _input, _source;
+    };
+
+    /// A pooled Source (and its Input) is removed and put back into the pool.
+    class RecycleSourceCommand : public SourceCommand
+    {
+      public:
+        RecycleSourceCommand(RendererBase& renderer, Input* input
+            , Source* source)
+          : SourceCommand(renderer.make_release_command(input)
+              , renderer._source_list.make_release_command(source))
+          , _renderer(renderer)
+          , _pooled_input(input)
+          , _pooled_source(source)
+        {}
+
+        virtual void cleanup()
+        {
+          SourceCommand::cleanup();
+          // Now the realtime thread doesn't use them anymore
+          _renderer._source_pool.emplace_back(_pooled_input, _pooled_source);
+        }
+
+      private:
+        RendererBase& _renderer;
+        Input* const _pooled_input;
+        Source* const _pooled_source;
+    };
+
+    int _publish_source(int id, std::unique_ptr<Input> in
+        , std::unique_ptr<Source> src);
+
     int _get_new_id();
 
-    std::map<int, Source*> _source_map;
+    void _record();
+
+    source_map_ptr _source_map;  ///< only accessed with std::atomic_load() etc.
 
-    int _highest_id;
+    std::atomic<int> _highest_id;
 
     typename _base::Lock _lock;
+    /// Only one Source is constructed at a time (without holding _lock)
+    typename _base::Lock _builder_lock;
+
+    /// Unused sources which were created by fill_source_pool().
+    /// Source is destroyed before Input.
+    std::vector<std::pair<std::unique_ptr<Input>, std::unique_ptr<Source>>>
+      _source_pool;
+
+    DiskRecorder* _recorder;
 };
 
 /** Constructor.
@@ -233,57 +490,195 @@ RendererBase<Derived>::RendererBase(const apf::parameter_map& p)
   , state(_fifo)
   , master_volume_correction(apf::math::dB2linear(
         this->params.get("master_volume_correction", 0.0)))
+  , true_peak_metering(this->params.get("true_peak_metering", false))
+  , culling_threshold(this->params.has_key("culling_threshold")
+      ? apf::math::dB2linear(
+          this->params.template get<sample_type>("culling_threshold"))
+      : sample_type())
+  , culling_hold_samples(static_cast<size_t>(
+        this->params.get("culling_hold_time", 1.0) * this->sample_rate()))
   , _master_level()
   , _source_list(_fifo)
   , _show_head(true)
+  , _source_map(std::make_shared<source_map_t>())
   , _highest_id(0)
+  , _recorder(nullptr)
 {}
 
+/** Hand over the active channels of all sources to their outputs.
+ * This is for renderers where a source only contributes to some of the
+ * outputs.  Each Derived::Source collects its active channels (including the
+ * ones which are fading out) in its ActiveList @c active_channels while it's
+ * processed.  This has to be called after all sources are processed and
+ * before the outputs are processed, afterwards the ActiveList
+ * @c active_channels of each Derived::Output contains all channels it has to
+ * take into account (and the lists of the sources are empty).
+ * Each item of the lists has to have a member @c output, pointing to the
+ * Derived::Output it belongs to.
+ * The outputs only see the channels in these lists, therefore the sources
+ * don't have to add their channels to @c Output::sourcechannels, i.e.
+ * Source::connect() and Source::disconnect() can be empty.
+ *
+ * This runs in the main realtime thread and the effort is proportional to the
+ * number of outputs plus the number of active channels.
+ **/
+template<typename Derived>
+void RendererBase<Derived>::_distribute_active_channels()
+{
+  using out_t = typename Derived::Output;
+
+  for (auto& out: apf::make_cast_proxy<out_t>(
+        const_cast<rtlist_t&>(this->get_output_list())))
+  {
+    out.active_channels.clear();
+  }
+
+  for (auto& source: apf::make_cast_proxy<typename Derived::Source>(
+        _source_list))
+  {
+    while (auto channel = source.active_channels.pop_front())
+    {
+      const_cast<out_t*>(channel->output)->active_channels.push_front(*channel);
+    }
+  }
+}
+
 /** Create a new source.
+ * Input and Source are constructed without holding the lock of the
+ * CommandQueue, which is only locked for handing them over to the realtime
+ * thread.  Parameter changes of other sources don't have to wait in the
+ * meantime (e.g. while the header of an IR file is read).
+ *
+ * If there is a Source in the pool (see fill_source_pool()), it is used
+ * instead of constructing a new one.  This is only possible if neither an
+ * audio file @p track nor a @c properties_file is requested.
+ * @param p parameters for Input and Source
+ * @param track audio file channel to be played (instead of the JACK input)
  * @return ID of new source
- * @throw unknown whatever the Derived::Source constructor throws
+ * @throw unknown whatever the Derived::Input/Derived::Source constructor throws
  **/
 template<typename Derived>
-int RendererBase<Derived>::add_source(const apf::parameter_map& p)
+int RendererBase<Derived>::add_source(const apf::parameter_map& p
+    , DiskPlayer::Track* track)
 {
-  ScopedLock guard(_lock);
+  if (!track && p.get("properties_file", "") == "")
+  {
+    auto in = std::unique_ptr<Input>();
+    auto src = std::unique_ptr<Source>();
+    {
+      ScopedLock guard(_lock);
+      // Removed sources are returned to the pool during cleanup
+      _fifo.cleanup_commands();
+      if (!_source_pool.empty())
+      {
+        in = std::move(_source_pool.back().first);
+        src = std::move(_source_pool.back().second);
+        _source_pool.pop_back();
+      }
+    }
+
+    if (src)
+    {
+      // Neither of them is used by the realtime thread
+      in->derived().reset();
+      src->derived().reset();
+      internal::reconnect_port(*in, p.get("connect_to", ""), 0);
+
+      ScopedLock guard(_lock);
+
+      // Back to default values
+      src->position = Position();
+      src->orientation = Orientation();
+      src->gain = sample_type(1);
+      src->mute = false;
+      src->model = ::Source::point;
+
+      return _publish_source(_get_new_id(), std::move(in), std::move(src));
+    }
+  }
+
+  ScopedLock builder_guard(_builder_lock);
 
   int id = _get_new_id();
 
   typename Derived::Input::Params in_params;
   in_params = p;
   in_params.set("id", in_params.get("id", id));
-  auto in = this->add(in_params);
-
-  // WARNING: if Derived::Input throws an exception, the SSR crashes!
+  in_params.track = track;
+  auto in = this->create(in_params);
 
   typename Derived::Source::Params src_params;
   src_params = p;
   src_params.parent = &this->derived();
   src_params.fifo = &_fifo;
-  src_params.input = in;
+  src_params.input = in.get();
 
-  typename Derived::Source* src;
+  // If this throws, the Input is destroyed as well
+  auto src = std::unique_ptr<Source>(new typename Derived::Source(src_params));
 
-  try
-  {
-    src = _source_list.add(new typename Derived::Source(src_params));
-  }
-  catch (...)
+  ScopedLock guard(_lock);
+  return _publish_source(id, std::move(in), std::move(src));
+}
+
+/** Create sources for re-use by add_source().
+ * The number of sources is given by the parameter @c source_pool_size
+ * (default: 0).  Their JACK ports are named with the prefix "pool_" instead
+ * of a source ID.  Removed sources are returned to the pool, therefore
+ * sources can be added and removed without allocating memory and without
+ * registering JACK ports.
+ * This has to be called after the reproduction setup was loaded.
+ * @throw unknown whatever the Derived::Input/Derived::Source constructor throws
+ **/
+template<typename Derived>
+void RendererBase<Derived>::fill_source_pool()
+{
+  size_t size = this->params.get("source_pool_size", 0u);
+
+  ScopedLock builder_guard(_builder_lock);
+
+  for (size_t i = 1; i <= size; ++i)
   {
-    // TODO: really remove the corresponding Input?
-    this->rem(in);
-    throw;
+    typename Derived::Input::Params in_params;
+    in_params.set("id", "pool_" + apf::str::A2S(i));
+    auto in = this->create(in_params);
+
+    typename Derived::Source::Params src_params;
+    src_params.parent = &this->derived();
+    src_params.fifo = &_fifo;
+    src_params.input = in.get();
+
+    auto src = std::unique_ptr<Source>(
+        new typename Derived::Source(src_params));
+    src->_pooled = true;
+
+    ScopedLock guard(_lock);
+    _source_pool.emplace_back(std::move(in), std::move(src));
   }
+}
+
+/// Hand over Input and Source to the realtime thread.
+/// @attention _lock must be held!
+template<typename Derived>
+int RendererBase<Derived>::_publish_source(int id, std::unique_ptr<Input> in
+    , std::unique_ptr<Source> src)
+{
+  _fifo.push(new SourceCommand(this->make_add_command(in.get())
+        , _source_list.make_add_command(src.get())));
+
+  // Ownership was passed to the lists
+  in.release();
+  auto source = src.release();
 
   // This cannot be done in the Derived::Source constructor because then the
   // connections to the Outputs are active before the Source is properly added
   // to the source list:
-  src->connect();
+  source->derived().connect();
+
+  auto new_map = std::make_shared<source_map_t>(*_source_map);
+  (*new_map)[id] = source;
+  std::atomic_store(&_source_map, source_map_ptr(new_map));
 
-  _source_map[id] = src;
   return id;
-  // TODO: what happens on failure? can there be failure?
 }
 
 template<typename Derived>
@@ -294,17 +689,31 @@ void RendererBase<Derived>::rem_source(Source* source)
   // TODO: remove by ID instead of by pointer?
   ScopedLock guard(_lock);
 
+  auto new_map = std::make_shared<source_map_t>(*_source_map);
+
   // work-around to delete source from _source_map
-  auto delinquent = std::find_if(_source_map.begin(), _source_map.end()
+  auto delinquent = std::find_if(new_map->begin(), new_map->end()
         , [source] (const std::pair<int, Source*>& in)
           {
             return in.second == source;
           });
-  _source_map.erase(delinquent);
+
+  // It may have been removed by another thread in the meantime
+  if (delinquent == new_map->end()) return;
+
+  new_map->erase(delinquent);
+  std::atomic_store(&_source_map, source_map_ptr(new_map));
 
   source->derived().disconnect();
 
   auto input = const_cast<Input*>(&source->_input);
+
+  if (source->_pooled)
+  {
+    _fifo.push(new RecycleSourceCommand(*this, input, source));
+    return;
+  }
+
   _source_list.rem(source);
 
   // TODO: really remove the corresponding Input?
@@ -316,18 +725,23 @@ void RendererBase<Derived>::rem_source(Source* source)
 template<typename Derived>
 void RendererBase<Derived>::rem_all_sources()
 {
-  while (!_source_map.empty())
+  for (const auto& item: *this->get_source_map())
   {
-    this->rem_source(_source_map.begin()->second);
+    this->rem_source(item.second);
   }
   _highest_id = 0;
 }
 
+/// Find a Source by its ID.  This doesn't need the lock, but the result may
+/// only be used while the lock is held (or if no other thread removes it).
+/// @return @c nullptr if there is no Source with the given @p id
 template<typename Derived>
 typename RendererBase<Derived>::Source*
 RendererBase<Derived>::get_source(int id)
 {
-  return maptools::get_item(_source_map, id);
+  auto source_map = this->get_source_map();
+  auto iter = source_map->find(id);
+  return iter != source_map->end() ? iter->second : nullptr;
 }
 
 template<typename Derived>
@@ -337,6 +751,78 @@ RendererBase<Derived>::_get_new_id()
   return ++_highest_id;
 }
 
+/// Hand over the output signals of the current block to the DiskRecorder.
+/// The order of channels is the order of outputs (i.e. loudspeakers).
+template<typename Derived>
+void
+RendererBase<Derived>::_record()
+{
+  auto transport = internal::transport_state(this->derived(), 0);
+  if (!_recorder->begin_block(transport.first, transport.second)) return;
+
+  size_t channel = 0;
+  for (const auto& out: typename _base::template rtlist_proxy<Output>(
+        this->get_output_list()))
+  {
+    _recorder->write(channel++, out.buffer.begin(), out.buffer.end());
+  }
+}
+
+/** Audio input of a source.
+ * The signal is taken from the JACK port or, if a DiskPlayer::Track is given,
+ * from an audio file (synchronized to JACK transport).
+ **/
+template<typename Derived>
+class RendererBase<Derived>::Input : public _base::Input
+{
+  public:
+    using iterator = const sample_type*;
+
+    struct Params : _base::Input::Params
+    {
+      Params() : track(nullptr) {}
+      DiskPlayer::Track* track;  ///< if @c nullptr, the JACK port is used
+
+      using _base::Input::Params::operator=;
+    };
+
+    explicit Input(const Params& p)
+      : _base::Input(p)
+      , _track(p.track)
+      , _samples(_track ? this->parent.block_size() : 0)
+    {}
+
+    /// Forget the previous signal before re-use (see
+    /// RendererBase::fill_source_pool()).  This is called while the Input
+    /// is not used by the realtime thread.  To be overwritten in the derived
+    /// class.
+    void reset() {}
+
+    APF_PROCESS(Input, _base::Input)
+    {
+      if (_track)
+      {
+        auto transport = internal::transport_state(this->parent, 0);
+        _track->read(_samples.data(), _samples.data() + _samples.size()
+            , transport.first, transport.second);
+      }
+    }
+
+    iterator begin() const
+    {
+      return _track ? _samples.data() : this->buffer.begin();
+    }
+
+    iterator end() const
+    {
+      return _track ? _samples.data() + _samples.size() : this->buffer.end();
+    }
+
+  private:
+    DiskPlayer::Track* const _track;
+    std::vector<sample_type> _samples;  ///< only used for _track
+};
+
 /// A sound source.
 template<typename Derived>
 class RendererBase<Derived>::Source
@@ -351,7 +837,8 @@ class RendererBase<Derived>::Source
     using sample_type
       = typename std::iterator_traits<typename Input::iterator>::value_type;
 
-    friend class RendererBase<Derived>;  // rem_source() needs access to _input
+    // rem_source() needs access to _input and _pooled
+    friend class RendererBase<Derived>;
 
     struct Params : apf::parameter_map
     {
@@ -379,8 +866,10 @@ class RendererBase<Derived>::Source
       , weighting_factor()
       , _input(*(p.input ? p.input : throw std::logic_error(
               "Bug (RendererBase::Source): input == NULL!")))
-      , _pre_fader_level()
-      , _level()
+      , _meter(this->parent.true_peak_metering)
+      , _pooled(false)
+      , _culled(false)
+      , _quiet_samples(0)
     {}
 
     APF_PROCESS(Source, SourceBase)
@@ -388,32 +877,68 @@ class RendererBase<Derived>::Source
       this->_begin = _input.begin();
       this->_end = _input.end();
 
-      if (!_input.parent.state.processing || this->mute)
-      {
-        this->weighting_factor = 0.0;
-      }
-      else
+      sample_type weight = 0;
+
+      if (_input.parent.state.processing && !this->mute)
       {
-        this->weighting_factor = this->gain;
+        weight = this->gain;
         // If the renderer does something nonlinear, the master volume should
         // be applied to the output signal ... TODO: shall we care?
-        this->weighting_factor *= _input.parent.state.master_volume;
-        this->weighting_factor *= _input.parent.master_volume_correction;
+        weight *= _input.parent.state.master_volume;
+        weight *= _input.parent.master_volume_correction;
+      }
+
+      // The level is measured before culling, otherwise a culled source
+      // could never become audible again
+      _level_helper(_input.parent, weight);
+
+      if (this->parent.culling_threshold != 0 && weight != 0)
+      {
+        _update_culling();
       }
 
-      _level_helper(_input.parent);
+      // The renderers fade out sources whose weight drops to zero (and fade
+      // them in again), so no additional crossfade is needed
+      this->weighting_factor = _culled ? sample_type() : weight;
 
       assert(this->weighting_factor.exactly_one_assignment());
     }
 
-    sample_type get_level() const { return _level; }
+    /// @b true if the source is too quiet to be rendered, see
+    /// RendererBase::culling_threshold.  If so, #weighting_factor is zero.
+    bool culled() const { return _culled; }
+
+    /// Peak level (or true-peak level, if enabled) after the source gain.
+    /// Like get_levels(), this can be called from any thread.
+    sample_type get_level() const
+    {
+      auto levels = _meter.get();
+      return std::max(levels.peak, levels.true_peak);
+    }
+
+    apf::Levels<sample_type> get_levels() const { return _meter.get(); }
 
     // In the default case, the output level are ignored
     bool get_output_levels(sample_type*, sample_type*) const { return false; }
 
+    /// @b true if data needed by the source (e.g. impulse responses) couldn't
+    /// be loaded, the source stays silent.  In the default case, nothing is
+    /// loaded.  Can be called from any thread.
+    bool load_failed() const { return false; }
+
     void connect() {}
     void disconnect() {}
 
+    /// Forget the previous signal before re-use, see Input::reset().
+    /// If this is overwritten in the derived class, it has to be called there.
+    void reset()
+    {
+      this->weighting_factor = apf::BlockParameter<sample_type>();
+      _meter.reset();
+      _culled = false;
+      _quiet_samples = 0;
+    }
+
     Derived& parent;
 
     apf::SharedData<Position> position;
@@ -428,25 +953,88 @@ class RendererBase<Derived>::Source
     const Input& _input;
 
   private:
-    void _level_helper(apf::enable_queries&)
+    void _level_helper(apf::enable_queries&, sample_type weight)
     {
-      _pre_fader_level = apf::math::max_amplitude(_input.begin(), _input.end());
-      _level = _pre_fader_level * this->weighting_factor;
+      // the input signal is measured, the result is scaled
+      _meter.process(_input.begin(), _input.end(), weight);
     }
 
-    void _level_helper(apf::disable_queries&) {}
+    void _level_helper(apf::disable_queries&, sample_type weight)
+    {
+      // Without queries, the level is only needed for culling
+      if (this->parent.culling_threshold != 0)
+      {
+        _meter.process(_input.begin(), _input.end(), weight);
+      }
+    }
+
+    void _update_culling();
+
+    apf::LevelMeter<sample_type> _meter;
 
-    sample_type _pre_fader_level;
-    sample_type _level;
+    bool _pooled;  ///< Created by fill_source_pool()
+
+    bool _culled;
+    size_t _quiet_samples;  ///< Time since the level fell below the threshold
 };
 
+/** Decide if the source is audible.
+ * The level of the current block is estimated from the measured peak level
+ * (including gain and master volume) and a 1/r distance attenuation relative to
+ * the amplitude reference distance.  The estimate is conservative, near
+ * sources are not attenuated at all and plane waves are never attenuated.
+ *
+ * To avoid switching back and forth, there is a hysteresis:
+ * A source is culled after it stayed below the threshold for
+ * RendererBase::culling_hold_samples (which also keeps the reverberant tails
+ * of its impulse responses), it becomes audible again as soon as it exceeds
+ * the threshold by 6 dB.
+ **/
+template<typename Derived>
+void RendererBase<Derived>::Source::_update_culling()
+{
+  sample_type level = _meter.get().peak;
+
+  if (this->model == ::Source::point)
+  {
+    auto distance = (this->position.get()
+        - _input.parent.state.reference_position.get()).length();
+    auto reference_distance = _input.parent.state.amplitude_reference_distance;
+    if (distance > reference_distance)
+    {
+      level *= reference_distance / distance;
+    }
+  }
+
+  const auto threshold = this->parent.culling_threshold;
+
+  if (_culled)
+  {
+    if (level > 2 * threshold)
+    {
+      _culled = false;
+      _quiet_samples = 0;
+    }
+  }
+  else if (level < threshold)
+  {
+    _quiet_samples += this->parent.block_size();
+    if (_quiet_samples > this->parent.culling_hold_samples) _culled = true;
+  }
+  else
+  {
+    _quiet_samples = 0;
+  }
+}
+
 template<typename Derived>
 class RendererBase<Derived>::Output : public _base::Output
 {
   public:
     Output(const typename _base::Output::Params& p)
       : _base::Output(p)
-      , _level()
+      , _post_processing(false)
+      , _meter(this->parent.true_peak_metering)
     {}
 
     struct Process : _base::Output::Process
@@ -455,26 +1043,37 @@ class RendererBase<Derived>::Output : public _base::Output
 
       ~Process()
       {
-        _out._level_helper(_out.parent);
+        if (!_out._post_processing) _out._level_helper(_out.parent);
       }
 
       private:
         Output& _out;
     };
 
-    sample_type get_level() const { return _level; }
+    /// Peak level (or true-peak level, if enabled).
+    /// Like get_levels(), this can be called from any thread.
+    sample_type get_level() const
+    {
+      auto levels = _meter.get();
+      return std::max(levels.peak, levels.true_peak);
+    }
+
+    apf::Levels<sample_type> get_levels() const { return _meter.get(); }
 
   protected:
     void _level_helper(apf::enable_queries&)
     {
-      _level = apf::math::max_amplitude(this->buffer.begin()
-          , this->buffer.end());
+      _meter.process(this->buffer.begin(), this->buffer.end());
     }
 
     void _level_helper(apf::disable_queries&) {}
 
+    /// If @b true, the output signal is still modified in the PostProcess of
+    /// the Derived class, which then has to call _level_helper() itself.
+    bool _post_processing;
+
   private:
-    sample_type _level;
+    apf::LevelMeter<sample_type> _meter;
 };
 
 // This is a kind of C++ mixin class, but it also includes the CRTP
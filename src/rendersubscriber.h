@@ -191,6 +191,8 @@ class RenderSubscriber : public Subscriber
 
     virtual void set_source_output_levels(id_t, float*, float*) {}
 
+    virtual void set_levels(const LevelSnapshot::ptr&) {}
+
     virtual void set_processing_state(bool state)
     {
       // TODO: change API, move locking inside RendererBase
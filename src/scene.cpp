@@ -48,6 +48,51 @@ ssr::Scene::~Scene()
   //maptools::purge(_source_map);
 }
 
+/** Send the complete scene (except loudspeakers and levels) to a subscriber.
+ * This is used to re-synchronize a subscriber which has missed some calls.
+ * All its sources are deleted first.
+ * @param subscriber receives the same calls as a subscriber which was there
+ *   from the beginning
+ **/
+void ssr::Scene::replay(Subscriber& subscriber) const
+{
+  subscriber.delete_all_sources();
+
+  for (const auto& item: _source_map)
+  {
+    const id_t id = item.first;
+    const Source& source = item.second;
+
+    subscriber.new_source(id);
+    subscriber.set_source_mute(id, source.mute);
+    subscriber.set_source_gain(id, source.gain);
+    subscriber.set_source_position(id, source.position);
+    subscriber.set_source_position_fixed(id, source.fixed_position);
+    subscriber.set_source_orientation(id, source.orientation);
+    subscriber.set_source_name(id, source.name);
+    subscriber.set_source_model(id, source.model);
+    subscriber.set_source_port_name(id, source.port_name);
+    if (source.audio_file_name != "")
+    {
+      subscriber.set_source_file_name(id, source.audio_file_name);
+      subscriber.set_source_file_channel(id, source.audio_file_channel);
+    }
+    subscriber.set_source_file_length(id, source.file_length);
+    subscriber.set_source_properties_file(id, source.properties_file);
+  }
+
+  subscriber.set_reference_position(_reference.position);
+  subscriber.set_reference_orientation(_reference.orientation);
+  subscriber.set_reference_offset_position(_reference_offset.position);
+  subscriber.set_reference_offset_orientation(_reference_offset.orientation);
+  subscriber.set_master_volume(_master_volume);
+  subscriber.set_amplitude_reference_distance(_amplitude_reference_distance);
+  subscriber.set_sample_rate(_sample_rate);
+  subscriber.set_processing_state(_processing_state);
+  subscriber.set_transport_state(
+      std::make_pair(_transport_playing, _transport_position));
+}
+
 ssr::Scene::loudspeakers_t::size_type ssr::Scene::get_number_of_loudspeakers() const
 {
   return _loudspeakers.size();
@@ -224,6 +269,35 @@ void ssr::Scene::set_source_output_levels(id_t id, float* first, float* last)
   }
 }
 
+void ssr::Scene::set_levels(const LevelSnapshot::ptr& levels)
+{
+  if (!levels) return;
+
+  _master_signal_level = levels->master;
+
+  // both source lists are sorted by ID
+  size_t index = 0;
+  for (auto& item: _source_map)
+  {
+    while (index < levels->ids.size() && levels->ids[index] < item.first)
+    {
+      ++index;
+    }
+    if (index == levels->ids.size()) break;
+    if (levels->ids[index] != item.first) continue;
+
+    Source& source = item.second;
+    source.signal_level = levels->source_levels[index];
+    if (levels->outputs != 0
+        && source.output_levels.size() == levels->outputs)
+    {
+      std::copy(levels->output_levels_of(index)
+          , levels->output_levels_of(index) + levels->outputs
+          , source.output_levels.begin());
+    }
+  }
+}
+
 void ssr::Scene::set_processing_state(bool state)
 {
   _processing_state = state;
@@ -96,6 +96,8 @@ class Scene : public Subscriber
 
     virtual void set_source_output_levels(id_t id, float* first, float* last);
 
+    virtual void set_levels(const LevelSnapshot::ptr& levels);
+
     virtual void set_processing_state(bool state);
     //virtual void set_transport_state(JackClient::State state);
     virtual void set_transport_state(
@@ -240,6 +242,8 @@ class Scene : public Subscriber
       return _reference_offset;
     }
 
+    void replay(Subscriber& subscriber) const;
+
   protected:
     source_map_t _source_map;     ///< container for sources
 
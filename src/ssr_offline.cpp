@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+/// @file
+/// Main file for offline rendering (without JACK, faster than realtime).
+
+#include <cstdlib>  // for EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>  // for strrchr()
+#include <thread>  // for std::thread::hardware_concurrency()
+
+#include "offlinepolicy.h"  // must be included before the renderers
+
+#include "controller.h"
+#include "binauralrenderer.h"
+#include "wfsrenderer.h"
+#include "brsrenderer.h"
+#include "genericrenderer.h"
+#include "vbaprenderer.h"
+#include "aaprenderer.h"
+#include "nfchoarenderer.h"
+
+namespace
+{
+
+template<typename Renderer>
+int render(int argc, char* argv[])
+{
+  ssr::Controller<Renderer> controller(argc, argv);
+  return controller.render_offline() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "\nUSAGE: ssr-offline RENDERER [OPTIONS] <scene-file>\n\n"
+      "RENDERER: binaural, wfs, brs, generic, vbap, aap or nfc-hoa\n"
+      "Type 'ssr-offline RENDERER --help' for a list of options.\n"
+      << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto exec_name = strrchr(argv[0], '/');
+  if (exec_name == nullptr) exec_name = argv[0]; else exec_name++;
+
+  // "ssr-offline RENDERER" is used as program name in messages
+  auto name = std::string(exec_name) + " " + argv[1];
+  auto threads = "--threads=" + apf::str::A2S(
+      std::max(std::thread::hardware_concurrency(), 1u));
+
+  // These are prepended to the user's options, which can override them
+  std::vector<char*> args;
+  args.push_back(&name[0]);
+  args.push_back(const_cast<char*>("--no-gui"));
+  args.push_back(const_cast<char*>("--no-ip-server"));
+  args.push_back(&threads[0]);
+  args.insert(args.end(), argv + 2, argv + argc);
+  args.push_back(nullptr);
+
+  int new_argc = static_cast<int>(args.size()) - 1;
+  char** new_argv = args.data();
+
+  const std::string renderer = argv[1];
+
+  try
+  {
+    if (renderer == "binaural")
+    {
+      return render<ssr::BinauralRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "wfs")
+    {
+      return render<ssr::WfsRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "brs")
+    {
+      return render<ssr::BrsRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "generic")
+    {
+      return render<ssr::GenericRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "vbap")
+    {
+      return render<ssr::VbapRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "aap")
+    {
+      return render<ssr::AapRenderer>(new_argc, new_argv);
+    }
+    else if (renderer == "nfc-hoa")
+    {
+      return render<ssr::NfcHoaRenderer>(new_argc, new_argv);
+    }
+  }
+  catch (std::exception& e)
+  {
+    ERROR(e.what());
+    return EXIT_FAILURE;
+  }
+
+  ERROR("Unknown renderer: \"" << renderer << "\"!");
+  return EXIT_FAILURE;
+}
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
+// vim:fdm=expr:foldexpr=getline(v\:lnum)=~'/\\*\\*'&&getline(v\:lnum)!~'\\*\\*/'?'a1'\:getline(v\:lnum)=~'\\*\\*/'&&getline(v\:lnum)!~'/\\*\\*'?'s1'\:'='
@@ -36,6 +36,7 @@
 #include "ssr_global.h"
 #include "source.h"
 #include "loudspeaker.h"
+#include "levelsnapshot.h"
 
 namespace ssr
 {
@@ -129,6 +130,15 @@ struct Subscriber
   /// _publish() function in the Controller class.
   virtual bool set_source_file_length(id_t id, const long int& length)  = 0;
 
+  /// Report that a source couldn't be set up completely (e.g. its impulse
+  /// responses couldn't be loaded), it stays silent.
+  /// @param id ID of the source
+  /// @param message description of the problem
+  virtual bool set_source_error(id_t id, const std::string& message)
+  {
+    (void)id; (void)message; return true;
+  }
+
   /// Set reference position.
   /// @param position new position
   virtual void set_reference_position(const Position& position)  = 0;
@@ -162,6 +172,11 @@ struct Subscriber
 
   virtual void set_source_output_levels(id_t id, float* first, float* last) = 0;
 
+  /// Set signal levels of all sources and the master level at once.
+  /// @param levels immutable snapshot, it can be kept and read later (and
+  ///   from another thread)
+  virtual void set_levels(const LevelSnapshot::ptr& levels) = 0;
+
   /// Update information about audio processing;
   virtual void set_processing_state(bool state)  = 0;
 
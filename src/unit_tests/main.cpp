@@ -0,0 +1,9 @@
+// This is the main file for all unit tests using CATCH.
+//
+// The tests are compiled and executed with "make run_tests", further tests can
+// be added in the Makefile.  The CATCH header is taken from the APF.
+//
+// See also: https://github.com/philsquared/Catch/wiki/Tutorial
+
+#define CATCH_CONFIG_MAIN
+#include "catch/catch.hpp"
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+// Tests for BrsRenderer.
+
+#include <vector>
+#include <string>
+#include <cmath>  // for std::sin()
+
+#include "offlinepolicy.h"  // must be included before the renderers
+#include "apf/posix_thread_policy.h"
+
+#include "ssr_global.h"
+#include "brsrenderer.h"
+
+#include "catch/catch.hpp"
+
+namespace
+{
+
+const int block_size = 64;
+
+/// Render one source like Controller::render_offline() does.
+/// @return all output signals
+std::vector<float> render()
+{
+  apf::parameter_map p;
+  p.set("sample_rate", 44100);
+  p.set("block_size", block_size);
+  ssr::BrsRenderer renderer(p);
+  renderer.load_reproduction_setup();
+  renderer.activate();
+
+  apf::parameter_map source_params;
+  source_params.set("properties_file"
+      , "../../data/impulse_responses/hrirs/hrirs_fabian.wav");
+  renderer.add_source(source_params);
+
+  // the BRIRs are loaded in the background
+  renderer.wait_for_background_loads();
+
+  auto outputs = renderer.get_output_list().size();
+  auto out_buffer
+    = std::vector<std::vector<float>>(outputs, std::vector<float>(block_size));
+  auto out = std::vector<float*>();
+  for (auto& channel: out_buffer) out.push_back(channel.data());
+  auto input = std::vector<float>(block_size);
+  auto result = std::vector<float>();
+
+  for (int block = 0; block < 10; ++block)
+  {
+    for (int i = 0; i < block_size; ++i)
+    {
+      input[i] = std::sin(0.05f * static_cast<float>(block * block_size + i));
+    }
+    float* in[] = { input.data() };
+    renderer.audio_callback(block_size, in, out.data());
+
+    for (const auto& channel: out_buffer)
+    {
+      result.insert(result.end(), channel.begin(), channel.end());
+    }
+  }
+  renderer.deactivate();
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST_CASE("BrsRenderer", "Test BrsRenderer")
+{
+
+SECTION("background loading", "offline rendering is reproducible")
+{
+  auto first = render();
+  auto second = render();
+
+  REQUIRE(first.size() == 2 * 10 * block_size);
+  CHECK(first == second);
+
+  // the source isn't silent in the first block
+  bool first_block_silent = true;
+  for (int i = 0; i < block_size; ++i)
+  {
+    if (first[i] != 0.0f) first_block_silent = false;
+  }
+  CHECK_FALSE(first_block_silent);
+}
+
+SECTION("failed background loading", "the error is stored in the Slot")
+{
+  apf::parameter_map p;
+  p.set("sample_rate", 44100);
+  p.set("block_size", block_size);
+  ssr::BrsRenderer renderer(p);
+  renderer.load_reproduction_setup();
+  renderer.activate();
+
+  // get_file_info() is skipped, the error happens in the loader thread
+  ssr::IrCache cache;
+  auto slot = cache.load_async("nonexistent.wav", 44100, block_size, renderer);
+  cache.wait();
+
+  CHECK(slot->failed);
+  CHECK(slot->filters.get() == nullptr);
+  renderer.deactivate();
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
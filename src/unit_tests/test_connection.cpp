@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+// Tests for Connection (with a real TCP connection on the loopback device).
+
+#include <algorithm>  // for std::remove()
+#include <chrono>
+#include <cstring>  // for std::strlen()
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "connection.h"
+#include "publisher.h"
+#include "subscriber.h"
+#include "binaryprotocol.h"
+
+#include "catch/catch.hpp"
+
+namespace
+{
+
+/// Scene with one source, changes are forwarded directly to the subscribers.
+struct FakePublisher : ssr::Publisher
+{
+  FakePublisher() : position(0.0f, 0.0f) {}
+
+  virtual bool load_scene(const std::string&) { return false; }
+  virtual bool save_scene_as_XML(const std::string&) const { return false; }
+  virtual void start_processing() {}
+  virtual void stop_processing() {}
+  virtual void new_source(const std::string&, Source::model_t
+      , const std::string&, int, const Position&, const bool
+      , const Orientation&, const bool, const float, const bool
+      , const std::string&) {}
+  virtual void delete_source(id_t) {}
+  virtual void delete_all_sources() {}
+
+  virtual void set_source_position(id_t id, const Position& new_position)
+  {
+    position = new_position;
+    for (auto subscriber: subscribers)
+    {
+      subscriber->set_source_position(id, position);
+    }
+  }
+
+  virtual void set_source_orientation(id_t, const Orientation&) {}
+  virtual void set_source_gain(id_t, float) {}
+  virtual void set_source_mute(id_t, bool) {}
+  virtual void set_source_signal_level(const id_t, const float) {}
+  virtual void set_source_name(id_t, const std::string&) {}
+  virtual void set_source_properties_file(id_t, const std::string&) {}
+  virtual void set_source_model(id_t, Source::model_t) {}
+  virtual void set_source_port_name(id_t, const std::string&) {}
+  virtual void set_source_position_fixed(id_t, const bool) {}
+  virtual void set_reference_position(const Position&) {}
+  virtual void set_reference_orientation(const Orientation&) {}
+  virtual void set_reference_offset_position(const Position&) {}
+  virtual void set_reference_offset_orientation(const Orientation&) {}
+  virtual void set_master_volume(float) {}
+  virtual void set_amplitude_reference_distance(float) {}
+  virtual void set_master_signal_level(float) {}
+  virtual void set_cpu_load(const float) {}
+  virtual void publish_sample_rate(const int) {}
+  virtual std::string get_renderer_name() const { return "fake"; }
+  virtual bool show_head() const { return false; }
+  virtual void transport_start() {}
+  virtual void transport_stop() {}
+  virtual bool transport_locate(float) { return false; }
+  virtual void calibrate_client() {}
+  virtual void set_processing_state(bool) {}
+
+  virtual void subscribe(ssr::Subscriber* subscriber)
+  {
+    subscribers.push_back(subscriber);
+  }
+
+  virtual void unsubscribe(ssr::Subscriber* subscriber)
+  {
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end()
+          , subscriber), subscribers.end());
+  }
+
+  virtual void replay_scene(ssr::Subscriber* subscriber)
+  {
+    subscriber->delete_all_sources();
+    subscriber->new_source(1);
+    subscriber->set_source_position(1, position);
+  }
+
+  virtual std::string get_scene_as_XML() const
+  {
+    return "<update><source id='1'><position x='0' y='0'/></source></update>";
+  }
+
+  std::vector<ssr::Subscriber*> subscribers;
+  Position position;
+};
+
+using boost::asio::ip::tcp;
+
+/// Read everything which arrives within @p timeout (in milliseconds)
+std::string read_all(tcp::socket& socket, int timeout)
+{
+  auto result = std::string();
+  auto end = std::chrono::steady_clock::now()
+    + std::chrono::milliseconds(timeout);
+  while (std::chrono::steady_clock::now() < end)
+  {
+    auto available = socket.available();
+    if (available)
+    {
+      auto data = std::vector<char>(available);
+      boost::asio::read(socket, boost::asio::buffer(data));
+      result.append(data.begin(), data.end());
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST_CASE("Connection", "Test Connection")
+{
+
+SECTION("switch to binary", "no update is lost by switching protocols")
+{
+  FakePublisher publisher;
+  boost::asio::io_service io_service;
+  tcp::acceptor acceptor(io_service
+      , tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+  // XML updates are only sent on timeout, this never happens here
+  auto connection = ssr::Connection::create(io_service, publisher, 1000000);
+  tcp::socket client(io_service);
+  client.connect(acceptor.local_endpoint());
+  acceptor.accept(connection->socket());
+  connection->start();
+
+  // this is still waiting in the NetworkSubscriber when the handshake arrives
+  publisher.set_source_position(1, Position(1.0f, 2.0f));
+
+  auto handshake = ssr::binary::handshake;
+  boost::asio::write(client
+      , boost::asio::buffer(handshake, std::strlen(handshake) + 1));
+
+  std::thread network_thread([&io_service] () { io_service.run(); });
+  auto received = read_all(client, 500);
+  io_service.stop();
+  network_thread.join();
+
+  auto handshake_end = received.find(std::string(handshake) + '\0');
+  REQUIRE(handshake_end != std::string::npos);
+  handshake_end += std::strlen(handshake) + 1;
+
+  // the XML update was never sent
+  CHECK(received.find("x='1'") == std::string::npos);
+  CHECK(received.find("x=\"1\"") == std::string::npos);
+
+  auto expected = std::string();
+  auto out = ssr::binary::Writer(expected);
+  out.begin(ssr::binary::source_position).u32(1).f32(1.0f).f32(2.0f);
+  out.end();
+
+  CHECK(received.find(expected, handshake_end) != std::string::npos);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+// Tests for LevelSnapshot and SourceOutputLevels.
+
+#include <algorithm>  // for std::fill()
+#include <map>
+#include <vector>
+
+#include "levelsnapshot.h"
+
+#include "catch/catch.hpp"
+
+namespace
+{
+
+/// All output levels of a source have the same value
+struct FakeSource
+{
+  explicit FakeSource(float l) : level(l) {}
+
+  bool get_output_levels(float* first, float* last) const
+  {
+    std::fill(first, last, level);
+    return true;
+  }
+
+  float level;
+};
+
+using source_map_t = std::map<int, FakeSource*>;
+
+/// Fill the IDs of @p snapshot like Controller does
+void set_ids(ssr::LevelSnapshot& snapshot, const source_map_t& source_map)
+{
+  snapshot.ids.clear();
+  for (const auto& item: source_map)
+  {
+    snapshot.ids.push_back(static_cast<id_t>(item.first));
+  }
+}
+
+}  // unnamed namespace
+
+TEST_CASE("SourceOutputLevels", "Test SourceOutputLevels")
+{
+
+const size_t outputs = 2;
+ssr::SourceOutputLevels<FakeSource> levels;
+ssr::LevelSnapshot snapshot;
+
+// the order of the source list doesn't match the IDs, e.g. because a pooled
+// source was re-used for a new ID
+auto source_list = std::vector<FakeSource>{
+  FakeSource(3.0f), FakeSource(1.0f), FakeSource(2.0f)};
+auto source_map = source_map_t{
+  {1, &source_list[1]}, {2, &source_list[2]}, {3, &source_list[0]}};
+
+SECTION("reordered sources", "levels are sorted by ID")
+{
+  levels.reserve(source_map.size(), outputs);
+  levels.query(source_list, outputs);
+  set_ids(snapshot, source_map);
+  levels.copy_to(snapshot, source_map, outputs);
+
+  REQUIRE(snapshot.outputs == outputs);
+  auto expected = std::vector<float>{1, 1, 2, 2, 3, 3};
+  CHECK(snapshot.output_levels == expected);
+  CHECK(*snapshot.output_levels_of(snapshot.find(3)) == 3.0f);
+}
+
+SECTION("changed sources", "sources added after query() get zeros")
+{
+  levels.reserve(source_map.size(), outputs);
+  levels.query(source_list, outputs);
+
+  // source 2 was removed, source 4 was added
+  auto new_source = FakeSource(4.0f);
+  source_map.erase(2);
+  source_map[4] = &new_source;
+
+  set_ids(snapshot, source_map);
+  levels.copy_to(snapshot, source_map, outputs);
+
+  REQUIRE(snapshot.outputs == outputs);
+  auto expected = std::vector<float>{1, 1, 3, 3, 0, 0};
+  CHECK(snapshot.output_levels == expected);
+}
+
+SECTION("not enough space", "more sources than reserved")
+{
+  levels.reserve(1, outputs);
+  levels.query(source_list, outputs);
+  set_ids(snapshot, source_map);
+  levels.copy_to(snapshot, source_map, outputs);
+
+  // only the first source in the list was queried
+  auto expected = std::vector<float>{0, 0, 0, 0, 3, 3};
+  CHECK(snapshot.output_levels == expected);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
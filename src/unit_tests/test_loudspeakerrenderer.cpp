@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+// Tests for LoudspeakerRenderer (using the AAP renderer).
+
+#include <vector>
+#include <string>
+#include <cmath>  // for std::sin()
+
+#include "offlinepolicy.h"  // must be included before the renderers
+#include "apf/posix_thread_policy.h"
+
+#include "ssr_global.h"
+#include "aaprenderer.h"
+
+#include "catch/catch.hpp"
+
+using signals_t = std::vector<std::vector<float>>;
+
+const int block_size = 64;
+const int blocks = 20;
+
+/// Render one source with the given reproduction setup.
+/// @return one signal per loudspeaker
+signals_t render(const std::string& reproduction_setup)
+{
+  apf::parameter_map p;
+  p.set("reproduction_setup", reproduction_setup);
+  p.set("sample_rate", 48000);
+  p.set("block_size", block_size);
+  p.set("ambisonics_order", 1);
+  ssr::AapRenderer renderer(p);
+  renderer.load_reproduction_setup();
+  renderer.activate();
+
+  auto id = renderer.add_source();
+  {
+    auto guard = renderer.get_scoped_lock();
+    renderer.get_source(id)->position = Position(1.0f, 2.0f);
+  }
+
+  auto outputs = renderer.get_output_list().size();
+  auto result = signals_t(outputs, std::vector<float>(blocks * block_size));
+  auto input = std::vector<float>(block_size);
+
+  for (int block = 0; block < blocks; ++block)
+  {
+    for (int i = 0; i < block_size; ++i)
+    {
+      input[i] = std::sin(0.05f * static_cast<float>(block * block_size + i));
+    }
+    float* in[] = { input.data() };
+    auto out = std::vector<float*>();
+    for (auto& signal: result)
+    {
+      out.push_back(signal.data() + block * block_size);
+    }
+    renderer.audio_callback(block_size, in, out.data());
+  }
+  renderer.deactivate();
+  return result;
+}
+
+TEST_CASE("LoudspeakerRenderer", "Test LoudspeakerRenderer")
+{
+
+SECTION("bass management and delay", "the subwoofer gets the undelayed sum")
+{
+  auto plain = render("2.1_bass_management.asd");
+  auto delayed = render("2.1_bass_management_delay.asd");
+
+  REQUIRE(plain.size() == 3);
+  REQUIRE(delayed.size() == 3);
+
+  // make sure there is something to compare
+  CHECK(plain[0].back() != 0.0f);
+  CHECK(plain[2].back() != 0.0f);
+
+  // 1 ms at 48 kHz
+  const int delay = 48;
+
+  for (int i = 0; i < delay; ++i)
+  {
+    CHECK(delayed[0][i] == 0.0f);
+  }
+  for (int i = delay; i < blocks * block_size; ++i)
+  {
+    CHECK(delayed[0][i] == plain[0][i - delay]);
+  }
+  CHECK(delayed[1] == plain[1]);
+  // the subwoofer is not influenced by the delay of the left loudspeaker
+  CHECK(delayed[2] == plain[2]);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
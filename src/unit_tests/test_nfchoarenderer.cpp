@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright © 2012-2013 Institut für Nachrichtentechnik, Universität Rostock *
+ * Copyright © 2006-2012 Quality & Usability Lab,                             *
+ *                       Telekom Innovation Laboratories, TU Berlin           *
+ *                                                                            *
+ * This file is part of the SoundScape Renderer (SSR).                        *
+ *                                                                            *
+ * The SSR is free software:  you can redistribute it and/or modify it  under *
+ * the terms of the  GNU  General  Public  License  as published by the  Free *
+ * Software Foundation, either version 3 of the License,  or (at your option) *
+ * any later version.                                                         *
+ *                                                                            *
+ * The SSR is distributed in the hope that it will be useful, but WITHOUT ANY *
+ * WARRANTY;  without even the implied warranty of MERCHANTABILITY or FITNESS *
+ * FOR A PARTICULAR PURPOSE.                                                  *
+ * See the GNU General Public License for more details.                       *
+ *                                                                            *
+ * You should  have received a copy  of the GNU General Public License  along *
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.            *
+ *                                                                            *
+ * The SSR is a tool  for  real-time  spatial audio reproduction  providing a *
+ * variety of rendering algorithms.                                           *
+ *                                                                            *
+ * http://spatialaudio.net/ssr                           ssr@spatialaudio.net *
+ ******************************************************************************/
+
+// Tests for NfcHoaRenderer.
+
+#include <vector>
+#include <string>
+#include <cmath>  // for std::sin()
+
+#include "offlinepolicy.h"  // must be included before the renderers
+#include "apf/posix_thread_policy.h"
+
+#include "ssr_global.h"
+#include "nfchoarenderer.h"
+
+#include "catch/catch.hpp"
+
+namespace
+{
+
+const int block_size = 64;
+
+/// Render a source, remove it and add a new one at the same position.
+/// @return all output signals after the source was added the second time
+std::vector<float> render(int source_pool_size)
+{
+  apf::parameter_map p;
+  p.set("reproduction_setup", "../../data/reproduction_setups/circle.asd");
+  p.set("sample_rate", 48000);
+  p.set("block_size", block_size);
+  p.set("source_pool_size", source_pool_size);
+  ssr::NfcHoaRenderer renderer(p);
+  renderer.load_reproduction_setup();
+  renderer.fill_source_pool();
+  renderer.activate();
+
+  auto add_source = [&renderer] ()
+  {
+    auto id = renderer.add_source();
+    auto guard = renderer.get_scoped_lock();
+    renderer.get_source(id)->position = Position(1.0f, 2.0f);
+    return id;
+  };
+
+  auto outputs = renderer.get_output_list().size();
+  auto out_buffer
+    = std::vector<std::vector<float>>(outputs, std::vector<float>(block_size));
+  auto out = std::vector<float*>();
+  for (auto& channel: out_buffer) out.push_back(channel.data());
+  auto input = std::vector<float>(block_size);
+  auto result = std::vector<float>();
+
+  auto id = add_source();
+  for (int block = 0; block < 20; ++block)
+  {
+    // the removed Source goes back to the pool after the next block
+    if (block == 10) renderer.rem_source(renderer.get_source(id));
+    if (block == 11) add_source();
+
+    for (int i = 0; i < block_size; ++i)
+    {
+      input[i] = std::sin(0.05f * static_cast<float>(block * block_size + i));
+    }
+    // there may be unused inputs, they get the same signal
+    auto in = std::vector<float*>(renderer.in_channels(), input.data());
+    renderer.audio_callback(block_size, in.data(), out.data());
+
+    if (block >= 11)
+    {
+      for (const auto& channel: out_buffer)
+      {
+        result.insert(result.end(), channel.begin(), channel.end());
+      }
+    }
+  }
+  renderer.deactivate();
+
+  // with a pool, no new Input was created
+  CHECK(renderer.in_channels() == (source_pool_size ? 1 : 2));
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST_CASE("NfcHoaRenderer", "Test NfcHoaRenderer")
+{
+
+SECTION("source pool", "a re-used Source sounds exactly like a new one")
+{
+  auto fresh = render(0);
+  auto pooled = render(1);
+
+  CHECK(fresh == pooled);
+  // make sure there is something to compare
+  CHECK(fresh.back() != 0.0f);
+}
+
+} // TEST_CASE
+
+// Settings for Vim (http://www.vim.org/), please do not remove:
+// vim:softtabstop=2:shiftwidth=2:expandtab:textwidth=80:cindent
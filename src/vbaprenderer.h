@@ -58,6 +58,7 @@ class VbapRenderer : public LoudspeakerRenderer<VbapRenderer>
     static const char* name() { return "VBAP-Renderer"; }
 
     class Source;
+    class SourceChannel;
     class Output;
     class RenderFunction;
 
@@ -98,6 +99,7 @@ class VbapRenderer : public LoudspeakerRenderer<VbapRenderer>
         }
 
         _update_valid_sections();
+        _update_lookup_table();
       }
 
       _absolute_reference_offset_position
@@ -106,6 +108,7 @@ class VbapRenderer : public LoudspeakerRenderer<VbapRenderer>
         + this->state.reference_position;
 
       _process_list(_source_list);
+      this->_distribute_active_channels();
     }
 
   private:
@@ -140,6 +143,10 @@ class VbapRenderer : public LoudspeakerRenderer<VbapRenderer>
     void _update_angles();
     void _sort_loudspeakers();
     void _update_valid_sections();
+    void _update_lookup_table();
+
+    size_t _lookup_section(float angle) const;
+    size_t _lookup_index(float angle) const;
 
     float _max_angle, _overhang_angle;
 
@@ -147,6 +154,13 @@ class VbapRenderer : public LoudspeakerRenderer<VbapRenderer>
 
     std::vector<LoudspeakerEntry> _sorted_loudspeakers;
 
+    /// Number of (equally sized) azimuth sections in _lookup_table
+    enum { _lookup_size = 1024 };
+
+    /// For each azimuth section, index of the first loudspeaker in
+    /// _sorted_loudspeakers which is in this or a later section.
+    std::vector<size_t> _lookup_table;
+
     apf::BlockParameter<Position> _reference_offset_position;
     Position _absolute_reference_offset_position;
 };
@@ -156,8 +170,16 @@ class VbapRenderer::Source : public _base::Source
   public:
     Source(const Params& p)
       : _base::Source(p)
+      , _channels(4, *this)  // two old and two new loudspeakers
     {}
 
+    void reset()
+    {
+      _base::Source::reset();
+      loudspeaker_weights.first = apf::BlockParameter<LoudspeakerWeight>();
+      loudspeaker_weights.second = apf::BlockParameter<LoudspeakerWeight>();
+    }
+
     APF_PROCESS(Source, _base::Source)
     {
       // NOTE: reference_offset_orientation doesn't affect rendering
@@ -171,7 +193,7 @@ class VbapRenderer::Source : public _base::Source
       auto l_end = this->parent._sorted_loudspeakers.end();
 
       auto second = apf::make_circular_iterator(l_begin, l_end
-          , std::upper_bound(l_begin, l_end, incidence_angle));
+          , l_begin + this->parent._lookup_index(incidence_angle));
 
       auto first = second;
 
@@ -188,6 +210,8 @@ class VbapRenderer::Source : public _base::Source
 
       assert(this->loudspeaker_weights.first.exactly_one_assignment());
       assert(this->loudspeaker_weights.second.exactly_one_assignment());
+
+      _update_active_channels();
     }
 
     bool get_output_levels(sample_type* first, sample_type* last) const
@@ -224,17 +248,46 @@ class VbapRenderer::Source : public _base::Source
     _calculate_loudspeaker_weights(float angle
           , const LoudspeakerEntry& first, const LoudspeakerEntry& second);
 
+    void _update_active_channels();
+
+    apf::fixed_vector<SourceChannel> _channels;
+
   public:
     std::pair<apf::BlockParameter<LoudspeakerWeight>
             , apf::BlockParameter<LoudspeakerWeight>> loudspeaker_weights;
+
+    /// Channels which are handed over to the outputs in this block
+    ActiveList<SourceChannel> active_channels;
+};
+
+/// Connection between a Source and one of its (at most 4) active outputs.
+class VbapRenderer::SourceChannel : public ActiveList<SourceChannel>::Hook
+{
+  public:
+    explicit SourceChannel(const Source& s)
+      : source(s)
+      , output(nullptr)
+      , old_weight(0)
+      , new_weight(0)
+    {}
+
+    const Source& source;
+
+    using iterator = decltype(source.begin());
+
+    iterator begin() const { return source.begin(); }
+    iterator end() const { return source.end(); }
+
+    const Output* output;
+    sample_type old_weight, new_weight;
 };
 
 class VbapRenderer::RenderFunction
 {
   public:
-    RenderFunction(const Output& out) : _out(out) {}
+    RenderFunction() {}
 
-    apf::CombineChannelsResult::type select(const Source& in);
+    apf::CombineChannelsResult::type select(const SourceChannel& in);
 
     sample_type operator()(sample_type in)
     {
@@ -249,8 +302,6 @@ class VbapRenderer::RenderFunction
   private:
     sample_type _weight;
     apf::math::linear_interpolator<sample_type> _interpolator;
-
-    const Output& _out;
 };
 
 class VbapRenderer::Output : public _base::Output
@@ -258,20 +309,20 @@ class VbapRenderer::Output : public _base::Output
   public:
     Output(const Params& p)
       : _base::Output(p)
-      , _combiner(this->parent._source_list, this->buffer)
-    {
-      // TODO: handle loudspeaker delays?
-      // TODO: optional delay line?
-    }
+      , _combiner(this->active_channels, this->buffer)
+    {}
 
     APF_PROCESS(Output, _base::Output)
     {
-      _combiner.process(RenderFunction(*this));
+      _combiner.process(RenderFunction());
     }
 
+    /// Source channels with non-zero (old or new) weight
+    ActiveList<SourceChannel> active_channels;
+
   private:
-    apf::CombineChannelsInterpolation<rtlist_proxy<Source>, buffer_type>
-      _combiner;
+    apf::CombineChannelsInterpolation<ActiveList<SourceChannel>&
+      , buffer_type> _combiner;
 };
 
 void
@@ -283,9 +334,6 @@ VbapRenderer::load_reproduction_setup()
 
   // TODO: check somehow if loudspeaker setup is reasonable?
 
-  // TODO: get loudspeaker delays from setup?
-  // delay_samples = size_t(delay * sample_rate + 0.5f)
-
   for (const auto& out: rtlist_proxy<Output>(this->get_output_list()))
   {
     if (out.model == Loudspeaker::subwoofer)
@@ -306,43 +354,76 @@ VbapRenderer::load_reproduction_setup()
   _update_angles();
   _sort_loudspeakers();
   _update_valid_sections();
+  _update_lookup_table();
 }
 
 apf::CombineChannelsResult::type
-VbapRenderer::RenderFunction::select(const Source& in)
+VbapRenderer::RenderFunction::select(const SourceChannel& in)
+{
+  using namespace apf::CombineChannelsResult;
+
+  if (in.old_weight == 0 && in.new_weight == 0)
+  {
+    return nothing;
+  }
+  else if (in.old_weight == in.new_weight)
+  {
+    _weight = in.new_weight;
+    return constant;
+  }
+  else
+  {
+    _interpolator.set(in.old_weight, in.new_weight
+        , in.source.parent.block_size());
+    return change;
+  }
+}
+
+/** Collect the outputs affected by this source in the current block.
+ * These are the (up to two) loudspeakers of the previous block (which may be
+ * fading out) and the ones of the current block.
+ **/
+void
+VbapRenderer::Source::_update_active_channels()
 {
-  const auto& ls = in.loudspeaker_weights;
+  const auto& ls = this->loudspeaker_weights;
 
   assert(ls.first.get().ls_ptr != ls.second.get().ls_ptr
       || ls.first.get().ls_ptr == nullptr);
 
-  auto get_weight = [this] (const LoudspeakerWeight& first
+  auto get_weight = [] (const Output* out, const LoudspeakerWeight& first
       , const LoudspeakerWeight& second)
   {
     float weight = 0;
-    if (first.ls_ptr == &_out) { weight = first.weight; }
-    else if (second.ls_ptr == &_out) { weight = second.weight; }
+    if (first.ls_ptr == out) { weight = first.weight; }
+    else if (second.ls_ptr == out) { weight = second.weight; }
     return weight;
   };
 
-  auto old_weight = get_weight(ls.first.old(), ls.second.old());
-  auto new_weight = get_weight(ls.first, ls.second);
+  const Output* candidates[] = { ls.first.get().ls_ptr, ls.second.get().ls_ptr
+    , ls.first.old().ls_ptr, ls.second.old().ls_ptr };
 
-  using namespace apf::CombineChannelsResult;
+  auto channel = _channels.begin();
 
-  if (old_weight == 0 && new_weight == 0)
+  for (auto out: candidates)
   {
-    return nothing;
-  }
-  else if (old_weight == new_weight)
-  {
-    _weight = new_weight;
-    return constant;
-  }
-  else
-  {
-    _interpolator.set(old_weight, new_weight, in.parent.block_size());
-    return change;
+    if (out == nullptr) continue;
+
+    // Skip old loudspeakers which are still in use
+    if (std::find_if(_channels.begin(), channel, [out] (const SourceChannel& c)
+          {
+            return c.output == out;
+          }) != channel) continue;
+
+    channel->output = out;
+    channel->old_weight = get_weight(out, ls.first.old(), ls.second.old());
+    channel->new_weight = get_weight(out, ls.first, ls.second);
+
+    if (channel->old_weight != 0 || channel->new_weight != 0)
+    {
+      this->active_channels.push_front(*channel);
+      ++channel;
+    }
   }
 }
 
@@ -386,6 +467,52 @@ VbapRenderer::_update_valid_sections()
   }
 }
 
+void
+VbapRenderer::_update_lookup_table()
+{
+  _lookup_table.resize(_lookup_size);
+
+  size_t index = 0;
+  for (size_t section = 0; section < _lookup_size; ++section)
+  {
+    while (index < _sorted_loudspeakers.size()
+        && _lookup_section(_sorted_loudspeakers[index].angle) < section)
+    {
+      ++index;
+    }
+    _lookup_table[section] = index;
+  }
+}
+
+/// Azimuth section of @p angle (radians, between 0 and 2*pi).
+size_t
+VbapRenderer::_lookup_section(float angle) const
+{
+  auto section = size_t(angle / apf::math::deg2rad(360.0f) * _lookup_size);
+  return std::min(section, size_t(_lookup_size - 1));
+}
+
+/** Find the pair of loudspeakers enclosing a given angle.
+ * This gives the same result as std::upper_bound() on _sorted_loudspeakers,
+ * but in constant time.  The pre-computed index only has to be corrected if
+ * there are loudspeakers within the azimuth section of @p angle.
+ * @param angle incidence angle in radians (between 0 and 2*pi)
+ * @return index of the loudspeaker on the left side, the previous loudspeaker
+ *   is on the right side.  If it is equal to the number of loudspeakers, the
+ *   left one is the first loudspeaker.
+ **/
+size_t
+VbapRenderer::_lookup_index(float angle) const
+{
+  size_t index = _lookup_table[_lookup_section(angle)];
+  while (index < _sorted_loudspeakers.size()
+      && _sorted_loudspeakers[index].angle <= angle)
+  {
+    ++index;
+  }
+  return index;
+}
+
 std::pair<VbapRenderer::LoudspeakerWeight, VbapRenderer::LoudspeakerWeight>
 VbapRenderer::Source::_calculate_loudspeaker_weights(float source_angle
     , const LoudspeakerEntry& first, const LoudspeakerEntry& second)
@@ -31,10 +31,10 @@
 #define SSR_WFSRENDERER_H
 
 #include "loudspeakerrenderer.h"
+#include "ircache.h"
 
 #include "apf/convolver.h"  // for apf::conv::...
 #include "apf/blockdelayline.h"  // for NonCausalBlockDelayLine
-#include "apf/sndfiletools.h"  // for apf::load_sndfile
 #include "apf/combine_channels.h"  // for apf::raised_cosine_fade, ...
 
 // TODO: make more flexible option:
@@ -63,6 +63,7 @@ class WfsRenderer : public SourceToOutput<WfsRenderer, LoudspeakerRenderer>
       , _fade(this->block_size())
       , _max_delay(this->params.get("delayline_size", 0))
       , _initial_delay(this->params.get("initial_delay", 0))
+      , _ir_cache(this->params.get("ir_cache_dir", ""))
     {
       // TODO: compute "ideal" initial delay?
       // TODO: check if given initial delay is sufficient?
@@ -72,32 +73,52 @@ class WfsRenderer : public SourceToOutput<WfsRenderer, LoudspeakerRenderer>
       // TODO: get pre-filter from reproduction setup!
       // TODO: allow alternative files for different sample rates
 
-      auto prefilter = apf::load_sndfile(
-          this->params.get("prefilter_file", ""), this->sample_rate(), 1);
-
-      size_t size = prefilter.frames();
-
-      auto ir = apf::fixed_vector<sample_type>(size);
-
-      size = prefilter.readf(ir.data(), size);
-
-      // TODO: warning if size changed?
-      // TODO: warning if size == 0?
-
-      _pre_filter.reset(new apf::conv::Filter(this->block_size()
-            , ir.begin(), ir.end()));
+      _pre_filter = _ir_cache.get_filters(
+          this->params.get("prefilter_file", ""), this->sample_rate()
+          , this->block_size(), 1);
     }
 
+    void load_reproduction_setup();
+
     APF_PROCESS(WfsRenderer, _base)
     {
+      _update_geometry();
       this->_process_list(_source_list);
+      this->_distribute_active_channels();
     }
 
   private:
+    void _update_geometry();
+    void _transform_loudspeakers();
+
     apf::raised_cosine_fade<sample_type> _fade;
-    std::unique_ptr<apf::conv::Filter> _pre_filter;
 
     size_t _max_delay, _initial_delay;
+
+    IrCache _ir_cache;
+    IrCache::filter_set_ptr _pre_filter;
+
+    apf::BlockParameter<Position> _reference_position;
+    apf::BlockParameter<float> _reference_azimuth;
+    apf::BlockParameter<Position> _reference_offset_position;
+    apf::BlockParameter<float> _reference_offset_azimuth;
+    apf::BlockParameter<sample_type> _amplitude_reference_distance;
+
+    DirectionalPoint _reference_with_offset;
+
+    /// @b true if sources have to re-calculate their weights and delays
+    bool _geometry_changed;
+
+    /// @name Loudspeaker geometry
+    /// One entry per output (in the order of the output list), transformed
+    /// according to the reference.  Stored as separate arrays to allow
+    /// vectorized processing.  Subwoofers have a normal vector of length zero.
+    /// @{
+    apf::fixed_vector<sample_type> _ls_x, _ls_y, _ls_normal_x, _ls_normal_y;
+    apf::fixed_vector<sample_type> _ls_reference_distance;
+    /// @}
+    /// Indices of subwoofers
+    std::vector<size_t> _subwoofers;
 };
 
 class WfsRenderer::Input : public _base::Input
@@ -107,18 +128,23 @@ class WfsRenderer::Input : public _base::Input
 
     Input(const Params& p)
       : _base::Input(p)
-      // TODO: check if _pre_filter != 0!
-      , _convolver(*this->parent._pre_filter)
+      , _convolver(this->parent._pre_filter->front())
       , _delayline(this->parent.block_size(), this->parent._max_delay
           , this->parent._initial_delay)
     {}
 
     APF_PROCESS(Input, _base::Input)
     {
-      _convolver.add_block(this->buffer.begin());
+      _convolver.add_block(this->begin());
       _delayline.write_block(_convolver.convolve());
     }
 
+    void reset()
+    {
+      _convolver.clear();
+      _delayline.clear();
+    }
+
   private:
     apf::conv::StaticConvolver _convolver;
     apf::NonCausalBlockDelayLine<sample_type> _delayline;
@@ -126,13 +152,15 @@ class WfsRenderer::Input : public _base::Input
 
 class WfsRenderer::SourceChannel : public apf::has_begin_and_end<
                           apf::NonCausalBlockDelayLine<sample_type>::circulator>
+                                  , public ActiveList<SourceChannel>::Hook
 {
   public:
-    SourceChannel(const Source& s)
+    SourceChannel(const Source& s, const Output& o)
       : crossfade_mode(0)
       , weighting_factor(0.0f)
       , delay(0)
       , source(s)
+      , output(&o)
     {}
 
     void update();
@@ -142,6 +170,7 @@ class WfsRenderer::SourceChannel : public apf::has_begin_and_end<
     apf::BlockParameter<int> delay;
 
     const Source& source;
+    const Output* const output;
 
     // TODO: avoid making those public:
     using apf::has_begin_and_end<apf::NonCausalBlockDelayLine<sample_type>
@@ -187,7 +216,7 @@ class WfsRenderer::Output : public _base::Output
 
     Output(const Params& p)
       : _base::Output(p)
-      , _combiner(this->sourcechannels, this->buffer, this->parent._fade)
+      , _combiner(this->active_channels, this->buffer, this->parent._fade)
     {}
 
     APF_PROCESS(Output, _base::Output)
@@ -195,9 +224,11 @@ class WfsRenderer::Output : public _base::Output
       _combiner.process(RenderFunction(*this));
     }
 
+    /// Source channels with non-zero (old or new) weight
+    ActiveList<SourceChannel> active_channels;
+
   private:
-    apf::CombineChannelsCrossfade<apf::cast_proxy<SourceChannel
-      , sourcechannels_t>, buffer_type
+    apf::CombineChannelsCrossfade<ActiveList<SourceChannel>&, buffer_type
       , apf::raised_cosine_fade<sample_type>> _combiner;
 };
 
@@ -205,18 +236,51 @@ class WfsRenderer::Source : public _base::Source
 {
   private:
     void _process();
+    void _update_weights_and_delays();
+    void _store(size_t index, sample_type weight, float float_delay);
 
   public:
     Source(const Params& p)
-      : _base::Source(p, p.parent->get_output_list().size(), *this)
+      : _base::Source(p)
       , delayline(p.input->_delayline)
-    {}
+      , _geometry_valid(false)
+      , _weights(p.parent->get_output_list().size())
+      , _delays(p.parent->get_output_list().size())
+    {
+      const auto& outputs = p.parent->get_output_list();
+      this->sourcechannels.reserve(outputs.size());
+      for (const auto& out: rtlist_proxy<Output>(outputs))
+      {
+        this->sourcechannels.emplace_back(*this, out);
+      }
+    }
 
     APF_PROCESS(Source, _base::Source)
     {
       _process();
     }
 
+    // see RendererBase::_distribute_active_channels()
+    void connect() {}
+    void disconnect() {}
+
+    /// RenderFunction::select() uses the old weights and delays, therefore
+    /// they are reset to the values of a new Source
+    void reset()
+    {
+      _base::Source::reset();
+      for (auto& channel: this->sourcechannels)
+      {
+        channel.crossfade_mode = 0;
+        channel.weighting_factor = apf::BlockParameter<sample_type>(0.0f);
+        channel.delay = apf::BlockParameter<int>(0);
+      }
+      _position = apf::BlockParameter<Position>();
+      _azimuth = apf::BlockParameter<float>();
+      _model = apf::BlockParameter< ::Source::model_t>();
+      _geometry_valid = false;
+    }
+
     bool get_output_levels(sample_type* first, sample_type* last) const
     {
       assert(size_t(std::distance(first, last)) == this->sourcechannels.size());
@@ -233,276 +297,329 @@ class WfsRenderer::Source : public _base::Source
 
     const apf::NonCausalBlockDelayLine<sample_type>& delayline;
 
+    /// Channels which are handed over to the outputs in this block
+    ActiveList<SourceChannel> active_channels;
+
   //private:
     bool _focused;
+
+  private:
+    apf::BlockParameter<Position> _position;
+    apf::BlockParameter<float> _azimuth;
+    apf::BlockParameter< ::Source::model_t> _model;
+
+    bool _geometry_valid;
+
+    /// Weights (without source gain) and delays per loudspeaker.
+    /// Only re-calculated if the source or the reference has changed.
+    apf::fixed_vector<sample_type> _weights;
+    apf::fixed_vector<int> _delays;
 };
 
-void WfsRenderer::Source::_process()
+void WfsRenderer::load_reproduction_setup()
 {
-  if (this->model == ::Source::plane)
+  _base::load_reproduction_setup();
+
+  const auto& outputs = this->get_output_list();
+  _ls_x.resize(outputs.size());
+  _ls_y.resize(outputs.size());
+  _ls_normal_x.resize(outputs.size());
+  _ls_normal_y.resize(outputs.size());
+  _ls_reference_distance.resize(outputs.size());
+
+  size_t i = 0;
+  for (const auto& out: rtlist_proxy<Output>(outputs))
   {
-    // do nothing, focused-ness is irrelevant for plane waves
-    _focused = false;
+    if (out.model == Loudspeaker::subwoofer) _subwoofers.push_back(i);
+    ++i;
   }
-  else
-  {
-    _focused = true;
-    for (const auto& out: rtlist_proxy<Output>(_input.parent.get_output_list()))
-    {
-      // subwoofers have to be ignored!
-      if (out.model == Loudspeaker::subwoofer) continue;
 
-      // TODO: calculate with inner product
+  _update_geometry();
+  _transform_loudspeakers();
+}
 
-      // angle (modulo) between the line connecting source<->loudspeaker
-      // and the loudspeaker orientation
+void WfsRenderer::_update_geometry()
+{
+  _reference_position = this->state.reference_position.get();
+  _reference_azimuth = this->state.reference_orientation.get().azimuth;
+  _reference_offset_position = this->state.reference_offset_position.get();
+  _reference_offset_azimuth
+    = this->state.reference_offset_orientation.get().azimuth;
+  _amplitude_reference_distance = this->state.amplitude_reference_distance;
 
-      // TODO: avoid getting reference 2 times (see select())
-      auto ls = DirectionalPoint(out);
-      auto ref = DirectionalPoint(out.parent.state.reference_position
-          , out.parent.state.reference_orientation);
-      ls.transform(ref);
+  bool reference_changed = _reference_position.changed()
+    || _reference_azimuth.changed() || _reference_offset_position.changed()
+    || _reference_offset_azimuth.changed();
 
-      auto a = apf::math::wrap(angle(ls.position - this->position
-            , ls.orientation), 2 * apf::math::pi<sample_type>());
+  if (reference_changed) _transform_loudspeakers();
 
-      auto halfpi = apf::math::pi<sample_type>()/2;
+  _geometry_changed = reference_changed
+    || _amplitude_reference_distance.changed();
+}
 
-      if (a < halfpi || a > 3 * halfpi)
-      {
-        // if at least one loudspeaker "turns its back" to the source, the
-        // source is considered non-focused
-        _focused = false;
-        break;
-      }
+void WfsRenderer::_transform_loudspeakers()
+{
+  auto ref = DirectionalPoint(_reference_position
+      , Orientation(_reference_azimuth));
+
+  // TODO: this is actually wrong!
+  // We use it to be compatible with the (also wrong) GUI implementation.
+  _reference_with_offset = ref;
+  _reference_with_offset.transform(DirectionalPoint(_reference_offset_position
+        , Orientation(_reference_offset_azimuth)));
+
+  size_t i = 0;
+  for (const auto& out: rtlist_proxy<Output>(this->get_output_list()))
+  {
+    auto ls = DirectionalPoint(out);
+    ls.transform(ref);
+
+    _ls_x[i] = ls.position.x;
+    _ls_y[i] = ls.position.y;
+
+    if (out.model == Loudspeaker::subwoofer)
+    {
+      // subwoofers are ignored in the vectorized computations
+      _ls_normal_x[i] = 0.0f;
+      _ls_normal_y[i] = 0.0f;
+    }
+    else
+    {
+      auto phi = apf::math::deg2rad(ls.orientation.azimuth);
+      _ls_normal_x[i] = std::cos(phi);
+      _ls_normal_y[i] = std::sin(phi);
     }
-  }
 
-  // TODO: active sources?
+    _ls_reference_distance[i]
+      = (ls.position - _reference_with_offset.position).length();
+    ++i;
+  }
 }
 
-void WfsRenderer::SourceChannel::update()
+void WfsRenderer::Source::_process()
 {
-  _begin = this->source.delayline.get_read_circulator(this->delay);
-  _end = _begin + source.parent.block_size();
-}
+  _position = this->position.get();
+  _azimuth = this->orientation.get().azimuth;
+  _model = this->model.get();
 
-apf::CombineChannelsResult::type
-WfsRenderer::RenderFunction::select(SourceChannel& in)
-{
-  _in = &in;
+  sample_type source_weight = this->weighting_factor;
 
-  // define a restricted area around loudspeakers to avoid division by zero:
-  const float safety_radius = 0.01f; // 1 cm
+  if (source_weight == 0 && this->weighting_factor.old() == 0)
+  {
+    // The source is muted or culled, all its channels stay inactive.
+    // Weights and delays are updated when it becomes audible again.
+    _geometry_valid = false;
+  }
+  else if (!_geometry_valid || this->parent._geometry_changed
+      || _position.changed() || _azimuth.changed() || _model.changed())
+  {
+    _update_weights_and_delays();
+    _geometry_valid = true;
+  }
 
-  // TODO: move reference calculation to WfsRenderer::Process?
-  auto ref = DirectionalPoint(_out.parent.state.reference_position
-      , _out.parent.state.reference_orientation);
+  // NB: tapering (loudspeaker weight) is applied in the output stage
 
-  // TODO: this is actually wrong!
-  // We use it to be compatible with the (also wrong) GUI implementation.
-  auto ref_off = ref;
-  ref_off.transform(DirectionalPoint(
-        _out.parent.state.reference_offset_position
-        , _out.parent.state.reference_offset_orientation));
+  size_t i = 0;
+  for (auto& channel: this->sourcechannels)
+  {
+    // apply the gain factor of the current source
+    channel.weighting_factor = _weights[i] * source_weight;
+    channel.delay = _delays[i];
 
-  sample_type weighting_factor = 1;
-  float float_delay = 0;
+    assert(channel.weighting_factor >= 0.0f);
+    assert(channel.weighting_factor.exactly_one_assignment());
+    assert(channel.delay.exactly_one_assignment());
 
-  auto ls = Loudspeaker(_out);
-  auto src_pos = in.source.position;
+    // Channels which are fading out have to be processed as well
+    if (channel.weighting_factor != 0 || channel.weighting_factor.old() != 0)
+    {
+      this->active_channels.push_front(channel);
+    }
+    ++i;
+  }
+}
 
-  // TODO: shortcut if in.source.weighting_factor == 0
+/** Calculate weights and delays for all loudspeakers.
+ * All vectors are given relative to the source position, angles between them
+ * are computed as inner products.
+ **/
+void WfsRenderer::Source::_update_weights_and_delays()
+{
+  // define a restricted area around loudspeakers to avoid division by zero:
+  const float safety_radius = 0.01f; // 1 cm
 
-  // Transform loudspeaker position according to reference and offset
-  ls.transform(ref);
+  const auto& renderer = this->parent;
+  const size_t size = _weights.size();
+  const sample_type* ls_x = renderer._ls_x.data();
+  const sample_type* ls_y = renderer._ls_y.data();
+  const sample_type* normal_x = renderer._ls_normal_x.data();
+  const sample_type* normal_y = renderer._ls_normal_y.data();
+  const sample_type* reference_distance
+    = renderer._ls_reference_distance.data();
 
-  float reference_distance = (ls.position - ref_off.position).length();
+  const auto src_pos = _position.get();
+  const auto ref_pos = renderer._reference_with_offset.position - src_pos;
 
-  float source_ls_distance = (ls.position - src_pos).length();
+  _focused = false;
 
-  switch (in.source.model) // check if point source or plane wave or ...
+  switch (_model) // check if point source or plane wave or ...
   {
     case ::Source::point:
-      if (ls.model == Loudspeaker::subwoofer)
+    {
+      // if at least one loudspeaker "turns its back" to the source, the
+      // source is considered non-focused
+      _focused = true;
+      for (size_t i = 0; i < size; ++i)
       {
-        // the delay is calculated to be correct on the reference position
-        // delay can be negative!
-        float_delay = (src_pos - ref_off.position).length()
-          - reference_distance;
-
-        if (std::abs(float_delay) < safety_radius)
-        {
-          weighting_factor = 1.0f / std::sqrt(safety_radius);
-        }
-        else
+        if ((ls_x[i] - src_pos.x) * normal_x[i]
+            + (ls_y[i] - src_pos.y) * normal_y[i] > 0.0f)
         {
-          weighting_factor = 1.0f / std::sqrt(std::abs(float_delay));
+          _focused = false;
+          break;
         }
-        break; // step out of switch
       }
 
-      float_delay = (ls.position - src_pos).length();
-      assert(float_delay >= 0);
-
-      float denominator;
-      if (float_delay < safety_radius) denominator = std::sqrt(safety_radius);
-      else denominator = std::sqrt(float_delay);
-
-      // TODO: does this really do the right thing?
-      weighting_factor = cos(angle(ls.position - src_pos,
-            ls.orientation)) / denominator;
+#if defined(WEIGHTING_OLD)
+      // consider distance attenuation
+      // no volume increase for sources closer than 0.5m to reference position
+      float attenuation = 0.5f / std::max(ref_pos.length(), 0.5f); // 1/r
+      // float attenuation = 0.25f / std::sqrt(...); // 1/sqrt(r)
+#elif defined(WEIGHTING_DELFT)
+      float attenuation = 1.0f;
+#endif
 
-      if (weighting_factor < 0.0f)
+      for (size_t i = 0; i < size; ++i)
       {
-        // negative weighting factor is only valid for focused sources
-        if (in.source._focused)
-        {
-          // loudspeaker selection:
+        float x = ls_x[i] - src_pos.x;
+        float y = ls_y[i] - src_pos.y;
+        float inner_product = x * normal_x[i] + y * normal_y[i];
+        float source_ls_distance = std::sqrt(x * x + y * y);
+
+        float float_delay = source_ls_distance;
 
-          // this could also be done by using the cosine function instead of
-          // inner product
+        // cosine of the angle between the line connecting source<->loudspeaker
+        // and the loudspeaker orientation
+        float cosine = source_ls_distance > 0.0f
+          ? inner_product / source_ls_distance : normal_x[i];
 
-          // calculate inner product of those two vectors:
-          // this = source
-          auto lhs = ls.position - src_pos;
-          auto rhs = ref_off.position - src_pos;
+        sample_type weighting_factor = cosine
+          / std::sqrt(std::max(source_ls_distance, safety_radius));
 
-          // TODO: write inner product function in Position class
-          if ((lhs.x * rhs.x + lhs.y * rhs.y) < 0.0f)
+        if (weighting_factor < 0.0f)
+        {
+          // negative weighting factor is only valid for focused sources.
+          // If the inner product is less than zero, the source is more or
+          // less between the loudspeaker and the reference
+          if (_focused && x * ref_pos.x + y * ref_pos.y < 0.0f)
           {
-            // if the inner product is less than zero, the source is more or
-            // less between the loudspeaker and the reference
             float_delay = -float_delay;
             weighting_factor = -weighting_factor;
 
-#if defined(WEIGHTING_OLD)
-            (void)source_ls_distance;  // avoid "unused variable" warning
-#elif defined(WEIGHTING_DELFT)
+#if defined(WEIGHTING_DELFT)
             // limit to a maximum of 2.0
             weighting_factor *= std::min(2.0f, std::sqrt(source_ls_distance
-                / (reference_distance + source_ls_distance)));
+                / (reference_distance[i] + source_ls_distance)));
 #endif
           }
           else
           {
-            // ignored focused point source
+            // ignored point source
             weighting_factor = 0;
-            break;
           }
         }
-        else // non-focused and weighting_factor < 0
-        {
-          // ignored non-focused point source
-          weighting_factor = 0;
-          break;
-        }
-      }
-      else if(weighting_factor > 0.0f) // positive weighting factor
-      {
-        if (!in.source._focused)
+#if defined(WEIGHTING_DELFT)
+        else if (weighting_factor > 0.0f && !_focused)
         {
-          // non-focused point source
-
-#if defined(WEIGHTING_OLD)
-#elif defined(WEIGHTING_DELFT)
           // WARNING: division by zero is possible!
           weighting_factor *= std::sqrt(source_ls_distance
-              / (reference_distance + source_ls_distance));
-#endif
-        }
-        else // focused
-        {
-          // ignored focused point source
-          break;
+              / (reference_distance[i] + source_ls_distance));
         }
+#endif
+
+        _store(i, weighting_factor * attenuation, float_delay);
       }
-      else
+
+      // the delay is calculated to be correct on the reference position
+      // delay can be negative!
+      float source_distance = ref_pos.length();
+      for (auto i: renderer._subwoofers)
       {
-        // this should never happen: Weighting factor is 0 or +-Inf or NaN!
-        break;
+        float float_delay = source_distance - reference_distance[i];
+        sample_type weighting_factor = 1.0f
+          / std::sqrt(std::max(std::abs(float_delay), safety_radius));
+        _store(i, weighting_factor * attenuation, float_delay);
       }
       break;
+    }
 
     case ::Source::plane:
-      if (ls.model == Loudspeaker::subwoofer)
-      {
-        weighting_factor = 1.0f; // TODO: is this correct?
-        // the delay is calculated to be correct on the reference position
-        // delay can be negative!
-        float_delay
-          = DirectionalPoint(in.source.position, in.source.orientation)
-          .plane_to_point_distance(ref_off.position) - reference_distance;
-        break; // step out of switch
-      }
-
-      // weighting factor is determined by the cosine of the angle
-      // difference between plane wave direction and loudspeaker direction
-      weighting_factor = cos(angle(in.source.orientation, ls.orientation));
-      // check if loudspeaker is active for this source
-      if (weighting_factor < 0)
-      {
-        // ignored plane wave
-        weighting_factor = 0;
-        break;
-      }
+    {
+      auto phi = apf::math::deg2rad(_azimuth.get());
+      float direction_x = std::cos(phi);
+      float direction_y = std::sin(phi);
 
-      float_delay = DirectionalPoint(in.source.position, in.source.orientation)
-        .plane_to_point_distance(ls.position);
+      // no distance attenuation for plane waves
+      float ampl_ref = renderer._amplitude_reference_distance;
+      assert(ampl_ref > 0);
+      float attenuation = 0.5f / ampl_ref; // 1/r
+      //float attenuation = 0.25f / std::sqrt(ampl_ref); // 1/sqrt(r)
 
-      if (float_delay < 0.0)
+      for (size_t i = 0; i < size; ++i)
       {
-        // "focused" plane wave
+        // weighting factor is determined by the cosine of the angle
+        // difference between plane wave direction and loudspeaker direction
+        sample_type weighting_factor
+          = direction_x * normal_x[i] + direction_y * normal_y[i];
+
+        // distance between plane and loudspeaker, negative for "focused"
+        // plane waves
+        float float_delay = (ls_x[i] - src_pos.x) * direction_x
+          + (ls_y[i] - src_pos.y) * direction_y;
+
+        // check if loudspeaker is active for this source
+        if (weighting_factor < 0)
+        {
+          // ignored plane wave
+          weighting_factor = 0;
+          float_delay = 0;
+        }
+
+        _store(i, weighting_factor * attenuation, float_delay);
       }
-      else // positive delay
+
+      // the delay is calculated to be correct on the reference position
+      // delay can be negative!
+      float plane_distance
+        = ref_pos.x * direction_x + ref_pos.y * direction_y;
+      for (auto i: renderer._subwoofers)
       {
-        // plane wave
+        // TODO: is the weighting factor 1.0 correct?
+        _store(i, attenuation, plane_distance - reference_distance[i]);
       }
       break;
+    }
 
     default:
       //WARNING("Unknown source model");
-      break;
-  } // switch source model
-
-  // no distance attenuation for plane waves 
-  if (in.source.model == ::Source::plane)
-  {
-    float ampl_ref = _out.parent.state.amplitude_reference_distance;
-    assert(ampl_ref > 0);
-
-    // 1/r:
-    weighting_factor *= 0.5f / ampl_ref;
-    // 1/sqrt(r)
-    //weighting_factor *= 0.25f / std::sqrt(ampl_ref);
-  }
-  else
-  {
+      for (size_t i = 0; i < size; ++i)
+      {
 #if defined(WEIGHTING_OLD)
-    // consider distance attenuation
-    float source_distance = (src_pos - ref_off.position).length();
-
-    // no volume increase for sources closer than 0.5m to reference position
-    source_distance = std::max(source_distance, 0.5f);
-
-    weighting_factor *= 0.5f / source_distance; // 1/r
-    // weighting_factor *= 0.25f / std::sqrt(source_distance); // 1/sqrt(r)
+        _store(i, 0.5f / std::max(ref_pos.length(), 0.5f), 0.0f);
 #elif defined(WEIGHTING_DELFT)
+        _store(i, 1.0f, 0.0f);
 #endif
-  }
-
-  // apply the gain factor of the current source
-  weighting_factor *= in.source.weighting_factor;
-
-  // apply tapering
-  weighting_factor *= ls.weight;
-
-  assert(weighting_factor >= 0.0f);
+      }
+      break;
+  } // switch source model
+}
 
+void
+WfsRenderer::Source::_store(size_t index, sample_type weight, float float_delay)
+{
   // delay in seconds
   float_delay *= c_inverse;
   // delay in samples
-  float_delay *= _out.parent.sample_rate();
+  float_delay *= this->parent.sample_rate();
 
   // TODO: check for negative delay and print an error if > initial_delay
 
@@ -510,21 +627,30 @@ WfsRenderer::RenderFunction::select(SourceChannel& in)
   // TODO: enable interpolated reading from delay line.
   int int_delay = static_cast<int>(float_delay + 0.5f);
 
-  if (in.source.delayline.delay_is_valid(int_delay))
+  if (this->delayline.delay_is_valid(int_delay))
   {
-    in.delay = int_delay;
-    in.weighting_factor = weighting_factor;
+    _delays[index] = int_delay;
+    _weights[index] = weight;
   }
   else
   {
     // TODO: some sort of warning message?
 
-    in.delay = 0;
-    in.weighting_factor = 0;
+    _delays[index] = 0;
+    _weights[index] = 0;
   }
+}
 
-  assert(in.weighting_factor.exactly_one_assignment());
-  assert(in.delay.exactly_one_assignment());
+void WfsRenderer::SourceChannel::update()
+{
+  _begin = this->source.delayline.get_read_circulator(this->delay);
+  _end = _begin + source.parent.block_size();
+}
+
+apf::CombineChannelsResult::type
+WfsRenderer::RenderFunction::select(SourceChannel& in)
+{
+  _in = &in;
 
   _old_factor = in.weighting_factor.old();
   _new_factor = in.weighting_factor;